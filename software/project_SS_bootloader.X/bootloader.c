@@ -0,0 +1,208 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "system.h"
+#include "usb.h"
+#include "boot_protocol.h"
+#include "bootloader.h"
+
+#define DETACH_MS       100     // long enough for the host to see an unplug
+
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ      48000000UL
+#endif
+
+static uint8_t outPacket[BOOT_PACKET_SIZE] BOOT_OUT_DATA_BUFFER_ADDRESS;
+static uint8_t inPacket[BOOT_PACKET_SIZE] BOOT_IN_DATA_BUFFER_ADDRESS;
+static USB_HANDLE outHandle;
+static USB_HANDLE inHandle;
+static bool resetPending;
+
+static flash_data_t row[BOOT_ROW_WORDS];
+
+/* 4 words in 7 bytes, the first word in the low bits */
+static void unpackRow(const uint8_t *p)
+{
+    flash_data_t *w = row;
+    uint8_t i;
+
+    for (i = 0; i < BOOT_ROW_WORDS / 4; i++) {
+        w[0] = p[0] | ((flash_data_t)(p[1] & 0x3F) << 8);
+        w[1] = (p[1] >> 6) | ((flash_data_t)p[2] << 2) | ((flash_data_t)(p[3] & 0x0F) << 10);
+        w[2] = (p[3] >> 4) | ((flash_data_t)p[4] << 4) | ((flash_data_t)(p[5] & 0x03) << 12);
+        w[3] = (p[5] >> 2) | ((flash_data_t)p[6] << 6);
+        w += 4;
+        p += 7;
+    }
+}
+
+static bool inApplication(uint16_t address, uint16_t words)
+{
+    return address >= BOOT_APP_START && address <= BOOT_APP_END
+        && words <= BOOT_APP_END - address;
+}
+
+static uint8_t writeRow(uint16_t address, const uint8_t *data)
+{
+    uint8_t i;
+
+    if ((address & (BOOT_ROW_WORDS - 1)) != 0 || !inApplication(address, BOOT_ROW_WORDS)) {
+        return BOOT_STATUS_RANGE;
+    }
+    unpackRow(data);
+
+    NVM_UnlockKeySet(UNLOCK_KEY);
+    FLASH_PageErase(address);
+    while (NVM_IsBusy());
+    FLASH_RowWrite(address, row);
+    while (NVM_IsBusy());
+    NVM_UnlockKeyClear();
+
+    for (i = 0; i < BOOT_ROW_WORDS; i++) {
+        if (FLASH_Read(address + i) != row[i]) {
+            return BOOT_STATUS_VERIFY;
+        }
+    }
+    return BOOT_STATUS_OK;
+}
+
+/* CRC-16/CCITT-FALSE one byte at a time, without a table or a bit loop */
+static uint16_t crcByte(uint16_t crc, uint8_t b)
+{
+    uint8_t x = (uint8_t)(crc >> 8) ^ b;
+
+    x ^= x >> 4;
+    return (uint16_t)((crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x);
+}
+
+/* each word as 2 bytes little-endian */
+static uint16_t crcFlash(uint16_t address, uint16_t words)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (words-- > 0) {
+        flash_data_t w = FLASH_Read(address++);
+
+        crc = crcByte(crc, (uint8_t)w);
+        crc = crcByte(crc, (uint8_t)(w >> 8));
+    }
+    return crc;
+}
+
+static uint8_t crcWords(uint16_t address, uint16_t words, uint8_t *data)
+{
+    uint16_t crc;
+
+    if (!inApplication(address, words)) {
+        return BOOT_STATUS_RANGE;
+    }
+    crc = crcFlash(address, words);
+    data[0] = (uint8_t)crc;
+    data[1] = (uint8_t)(crc >> 8);
+    return BOOT_STATUS_OK;
+}
+
+/* one CRC per row, so the host can send only the rows that differ */
+static uint8_t crcRows(uint16_t address, uint16_t rows, uint8_t *data)
+{
+    if ((address & (BOOT_ROW_WORDS - 1)) != 0 || rows > BOOT_ROW_CRCS
+        || !inApplication(address, rows * BOOT_ROW_WORDS)) {
+        return BOOT_STATUS_RANGE;
+    }
+    while (rows-- > 0) {
+        uint16_t crc = crcFlash(address, BOOT_ROW_WORDS);
+
+        *data++ = (uint8_t)crc;
+        *data++ = (uint8_t)(crc >> 8);
+        address += BOOT_ROW_WORDS;
+    }
+    return BOOT_STATUS_OK;
+}
+
+uint8_t Boot_Command(const uint8_t *command, uint8_t *answer)
+{
+    uint16_t address = command[2] | ((uint16_t)command[3] << 8);
+    uint16_t words = command[4] | ((uint16_t)command[5] << 8);
+    uint8_t *data = &answer[BOOT_DATA_OFFSET];
+    uint8_t status;
+
+    memset(answer, 0, BOOT_PACKET_SIZE);
+    memcpy(answer, command, BOOT_DATA_OFFSET);
+
+    switch (command[0]) {
+        case BOOT_CMD_QUERY:
+            data[0] = BOOT_PROTOCOL_VER;
+            data[1] = BOOT_ROW_WORDS;
+            data[2] = (uint8_t)BOOT_APP_START;
+            data[3] = (uint8_t)(BOOT_APP_START >> 8);
+            data[4] = (uint8_t)BOOT_APP_END;
+            data[5] = (uint8_t)(BOOT_APP_END >> 8);
+            data[6] = (uint8_t)BOOT_VERSION;
+            data[7] = (uint8_t)(BOOT_VERSION >> 8);
+            status = BOOT_STATUS_OK;
+            break;
+        case BOOT_CMD_WRITE_ROW:
+            status = writeRow(address, &command[BOOT_DATA_OFFSET]);
+            break;
+        case BOOT_CMD_CRC:
+            status = crcWords(address, words, data);
+            break;
+        case BOOT_CMD_ROW_CRCS:
+            status = crcRows(address, words, data);
+            break;
+        case BOOT_CMD_RESET:
+            resetPending = true;
+            status = BOOT_STATUS_OK;
+            break;
+        default:
+            status = BOOT_STATUS_COMMAND;
+            break;
+    }
+    answer[1] = status;
+    return status;
+}
+
+void Boot_Initialize(void)
+{
+    USBEnableEndpoint(BOOT_EP, USB_IN_ENABLED|USB_OUT_ENABLED|USB_HANDSHAKE_ENABLED|USB_DISALLOW_SETUP);
+    inHandle = NULL;
+    outHandle = USBRxOnePacket(BOOT_EP, outPacket, BOOT_PACKET_SIZE);
+}
+
+void Boot_Tasks(void)
+{
+    if (USBGetDeviceState() < CONFIGURED_STATE || USBIsDeviceSuspended()) {
+        return;
+    }
+    if (USBHandleBusy(inHandle)) {
+        return;
+    }
+    if (resetPending) {
+        // the answer has gone out; let the host see us leave
+        USBModuleDisable();
+        __delay_ms(DETACH_MS);
+        RESET();
+    }
+    if (USBHandleBusy(outHandle)) {
+        return;
+    }
+    Boot_Command(outPacket, inPacket);
+    inHandle = USBTxOnePacket(BOOT_EP, inPacket, BOOT_PACKET_SIZE);
+    outHandle = USBRxOnePacket(BOOT_EP, outPacket, BOOT_PACKET_SIZE);
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   bootloader.h
+ * The command loop on EP1: one OUT packet in, one IN packet out, as laid
+ * out in boot_protocol.h.
+ */
+
+#ifndef BOOTLOADER_H
+#define BOOTLOADER_H
+
+#include <stdint.h>
+
+#define BOOT_VERSION    0x0101  // reported by BOOT_CMD_QUERY, major.minor
+
+/**
+ * Enable EP1 and wait for the first command; call on EVENT_CONFIGURED.
+ */
+void Boot_Initialize(void);
+
+/**
+ * Run a received command and send its answer. After answering
+ * BOOT_CMD_RESET it detaches and resets into the application.
+ */
+void Boot_Tasks(void);
+
+/**
+ * Run one command packet and fill in the answer packet.
+ * @return the status also put in byte 1 of the answer
+ */
+uint8_t Boot_Command(const uint8_t *command, uint8_t *answer);
+
+#endif /* BOOTLOADER_H */
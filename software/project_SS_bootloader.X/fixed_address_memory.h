@@ -0,0 +1,31 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#ifndef FIXED_MEMORY_ADDRESS_H
+#define FIXED_MEMORY_ADDRESS_H
+
+#define FIXED_ADDRESS_MEMORY
+
+// EP1 packet buffers in USB dual-port RAM, where the application keeps its own
+#if(__XC8_VERSION < 2000)
+    #define BOOT_OUT_DATA_BUFFER_ADDRESS @0x2050
+    #define BOOT_IN_DATA_BUFFER_ADDRESS @0x20A0
+#else
+    #define BOOT_OUT_DATA_BUFFER_ADDRESS __at(0x2050)
+    #define BOOT_IN_DATA_BUFFER_ADDRESS __at(0x20A0)
+#endif
+
+#endif //FIXED_MEMORY_ADDRESS
@@ -0,0 +1,124 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   main.c
+ * USB HID bootloader for project_SS_gamepad.X, in the flash below the
+ * application's 0xC04 code offset. It starts the application unless
+ * asked to stay (boot_protocol.h) and then only answers EP1 commands.
+ */
+
+/** INCLUDES *******************************************************/
+#include "system.h"
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "boot_protocol.h"
+#include "bootloader.h"
+
+/* left by the application before its RESET; absolute, so startup leaves it alone */
+#if(__XC8_VERSION < 2000)
+    volatile uint16_t bootRequest @BOOT_REQUEST_ADDRESS;
+#else
+    volatile uint16_t bootRequest __at(BOOT_REQUEST_ADDRESS);
+#endif
+
+extern const struct{uint8_t report[BOOT_RPT_DESC_SIZE];}boot_rpt;
+
+static bool stayInBootloader(void)
+{
+    if (bootRequest == BOOT_REQUEST_KEY) {
+        bootRequest = 0;
+        return true;
+    }
+
+    /* START+L+R, with the application's pull-ups; the flash read below
+     * gives them a few instruction cycles at the 500 kHz reset clock */
+    OPTION_REGbits.nWPUEN = 0;
+    WPUA = 0x30;
+    WPUB = 0x70;
+    ANSELA = 0x00;
+    ANSELB = 0x00;
+    ANSELC = 0x00;
+
+    if (FLASH_Read(BOOT_APP_RESET) == 0x3FFF) {
+        return true;            // nothing there, or an update stopped half way
+    }
+    return !PORTBbits.RB7 && !PORTCbits.RC1 && !PORTAbits.RA4;
+}
+
+MAIN_RETURN main(void)
+{
+    if (!stayInBootloader()) {
+        SYSTEM_StartApplication();
+    }
+
+    SYSTEM_Initialize();
+
+    USBDeviceInit();
+    USBDeviceAttach();
+
+    while(1)
+    {
+        USBDeviceTasks();
+        Boot_Tasks();
+    }
+}
+
+static void HIDRequest(void)
+{
+    if (SetupPkt.Recipient != USB_SETUP_RECIPIENT_INTERFACE_BITFIELD) return;
+    if (SetupPkt.bIntfID != BOOT_INTF_ID) return;
+
+    if (SetupPkt.bRequest == USB_REQUEST_GET_DESCRIPTOR) {
+        switch (SetupPkt.bDescriptorType) {
+            case DSC_HID:
+                USBEP0SendROMPtr(
+                    (const uint8_t*)&configDescriptor1 + 18,   // after the configuration and interface descriptors
+                    sizeof(USB_HID_DSC)+3,
+                    USB_EP0_INCLUDE_ZERO);
+                break;
+            case DSC_RPT:
+                USBEP0SendROMPtr(
+                    (const uint8_t*)&boot_rpt,
+                    BOOT_RPT_DESC_SIZE,
+                    USB_EP0_INCLUDE_ZERO);
+                break;
+        }
+        return;
+    }
+    // the host's HID driver sends this on attach; everything else stalls
+    if (SetupPkt.RequestType == USB_SETUP_TYPE_CLASS_BITFIELD && SetupPkt.bRequest == SET_IDLE) {
+        USBEP0Transmit(USB_EP0_NO_DATA);
+    }
+}
+
+bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size)
+{
+    switch((int)event)
+    {
+        case EVENT_CONFIGURED:
+            Boot_Initialize();
+            break;
+
+        case EVENT_EP0_REQUEST:
+            HIDRequest();
+            break;
+
+        default:
+            break;
+    }
+    return true;
+}
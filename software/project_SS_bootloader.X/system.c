@@ -0,0 +1,73 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include "system.h"
+#include "boot_protocol.h"
+
+/** CONFIGURATION Bits **********************************************/
+// PIC16F1459 configuration bit settings, the same as project_SS_gamepad.X:
+// CONFIG1
+#pragma config FOSC = INTOSC    // Oscillator Selection Bits (INTOSC oscillator: I/O function on CLKIN pin)
+#pragma config WDTE = OFF       // Watchdog Timer Enable (WDT disabled)
+#pragma config PWRTE = OFF      // Power-up Timer Enable (PWRT disabled)
+#pragma config MCLRE = OFF      // MCLR Pin Function Select (MCLR/VPP pin function is digital input)
+#pragma config CP = OFF         // Flash Program Memory Code Protection (Program memory code protection is disabled)
+#pragma config BOREN = ON       // Brown-out Reset Enable (Brown-out Reset enabled)
+#pragma config CLKOUTEN = OFF   // Clock Out Enable (CLKOUT function is disabled. I/O or oscillator function on the CLKOUT pin)
+#pragma config IESO = OFF       // Internal/External Switchover Mode (Internal/External Switchover Mode is disabled)
+#pragma config FCMEN = OFF      // Fail-Safe Clock Monitor Enable (Fail-Safe Clock Monitor is disabled)
+
+// CONFIG2
+#pragma config WRT = OFF        // Flash Memory Self-Write Protection (Write protection off)
+#pragma config CPUDIV = NOCLKDIV// CPU System Clock Selection Bit (NO CPU system divide)
+#pragma config USBLSCLK = 48MHz // USB Low SPeed Clock Selection bit (System clock expects 48 MHz, FS/LS USB CLKENs divide-by is set to 8.)
+#pragma config PLLMULT = 3x     // PLL Multipler Selection Bit (3x Output Frequency Selected)
+#pragma config PLLEN = ENABLED  // PLL Enable Bit (3x or 4x PLL Enabled)
+#pragma config STVREN = ON      // Stack Overflow/Underflow Reset Enable (Stack Overflow or Underflow will cause a Reset)
+#pragma config BORV = LO        // Brown-out Reset Voltage Selection (Brown-out Reset Voltage (Vbor), low trip point selected.)
+#pragma config LPBOR = OFF      // Low-Power Brown Out Reset (Low-Power BOR is disabled)
+#pragma config LVP = OFF        // Low-Voltage Programming Enable (High-voltage on MCLR/VPP must be used for programming)
+
+void SYSTEM_Initialize(void)
+{
+    NVM_Initialize();
+
+    OSCCON = 0xFC;  //HFINTOSC @ 16MHz, 3X PLL, PLL enabled
+    ACTCON = 0x90;  //Active clock tuning enabled for USB
+}
+
+void SYSTEM_StartApplication(void)
+{
+    asm("pagesel " ___mkstr(BOOT_APP_RESET));
+    asm("goto " ___mkstr(BOOT_APP_RESET));
+}
+
+/*
+ * The bootloader itself polls and never enables interrupts, so anything
+ * arriving here belongs to the application: forward it to its vector.
+ * The enhanced mid-range core has already saved the context.
+ */
+#if(__XC8_VERSION < 2000)
+    #define INTERRUPT interrupt
+#else
+    #define INTERRUPT __interrupt()
+#endif
+
+void INTERRUPT SYS_InterruptForward(void)
+{
+    asm("pagesel " ___mkstr(BOOT_APP_INTERRUPT));
+    asm("goto " ___mkstr(BOOT_APP_INTERRUPT));
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   system.h
+ * The bootloader runs on the same clock and configuration words as the
+ * application; both are programmed together, and the application only
+ * ever sees what is set here.
+ */
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+#include <xc.h>
+#include <stdbool.h>
+
+#include "mcc_generated_files/nvm/nvm.h"
+#include "fixed_address_memory.h"
+
+#define USE_INTERNAL_OSC        // HFINTOSC with active clock tuning, as the application
+
+#define MAIN_RETURN void
+
+/**
+ * Clock and NVM setup before USBDeviceInit().
+ */
+void SYSTEM_Initialize(void);
+
+/**
+ * Jump to the application's reset vector; does not return.
+ */
+void SYSTEM_StartApplication(void);
+
+#endif /* SYSTEM_H */
@@ -0,0 +1,149 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   usb_descriptors.c
+ * One vendor HID interface with a 64-byte Input and Output report on EP1,
+ * the same VID/PID as the application. The host tells the two apart by
+ * the missing interface 1 (see tools/padflash).
+ */
+
+/** INCLUDES *******************************************************/
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "my_usb_pid.h"
+#include "boot_protocol.h"
+
+/** CONSTANTS ******************************************************/
+
+/* Device Descriptor */
+const USB_DEVICE_DESCRIPTOR device_dsc=
+{
+    0x12,    // Size of this descriptor in bytes
+    USB_DESCRIPTOR_DEVICE,                // DEVICE descriptor type
+    0x0200,                 // USB Spec Release Number in BCD format
+    0x00,                   // Class Code
+    0x00,                   // Subclass code
+    0x00,                   // Protocol code
+    USB_EP0_BUFF_SIZE,      // Max packet size for EP0, see usb_config.h
+    0x04D8,                 // Vendor ID
+    MY_USB_PID,             // Product ID
+    0x0001,                 // Device release number in BCD format
+    0x01,                   // Manufacturer string index
+    0x02,                   // Product string index
+    0x00,                   // Device serial number string index
+    0x01                    // Number of possible configurations
+};
+
+/* Configuration 1 Descriptor */
+const uint8_t configDescriptor1[]={
+    /* Configuration Descriptor */
+    0x09,//sizeof(USB_CFG_DSC),    // Size of this descriptor in bytes
+    USB_DESCRIPTOR_CONFIGURATION,                // CONFIGURATION descriptor type
+    DESC_CONFIG_WORD(0x0029),                   // Total length of data for this cfg
+    1,                      // Number of interfaces in this cfg
+    1,                      // Index value of this configuration
+    0,                      // Configuration string index
+    _DEFAULT | _SELF,       // Attributes, see usb_device.h
+    50,                     // Max power consumption (2X mA)
+
+    /* Interface Descriptor (Interface 0: Bootloader) */
+    0x09,//sizeof(USB_INTF_DSC),   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE,               // INTERFACE descriptor type
+    BOOT_INTF_ID,           // Interface Number
+    0,                      // Alternate Setting Number
+    2,                      // Number of endpoints in this intf
+    HID_INTF,               // Class code
+    0xFF,                   // Subclass code - Vendor defined
+    0xFF,                   // Protocol code - Vendor defined
+    0,                      // Interface string index
+
+    /* HID Class-Specific Descriptor */
+    0x09,//sizeof(USB_HID_DSC)+3,    // Size of this descriptor in bytes
+    DSC_HID,                // HID descriptor type
+    DESC_CONFIG_WORD(0x0111),                 // HID Spec Release Number in BCD format (1.11)
+    0x00,                   // Country Code (0x00 for Not supported)
+    1,                      // Number of class descriptors
+    DSC_RPT,                // Report descriptor type
+    DESC_CONFIG_WORD(BOOT_RPT_DESC_SIZE),   // Size of the report descriptor
+
+    /* Endpoint Descriptor (answers) */
+    0x07,/*sizeof(USB_EP_DSC)*/
+    USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
+    BOOT_EP | _EP_IN,           //EndpointAddress
+    _INTERRUPT,                       //Attributes
+    DESC_CONFIG_WORD(BOOT_PACKET_SIZE),  //size
+    0x01,                        //Interval
+
+    /* Endpoint Descriptor (commands) */
+    0x07,/*sizeof(USB_EP_DSC)*/
+    USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
+    BOOT_EP | _EP_OUT,          //EndpointAddress
+    _INTERRUPT,                       //Attributes
+    DESC_CONFIG_WORD(BOOT_PACKET_SIZE),  //size
+    0x01,                        //Interval
+};
+
+
+//Language code string descriptor
+const struct{uint8_t bLength;uint8_t bDscType;uint16_t string[1];}sd000={
+sizeof(sd000),USB_DESCRIPTOR_STRING,{0x0409
+}};
+
+//Manufacturer string descriptor
+const struct{uint8_t bLength;uint8_t bDscType;uint16_t string[25];}sd001={
+sizeof(sd001),USB_DESCRIPTOR_STRING,
+{'M','i','c','r','o','c','h','i','p',' ',
+'T','e','c','h','n','o','l','o','g','y',' ','I','n','c','.'
+}};
+
+//Product string descriptor
+const struct{uint8_t bLength;uint8_t bDscType;uint16_t string[21];}sd002={
+sizeof(sd002),USB_DESCRIPTOR_STRING,
+{'S','S',' ','G','a','m','e','p','a','d',' ',
+'B','o','o','t','l','o','a','d','e','r'
+}};
+
+//Array of configuration descriptors
+const uint8_t *const USB_CD_Ptr[]=
+{
+    (const uint8_t *const)&configDescriptor1
+};
+
+//Array of string descriptors
+const uint8_t *const USB_SD_Ptr[]=
+{
+    (const uint8_t *const)&sd000,
+    (const uint8_t *const)&sd001,
+    (const uint8_t *const)&sd002
+};
+
+const struct{uint8_t report[BOOT_RPT_DESC_SIZE];}boot_rpt={{
+  0x06,0x00,0xFF,   //USAGE_PAGE (Vendor Defined Page 1)
+  0x09,0x01,        //USAGE (Vendor Usage 1)
+  0xA1,0x01,        //COLLECTION (Application)
+  0x15,0x00,        //  LOGICAL_MINIMUM(0)
+  0x26,0xFF,0x00,   //  LOGICAL_MAXIMUM(255)
+  0x75,0x08,        //  REPORT_SIZE(8)
+  0x95,0x40,        //  REPORT_COUNT(64) answers
+  0x09,0x01,        //  USAGE (Vendor Usage 1)
+  0x81,0x02,        //  INPUT(Data,Var,Abs)
+  0x95,0x40,        //  REPORT_COUNT(64) commands
+  0x09,0x01,        //  USAGE (Vendor Usage 1)
+  0x91,0x02,        //  OUTPUT(Data,Var,Abs)
+  0xC0              //END_COLLECTION
+}};
+/** EOF usb_descriptors.c ***************************************************/
@@ -0,0 +1,88 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   boot_protocol.h
+ * What the USB bootloader (project_SS_bootloader.X), this application
+ * and the host uploader (tools/padflash) agree on.
+ *
+ * Flash: the bootloader owns 0x000-0xBFF. The application is linked at
+ * 0xC04 (reset) / 0xC08 (interrupt) and ends below the High-Endurance
+ * Flash rows that keep the button mapping, which the bootloader never
+ * touches. Row 0xC00 holds the application's vectors; the uploader
+ * erases it first and writes it last, so a pad whose update stopped
+ * half way stays in the bootloader.
+ *
+ * Entry: the bootloader stays when the application's reset vector is
+ * blank, when START+L+R are held at power-up, or when the application
+ * has left BOOT_REQUEST_KEY at BOOT_REQUEST_ADDRESS before a RESET
+ * instruction. The application does that on a SET_REPORT of Feature
+ * report BOOT_REPORT_ID on interface 1 carrying BOOT_REPORT_KEY.
+ *
+ * Transfers: one HID interface with 64-byte Output and Input reports
+ * without report IDs on EP1. Each OUT packet is a command and is
+ * answered by one IN packet:
+ *
+ *   0      command (BOOT_CMD_*); echoed in the answer
+ *   1      answer: status (BOOT_STATUS_*)
+ *   2-3    word address
+ *   4-5    word count (BOOT_CMD_CRC) or row count (BOOT_CMD_ROW_CRCS)
+ *   8-63   data
+ *
+ * BOOT_CMD_WRITE_ROW carries a whole row, 32 14-bit words packed
+ * little-endian into 56 bytes (4 words in 7 bytes); the bootloader
+ * erases the row, writes it and reads it back. BOOT_CMD_CRC answers
+ * with the CRC-16/CCITT-FALSE of the words, each taken as 2 bytes
+ * little-endian, in data bytes 0-1. BOOT_CMD_ROW_CRCS (protocol 2) answers
+ * the same CRC for each of up to BOOT_ROW_CRCS rows, 2 bytes per row, so
+ * an uploader can leave out the rows that already hold the new image.
+ */
+
+#ifndef BOOT_PROTOCOL_H
+#define BOOT_PROTOCOL_H
+
+#define BOOT_PROTOCOL_VER       2
+
+#define BOOT_APP_START          0x0C00  // first row after the bootloader
+#define BOOT_APP_RESET          0x0C04  // the application's code offset
+#define BOOT_APP_INTERRUPT      0x0C08
+#define BOOT_APP_END            0x1F80  // High-Endurance Flash from here on
+#define BOOT_ROW_WORDS          32
+
+#define BOOT_REQUEST_ADDRESS    0x16E   // last 2 bytes of bank 2, not cleared at startup
+#define BOOT_REQUEST_KEY        0xB007
+
+#define BOOT_REPORT_ID          0x05    // Feature report on interface 1
+#define BOOT_REPORT_SIZE        5       // including the report ID
+#define BOOT_REPORT_KEY         "BOOT"  // bytes 1-4
+
+#define BOOT_PACKET_SIZE        64
+#define BOOT_DATA_OFFSET        8
+#define BOOT_ROW_BYTES          56      // BOOT_ROW_WORDS x 14 bits
+#define BOOT_ROW_CRCS           28      // rows per BOOT_CMD_ROW_CRCS answer
+
+#define BOOT_CMD_QUERY          0x01    // data: protocol, row words, app start/end, version
+#define BOOT_CMD_WRITE_ROW      0x02
+#define BOOT_CMD_CRC            0x03
+#define BOOT_CMD_RESET          0x04    // answer, detach and start the application
+#define BOOT_CMD_ROW_CRCS       0x05    // since protocol 2
+
+#define BOOT_STATUS_OK          0x00
+#define BOOT_STATUS_RANGE       0x01    // address outside the application
+#define BOOT_STATUS_VERIFY      0x02    // read back differs from the row
+#define BOOT_STATUS_COMMAND     0x03    // unknown command
+
+#endif /* BOOT_PROTOCOL_H */
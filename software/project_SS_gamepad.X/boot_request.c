@@ -0,0 +1,69 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "usb.h"
+#include "boot_request.h"
+#include "telemetry.h"
+#include "mapping.h"
+#include "ram_map.h"
+
+#define BOOT_DELAY_FRAMES   8       // for the status stage of the SET_REPORT
+#define DETACH_MS           100     // long enough for the host to see an unplug
+
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ          48000000UL
+#endif
+
+/* read by the bootloader after the RESET; absolute, so startup leaves it alone */
+#if(__XC8_VERSION < 2000)
+    volatile uint16_t bootRequest @BOOT_REQUEST_ADDRESS;
+#else
+    volatile uint16_t bootRequest __at(BOOT_REQUEST_ADDRESS);
+#endif
+
+static bool armed;
+static uint32_t armedAt;
+
+static void USBCB_BootRequestComplete(void)
+{
+    if (memcmp(&configArena.feature[1], BOOT_REPORT_KEY, BOOT_REPORT_SIZE - 1) == 0) {
+        armed = true;
+        armedAt = telemetry.sofs;
+    }
+}
+
+void BootRequest_Receive(void)
+{
+    USBEP0Receive(configArena.feature, BOOT_REPORT_SIZE, USBCB_BootRequestComplete);
+}
+
+void BootRequest_Tasks(void)
+{
+    if (!armed || telemetry.sofs - armedAt < BOOT_DELAY_FRAMES) {
+        return;
+    }
+    if (Mapping_CommitPending()) {
+        return;                     // a saved mapping reaches the flash first
+    }
+    INTCONbits.GIE = 0;
+    USBModuleDisable();
+    __delay_ms(DETACH_MS);
+    bootRequest = BOOT_REQUEST_KEY;
+    RESET();
+}
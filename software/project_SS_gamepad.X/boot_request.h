@@ -0,0 +1,41 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   boot_request.h
+ * Restart into the USB bootloader on request from the host: a SET_REPORT
+ * of Feature report BOOT_REPORT_ID (boot_protocol.h) on interface 1.
+ * The restart waits a few frames so the status stage of that request
+ * reaches the host, and for a mapping still on its way to the flash
+ * (Mapping_CommitPending()), then detaches from the bus and resets.
+ */
+
+#ifndef BOOT_REQUEST_H
+#define BOOT_REQUEST_H
+
+#include "boot_protocol.h"
+
+/**
+ * Take the data stage of the SET_REPORT; from HIDFeatureReceive()
+ */
+void BootRequest_Receive(void);
+
+/**
+ * Restart once a request has been taken; call from the main loop
+ */
+void BootRequest_Tasks(void);
+
+#endif /* BOOT_REQUEST_H */
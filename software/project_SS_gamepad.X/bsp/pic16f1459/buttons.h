@@ -25,7 +25,8 @@
  * 
  * Changes from the original source:
  *     - Button Definitions
- *     - bool BUTTON_IsPressed(BUTTON button)
+ *     - bool BUTTON_IsPressed(BUTTON button), now a macro; buttons.c
+ *       is gone
  ********************************************************************/
 
 #include <stdbool.h>
@@ -36,6 +37,10 @@
 /*** Button Definitions *********************************************/
 typedef bool BUTTON ;
 
+/* the inputs are pulled up: a pressed button reads 0 */
+#define BUTTON_PRESSED      0
+#define BUTTON_NOT_PRESSED  1
+
 /*********************************************************************
 * Function: bool BUTTON_IsPressed(BUTTON button);
 *
@@ -51,8 +56,12 @@ typedef bool BUTTON ;
 *
 * Output: TRUE if pressed; FALSE if not pressed.
 *
+* Note: a macro on the port bit io_mapping.h names, such as
+*       PORTCbits.RC7, so each test is one BTFSC/BTFSS on the port
+*       with no call and no level of the hardware stack.
+*
 ********************************************************************/
-bool BUTTON_IsPressed(BUTTON button);
+#define BUTTON_IsPressed(button)    ((button) == BUTTON_PRESSED)
 
 
 #endif //BUTTONS_H
@@ -0,0 +1,104 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+
+#include "telemetry.h"
+#include "cadence.h"
+
+#define FRAME_TICKS     1500        // Timer1 ticks in a 1 ms frame
+#define FRAME_MASK      0x07FF      // UFRM counts 11 bits
+
+uint8_t cadenceHold;
+
+static uint8_t cadence;             // frames, below 2 for none
+static uint8_t candidate, agree;
+static uint8_t sinceProbe;
+static bool haveLast;
+static uint16_t lastFrame;
+static uint16_t buildAt;            // Timer1
+
+static void setCadence(uint8_t frames)
+{
+    if (frames != cadence) {
+        cadence = frames;
+        telemetry.pollInterval = frames;
+        telemetry.pollChanges++;
+    }
+}
+
+void Cadence_Reset(void)
+{
+    cadence = 0;
+    telemetry.pollInterval = 0;
+    candidate = 0;
+    agree = 0;
+    sinceProbe = 0;
+    haveLast = false;
+    cadenceHold = 0;
+}
+
+void Cadence_TransferComplete(void)
+{
+    uint16_t frame, now;
+    uint8_t interval;
+
+    TELEMETRY_ReadTimer1(now);
+    frame = ((uint16_t)UFRMH << 8 | UFRML) & FRAME_MASK;
+
+    if (haveLast) {
+        interval = (uint8_t)((frame - lastFrame) & FRAME_MASK);
+        if (interval == 0 || interval > CADENCE_MAX) {
+            agree = 0;                  // a stall, or no SOF counted
+        } else {
+            if (!cadenceHold && interval < cadence) {
+                setCadence(0);          // a report built at once went sooner
+            } else if (cadenceHold && interval > cadence) {
+                telemetry.pollMissed++; // built too late for its poll
+            }
+            if (interval == candidate) {
+                if (agree < CADENCE_CONFIRM && ++agree == CADENCE_CONFIRM) {
+                    setCadence(interval);
+                }
+            } else {
+                candidate = interval;
+                agree = 1;
+            }
+        }
+    }
+    lastFrame = frame;
+    haveLast = true;
+
+    if (++sinceProbe >= CADENCE_PROBE) {
+        sinceProbe = 0;
+        cadenceHold = 0;
+    } else {
+        cadenceHold = (cadence >= 2);
+    }
+    buildAt = now + (uint16_t)cadence * FRAME_TICKS - CADENCE_LEAD;
+}
+
+bool Cadence_Due(void)
+{
+    uint16_t now;
+
+    TELEMETRY_ReadTimer1(now);
+    if ((int16_t)(now - buildAt) < 0) {
+        return false;
+    }
+    cadenceHold = 0;
+    return true;
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   cadence.h
+ * How often the host really polls EP1, and a report built for the poll
+ * instead of for the end of the last one.
+ *
+ * The joystick endpoint asks for bInterval 1, but some hosts poll it
+ * every 2, 4 or 8 frames. At the end of each EP1 IN transfer the frame
+ * number (UFRM, one count per SOF) is taken; the frames since the end
+ * of the one before are the poll interval. CADENCE_CONFIRM equal
+ * intervals in a row make it the host's cadence.
+ *
+ * With a cadence of 2 frames or more, APP_DeviceJoystickTasks() holds
+ * the next report back until CADENCE_LEAD before the poll due a cadence
+ * after the last one (in Timer1 ticks from the end of that transfer),
+ * so the sample the host gets is that much old instead of up to a
+ * cadence. Every CADENCE_PROBE-th report is still built at once: if
+ * the host comes for it sooner than a cadence, it has sped up, and
+ * reports are built at once again until a new cadence is confirmed.
+ *
+ * The cadence, its changes and the polls a held report missed are in
+ * the telemetry (telemetry.h).
+ */
+
+#ifndef CADENCE_H
+#define CADENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CADENCE_CONFIRM     8       // equal intervals before they count
+#define CADENCE_MAX         16      // frames; a longer interval is a stall
+#define CADENCE_PROBE       32      // reports from one built at once to the next
+#define CADENCE_LEAD        750     // Timer1 ticks, 500us: sample, queue, a long pass
+
+/* the report on its way is held for the poll */
+extern uint8_t cadenceHold;
+
+/**
+ * Whether the next report may be built now
+ */
+#define CADENCE_Due()   (!cadenceHold || Cadence_Due())
+
+/**
+ * Forget the cadence; at SET_CONFIGURATION and at a suspend
+ */
+void Cadence_Reset(void);
+
+/**
+ * Take the interval and plan the next report; at the TRNIF of an EP1
+ * IN transfer
+ */
+void Cadence_TransferComplete(void);
+
+/**
+ * Whether the time to build the held report has come; see CADENCE_Due()
+ */
+bool Cadence_Due(void);
+
+#endif /* CADENCE_H */
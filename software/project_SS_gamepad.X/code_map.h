@@ -0,0 +1,52 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   code_map.h
+ * Where the code goes. Program memory is 8K words in four 2K-word
+ * pages; a CALL or GOTO to another page first sets PCLATH with MOVLP.
+ *
+ *   0x0000-0x0C03  bootloader (project_SS_bootloader.X)
+ *   0x0C04-0x1F7F  this firmware (code offset 0xC04)
+ *   0x1F80-0x1FFF  High-Endurance Flash, the mapping rows (mapping.c)
+ *
+ * Hot: the functions every main-loop pass or every report runs are put
+ * in the HOT_PATH psect, so the calls between them stay in one page:
+ *
+ *   main -> Scheduler_Tasks -> USBDeviceTasks, APP_DeviceJoystickTasks
+ *        -> App_DeviceGamepadAct, HIDTxPacket (USBTransferOnePacket)
+ *
+ * The buttons are read in line (BUTTON_IsPressed() in buttons.h).
+ *
+ * The linker can't split a psect over a page, as each page is its own
+ * range of the CODE class, so the whole set lands in whichever page has
+ * room for it. What they call on events or every few ms only (the
+ * control transfer handlers, the Feature reports, the mode chords, the
+ * flash commit) is left to the linker. `picsim --pages` lists the calls
+ * that still change page; the "paging" figures of its JSON count the
+ * ones a run makes.
+ */
+
+#ifndef CODE_MAP_H
+#define CODE_MAP_H
+
+#if defined(__XC8) && (__XC8_VERSION >= 2000)
+    #define HOT_PATH    __section("hotpath")
+#else
+    #define HOT_PATH
+#endif
+
+#endif /* CODE_MAP_H */
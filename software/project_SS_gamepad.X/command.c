@@ -0,0 +1,170 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "command.h"
+#include "ext_report.h"
+#include "mapping.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "my_app_device_gamepad.h"
+#include "scheduler.h"
+#include "history.h"
+#include "inject.h"
+#include "keyboard.h"
+
+/* the command comes in and its answer goes out in the same buffer */
+#if defined(FIXED_ADDRESS_MEMORY) && defined(__XC8)
+    static uint8_t cmdBuf[CMD_REPORT_SIZE] CMD_DATA_BUFFER_ADDRESS;
+#else
+    static uint8_t cmdBuf[CMD_REPORT_SIZE];
+#endif
+
+static USB_VOLATILE USB_HANDLE cmdReceive;
+uint8_t commandAnswer;
+
+/* data: CMD_REPORT_SIZE - CMD_DATA_OFFSET bytes, the command's in and the answer's out */
+static uint8_t handle(uint8_t *data)
+{
+    uint16_t from;
+    uint8_t i;
+
+    switch (cmdBuf[1]) {
+        case CMD_INFO:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            data[0] = CMD_PROTOCOL_VER;
+            data[1] = NUM_BUTTONS;
+            return CMD_STATUS_OK;
+
+        case CMD_SET_MAPPING:
+            for (i = 0; i < 2 * NUM_BUTTONS; i++) {
+                if (data[i] > 14) {
+                    return CMD_STATUS_RANGE;
+                }
+            }
+            // answer with the mapping as saved
+            Mapping_Save(&data[0], &data[NUM_BUTTONS], NULL);
+            // fall through
+        case CMD_GET_MAPPING:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            for (i = 0; i < NUM_BUTTONS; i++) {
+                data[i] = Mapping_GetUsage(i, 0);
+                data[NUM_BUTTONS + i] = Mapping_GetUsage(i, 1);
+            }
+            return CMD_STATUS_OK;
+
+        case CMD_SET_PROFILE:
+            if (!App_DeviceGamepadSetModes(data[0], data[1])) {
+                return CMD_STATUS_RANGE;
+            }
+            // fall through
+        case CMD_GET_PROFILE:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            App_DeviceGamepadGetModes(&data[0], &data[1]);
+            return CMD_STATUS_OK;
+
+        case CMD_GET_TELEMETRY:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            Telemetry_GetAsFeatureReport(data);
+            return CMD_STATUS_OK;
+
+        case CMD_GET_LATENCY:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            Latency_GetAsFeatureReport(data);
+            return CMD_STATUS_OK;
+
+        case CMD_CLEAR_LATENCY:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            Latency_Reset();
+            return CMD_STATUS_OK;
+
+        case CMD_GET_SCHEDULE:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            Scheduler_GetAsCommandData(data);
+            return CMD_STATUS_OK;
+
+        case CMD_GET_HISTORY:
+            from = data[0] | (uint16_t)data[1] << 8;
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            History_GetAsCommandData(from, data);
+            return CMD_STATUS_OK;
+
+        case CMD_INJECT:
+            return Inject_Command(data);
+
+        case CMD_SET_KEYS:
+            for (i = 0; i < MAP_KEYS; i++) {
+                if (!KEYBOARD_Valid(data[i])) {
+                    return CMD_STATUS_RANGE;
+                }
+            }
+            // answer with the keys as saved
+            Mapping_Save(NULL, NULL, data);
+            // fall through
+        case CMD_GET_KEYS:
+            memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+            for (i = 0; i < MAP_KEYS; i++) {
+                data[i] = Mapping_GetKey(i);
+            }
+            return CMD_STATUS_OK;
+
+        default:
+            return CMD_STATUS_COMMAND;
+    }
+}
+
+void Command_Initialize(void)
+{
+    commandAnswer = CMD_ANSWER_NONE;
+    cmdReceive = HIDRxPacket(CMD_EP, cmdBuf, CMD_REPORT_SIZE);
+}
+
+void Command_Tasks(void)
+{
+    uint8_t status;
+
+    if (commandAnswer == CMD_ANSWER_NONE) {
+        if (cmdReceive == 0 || HIDRxHandleBusy(cmdReceive)) {
+            return;
+        }
+        if (USBHandleGetLength(cmdReceive) < CMD_REPORT_SIZE || cmdBuf[0] != CMD_REPORT_ID) {
+            status = CMD_STATUS_LENGTH;
+        } else {
+            status = handle(&cmdBuf[CMD_DATA_OFFSET]);
+        }
+        if (status != CMD_STATUS_OK) {
+            memset(&cmdBuf[CMD_DATA_OFFSET], 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+        }
+        cmdBuf[0] = CMD_REPORT_ID;
+        cmdBuf[3] = status;
+        commandAnswer = CMD_ANSWER_WAITING;
+    }
+
+    // the IN side is shared: wait for the extended report, then for the answer
+    if (HIDTxHandleBusy(extTransmission)) {
+        return;
+    }
+    if (commandAnswer == CMD_ANSWER_WAITING) {
+        extTransmission = HIDTxPacket(CMD_EP, cmdBuf, CMD_REPORT_SIZE);
+        commandAnswer = CMD_ANSWER_SENT;
+        return;
+    }
+    commandAnswer = CMD_ANSWER_NONE;
+    cmdReceive = HIDRxPacket(CMD_EP, cmdBuf, CMD_REPORT_SIZE);
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   command.h
+ * Configuration commands over the interrupt endpoints of interface 1,
+ * so that host tools leave EP0 alone while the pad is in use. The host
+ * writes Output report CMD_REPORT_ID, which goes to the OUT side of
+ * CMD_EP; the pad answers with Input report CMD_REPORT_ID on the IN
+ * side, which it shares with the extended input report (ext_report.h).
+ *
+ *   0      report ID (CMD_REPORT_ID)
+ *   1      command (CMD_*); echoed in the answer
+ *   2      tag, any value; echoed, so the host can pair the answer
+ *   3      answer: status (CMD_STATUS_*)
+ *   4-63   data
+ *
+ * One command at a time: the OUT side is armed again once the answer
+ * has gone out, and the host holds a second command until then. The
+ * answer is queued in the main-loop pass after the command arrived and
+ * goes out on the next IN poll, so a round trip takes one or two frames.
+ * An extended report due while the answer waits is left out and shows
+ * as a sequence gap.
+ *
+ * Data of the commands -> of their answers:
+ *   CMD_INFO            -> 0 CMD_PROTOCOL_VER, 1 NUM_BUTTONS
+ *   CMD_GET_MAPPING     -> 0-8 normal mode usage per button (mapping.h),
+ *                          9-17 special mode
+ *   CMD_SET_MAPPING     0-17 as above, usages 0-14 -> the same; in use
+ *                       at once, in flash a few passes after the answer
+ *   CMD_GET_PROFILE     -> 0 mapping in use (0 normal, 1 special),
+ *                          1 D-pad mode (0 X/Y, 1 hat switch, 2 Z/Rz)
+ *   CMD_SET_PROFILE     0-1 as above -> the same; kept until the next
+ *                       reset or SET_CONFIGURATION, like the button chords
+ *   CMD_GET_TELEMETRY   -> the telemetry Feature report (telemetry.h)
+ *   CMD_GET_LATENCY     -> the latency Feature report (latency.h)
+ *   CMD_CLEAR_LATENCY   -> nothing
+ *   CMD_GET_SCHEDULE    -> the task table with each task's worst run and
+ *                          overruns (Scheduler_GetAsCommandData())
+ *   CMD_GET_HISTORY     0-1 sequence number of the first entry wanted
+ *                       -> button changes from there on
+ *                          (History_GetAsCommandData())
+ *   CMD_INJECT          button states to play back, one per frame
+ *                       -> the room left for more (inject.h)
+ *   CMD_GET_KEYS        -> 0-12 keyboard keycode per button (keyboard.h),
+ *                          0 for none
+ *   CMD_SET_KEYS        0-12 as above -> the same; saved like the mapping
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdint.h>
+
+#define CMD_REPORT_ID           0x06
+#define CMD_REPORT_SIZE         64      // including the report ID
+#define CMD_DATA_OFFSET         4
+#define CMD_PROTOCOL_VER        1
+
+#define CMD_INFO                0x01
+#define CMD_GET_MAPPING         0x02
+#define CMD_SET_MAPPING         0x03
+#define CMD_GET_PROFILE         0x04
+#define CMD_SET_PROFILE         0x05
+#define CMD_GET_TELEMETRY       0x06
+#define CMD_GET_LATENCY         0x07
+#define CMD_CLEAR_LATENCY       0x08
+#define CMD_GET_SCHEDULE        0x09
+#define CMD_GET_HISTORY         0x0A
+#define CMD_INJECT              0x0B
+#define CMD_GET_KEYS            0x0C
+#define CMD_SET_KEYS            0x0D
+
+#define CMD_STATUS_OK           0x00
+#define CMD_STATUS_COMMAND      0x01    // unknown command
+#define CMD_STATUS_RANGE        0x02    // a value out of range; nothing changed
+#define CMD_STATUS_LENGTH       0x03    // short packet or another report ID
+
+/* whether cmdBuf holds an answer; ExtReport_Send() keeps off the IN side
+   while one is waiting */
+#define CMD_ANSWER_NONE         0
+#define CMD_ANSWER_WAITING      1
+#define CMD_ANSWER_SENT         2       // the OUT side is armed once it is out
+
+extern uint8_t commandAnswer;
+
+/**
+ * Arm the OUT side of CMD_EP; from APP_DeviceJoystickInitialize(), after
+ * ExtReport_Initialize() has enabled the endpoint
+ */
+void Command_Initialize(void);
+
+/**
+ * Handle a command that has arrived and send its answer; call once per
+ * main-loop pass while configured
+ */
+void Command_Tasks(void);
+
+#endif /* COMMAND_H */
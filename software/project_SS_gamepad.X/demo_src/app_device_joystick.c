@@ -23,6 +23,11 @@ please contact mla_licensing@microchip.com
  * Changes from the original source:
  *     - APP_DeviceJoystickTasks(void)
  *     - delete unused sentences
+ *     - telemetry counters
+ *     - latency measurement
+ *     - extended input report
+ *     - boot time of the first report
+ *     - configuration commands on EP2
  ********************************************************************/
 
 #ifndef USBJOYSTICK_C
@@ -33,9 +38,17 @@ please contact mla_licensing@microchip.com
 #include "usb_device_hid.h"
 //#include "app_led_usb_status.h"
 #include "my_app_device_gamepad.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "ext_report.h"
+#include "command.h"
+#include "cadence.h"
+#include "inject.h"
+#include "keyboard.h"
+#include "code_map.h"
 #include "stdint.h"
 
-USB_VOLATILE USB_HANDLE lastTransmission = 0;
+__near USB_VOLATILE USB_HANDLE lastTransmission = 0;    // common RAM (ram_map.h)
 
 /*********************************************************************
 * Function: void APP_DeviceJoystickInitialize(void);
@@ -54,9 +67,16 @@ void APP_DeviceJoystickInitialize(void)
     //initialize the variable holding the handle for the last
     // transmission
     lastTransmission = 0;
+    // the passes spent enumerating are not a gap between reports
+    telemetryLoops = 0;
 
     //enable the HID endpoint
     USBEnableEndpoint(JOYSTICK_EP,USB_IN_ENABLED|USB_HANDSHAKE_ENABLED|USB_DISALLOW_SETUP);
+    ExtReport_Initialize();
+    Keyboard_Initialize();
+    Command_Initialize();
+    Cadence_Reset();
+    Inject_Reset();
     
     App_DeviceGamepadInit();
 }//end UserInit
@@ -75,7 +95,7 @@ void APP_DeviceJoystickInitialize(void)
 * Output: None
 *
 ********************************************************************/
-void APP_DeviceJoystickTasks(void)
+HOT_PATH void APP_DeviceJoystickTasks(void)
 {  
 
     /* If the USB device isn't configured yet, we can't really do anything
@@ -100,16 +120,24 @@ void APP_DeviceJoystickTasks(void)
     //If the last transmission is complete
     if(!HIDTxHandleBusy(lastTransmission))
     {
+        // a host that polls less often than bInterval gets a report
+        // built just before its poll, not just after the last one
+        if (!CADENCE_Due()) {
+            return;
+        }
+        EXT_REPORT_Latch();
         App_DeviceGamepadAct(&joystick_input);
         
         //Send the packet over USB to the host.
         lastTransmission = HIDTxPacket(JOYSTICK_EP, (uint8_t*)&joystick_input, sizeof(joystick_input));
-
-        // change left cross key function
-        ChangeSWMode_Button_Select();
-
-        // change left cross key function
-        ChangeSWMode_Button_Start();
+        TELEMETRY_ReportSent();
+        TELEMETRY_Boot(telemetry.bootFirstReport);
+        LATENCY_ReportQueued();
+        ExtReport_Send(&joystick_input);
+    }
+    else
+    {
+        TELEMETRY_BusyMiss();
     }
     
 }//end ProcessIO
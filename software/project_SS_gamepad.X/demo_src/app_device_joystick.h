@@ -22,8 +22,12 @@ please contact mla_licensing@microchip.com
  * 
  * Changes from the original source:
  *     - moved DECLARATIONS, TYPE DEFINITIONS and VARIABLES to this file from app_device_joystick.c.
+ *     - include guard
  ********************************************************************/
 
+#ifndef APP_DEVICE_JOYSTICK_H
+#define APP_DEVICE_JOYSTICK_H
+
 #include "stdint.h"
 #include "system.h"
 
@@ -144,3 +148,5 @@ void APP_DeviceJoystickStart(void);
 *
 ********************************************************************/
 void APP_DeviceJoystickTasks(void);
+
+#endif /* APP_DEVICE_JOYSTICK_H */
@@ -1,7 +1,7 @@
 #ifndef HID_RPT_MAP_H
 #define HID_RPT_MAP_H
 
-#define HID_MAP_RPT_DESC_SIZE 21   // レポートディスクリプタのサイズ
+#define HID_MAP_RPT_DESC_SIZE 67   // レポートディスクリプタのサイズ
 #define HID_MAP_EP_BUF_SIZE   64   // USB EP送受信バッファのサイズ
 
 const struct{uint8_t report[HID_MAP_RPT_DESC_SIZE];}hid_map_rpt={{ 
@@ -11,9 +11,32 @@ const struct{uint8_t report[HID_MAP_RPT_DESC_SIZE];}hid_map_rpt={{
   0x15,0x00,                 //   Logical Minimum (0)
   0x26,0xFF,0x00,           //   Logical Maximum (255)
   0x75,0x08,                 //   Report Size (8)
-  0x95,0x40,                 //   Report Count (64) - for 64 bytes total including Report ID
+  0x85,0x01,                 //   Report ID (1) - mapping (mapping.c)
+  0x95,0x3F,                 //   Report Count (63) - for 64 bytes total including Report ID
   0x09,0x01,                 //   Usage (Vendor Usage 1)
   0xB1,0x02,                 //   Feature (Data, Variable, Absolute)
+  0x85,0x02,                 //   Report ID (2) - telemetry counters (telemetry.h)
+  0x95,0x35,                 //   Report Count (53) - for 54 bytes total including Report ID
+  0x09,0x02,                 //   Usage (Vendor Usage 2)
+  0xB1,0x02,                 //   Feature (Data, Variable, Absolute)
+  0x85,0x03,                 //   Report ID (3) - latency histogram (latency.h)
+  0x95,0x2F,                 //   Report Count (47) - for 48 bytes total including Report ID
+  0x09,0x03,                 //   Usage (Vendor Usage 3)
+  0xB1,0x02,                 //   Feature (Data, Variable, Absolute)
+  0x85,0x04,                 //   Report ID (4) - extended input report on EP2 (ext_report.h)
+  0x95,0x0A,                 //   Report Count (10) - for 11 bytes total including Report ID
+  0x09,0x04,                 //   Usage (Vendor Usage 4)
+  0x81,0x02,                 //   Input (Data, Variable, Absolute)
+  0x85,0x05,                 //   Report ID (5) - restart into the bootloader (boot_request.h)
+  0x95,0x04,                 //   Report Count (4) - for 5 bytes total including Report ID
+  0x09,0x05,                 //   Usage (Vendor Usage 5)
+  0xB1,0x02,                 //   Feature (Data, Variable, Absolute)
+  0x85,0x06,                 //   Report ID (6) - commands and their answers on EP2 (command.h)
+  0x95,0x3F,                 //   Report Count (63) - for 64 bytes total including Report ID
+  0x09,0x06,                 //   Usage (Vendor Usage 6)
+  0x81,0x02,                 //   Input (Data, Variable, Absolute)
+  0x09,0x06,                 //   Usage (Vendor Usage 6)
+  0x91,0x02,                 //   Output (Data, Variable, Absolute)
   0xC0                       //   End Collection
 }};
 
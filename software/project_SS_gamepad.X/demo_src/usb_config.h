@@ -34,8 +34,8 @@ please contact mla_licensing@microchip.com
 								// that use EP0 IN or OUT for sending large amounts of
 								// application related data.
 									
-#define USB_MAX_NUM_INT     	2   //Set this number to match the maximum interface number used in the descriptors for this firmware project
-#define USB_MAX_EP_NUMBER	    1   //Set this number to match the maximum endpoint number used in the descriptors for this firmware project
+#define USB_MAX_NUM_INT     	3   //Set this number to match the maximum interface number used in the descriptors for this firmware project
+#define USB_MAX_EP_NUMBER	    3   //Set this number to match the maximum endpoint number used in the descriptors for this firmware project
 
 //Device descriptor - if these two definitions are not defined then
 //  a const USB_DEVICE_DESCRIPTOR variable by the exact name of device_dsc
@@ -81,6 +81,11 @@ please contact mla_licensing@microchip.com
 //#define USB_INTERRUPT
 //------------------------------------------------------------------------------
 
+//Build usb_device.c for this part and the settings above only (PIC16F1,
+//polling, full ping-pong, full speed, no OTG): an idle USBDeviceTasks() pass
+//returns after one UIR test and the unused 32-bit 1ms tick counter is left out.
+#define USB_DEVICE_PIC16F1_ONLY
+
 /* Parameter definitions are defined in usb_device.h */
 #define USB_PULLUP_OPTION USB_PULLUP_ENABLE
 //#define USB_PULLUP_OPTION USB_PULLUP_DISABLED
@@ -167,12 +172,16 @@ please contact mla_licensing@microchip.com
 /* HID */
 #define HID_INTF_ID             0x00
 #define JOYSTICK_EP		1
+#define EXT_REPORT_EP           2       // extended input report on interface 1 (ext_report.h)
+#define CMD_EP                  2       // commands in, answers out on interface 1 (command.h)
+#define KEYBOARD_EP             3       // NKRO keyboard report on interface 2 (keyboard.h)
 #define HID_INT_OUT_EP_SIZE     64
-#define HID_INT_IN_EP_SIZE      64
+#define HID_INT_IN_EP_SIZE      7       // the EP1 report as it is (INPUT_CONTROLS, ram_map.c)
 #define HID_NUM_OF_DSC          1   // Number of HID class descriptors per interface
 #define HID_RPT01_SIZE          74      //number of bytes in HID report descriptor (counted exactly)
-#define HID_MAP_RPT_DESC_SIZE   21      // size of the mapping Feature report descriptor (hid_rpt_map.h)
+#define HID_MAP_RPT_DESC_SIZE   67      // size of the interface 1 Feature report descriptor (hid_rpt_map.h)
 #define HID_MAP_EP_BUF_SIZE     64      // size of the mapping Feature report EP buffer
+#define HID_KBD_RPT_DESC_SIZE   31      // size of the interface 2 keyboard report descriptor (usb_descriptors.c)
 
 /** DEFINITIONS ****************************************************/
 
@@ -151,6 +151,9 @@ state according to the definition in the USB specification.
 #include "usb_device_hid.h"
 #include "my_usb_pid.h"
 #include "hid_rpt_map.h"
+#include "ext_report.h"
+#include "command.h"
+#include "keyboard.h"
 
 /** CONSTANTS ******************************************************/
 #if defined(COMPILER_MPLAB_C18)
@@ -181,11 +184,11 @@ const uint8_t configDescriptor1[]={
     /* Configuration Descriptor */    
     0x09,//sizeof(USB_CFG_DSC),    // Size of this descriptor in bytes     
     USB_DESCRIPTOR_CONFIGURATION,                // CONFIGURATION descriptor type      
-    DESC_CONFIG_WORD(0x0034),                   // Total length of data for this cfg
-    2,                      // Number of interfaces in this cfg
+    DESC_CONFIG_WORD(0x005B),                   // Total length of data for this cfg
+    3,                      // Number of interfaces in this cfg
     1,                      // Index value of this configuration
     0,                      // Configuration string index
-    _DEFAULT | _SELF,       // Attributes, see usb_device.h
+    _DEFAULT | _SELF | _RWU,    // Attributes, see usb_device.h
     50,                     // Max power consumption (2X mA)
 
     /* Interface Descriptor (Interface 0: GamePad) */    
@@ -213,7 +216,7 @@ const uint8_t configDescriptor1[]={
     USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
     JOYSTICK_EP | _EP_IN,            //EndpointAddress
     _INTERRUPT,                       //Attributes
-    DESC_CONFIG_WORD(64),        //size
+    DESC_CONFIG_WORD(HID_INT_IN_EP_SIZE),        //size
     0x01,                        //Interval
 
     /* Interface Descriptor (Interface 1: Vendor Feature) */    
@@ -221,7 +224,7 @@ const uint8_t configDescriptor1[]={
     USB_DESCRIPTOR_INTERFACE,               // INTERFACE descriptor type    
     1,                      // Interface Number    
     0,                      // Alternate Setting Number    
-    0,                      // Number of endpoints in this intf    
+    2,                      // Number of endpoints in this intf    
     HID_INTF,               // Class code    
     0xFF,                   // Subclass code - Vendor defined    
     0xFF,                   // Protocol code - Vendor defined    
@@ -235,7 +238,50 @@ const uint8_t configDescriptor1[]={
     HID_NUM_OF_DSC,         // Number of class descriptors, see usbcfg.h
     DSC_RPT,                // Report descriptor type
     DESC_CONFIG_WORD(HID_MAP_RPT_DESC_SIZE),   // Size of the report descriptor
-    // No endpoint descriptors for Interface 1
+
+    /* Endpoint Descriptor (extended input report, ext_report.h, and command answers) */
+    0x07,/*sizeof(USB_EP_DSC)*/
+    USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
+    EXT_REPORT_EP | _EP_IN,          //EndpointAddress
+    _INTERRUPT,                       //Attributes
+    DESC_CONFIG_WORD(CMD_REPORT_SIZE),   //size
+    0x01,                        //Interval
+
+    /* Endpoint Descriptor (commands, command.h) */
+    0x07,/*sizeof(USB_EP_DSC)*/
+    USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
+    CMD_EP | _EP_OUT,                //EndpointAddress
+    _INTERRUPT,                       //Attributes
+    DESC_CONFIG_WORD(CMD_REPORT_SIZE),   //size
+    0x01,                        //Interval
+
+    /* Interface Descriptor (Interface 2: NKRO keyboard, keyboard.h) */
+    0x09,//sizeof(USB_INTF_DSC),   // Size of this descriptor in bytes
+    USB_DESCRIPTOR_INTERFACE,               // INTERFACE descriptor type
+    2,                      // Interface Number
+    0,                      // Alternate Setting Number
+    1,                      // Number of endpoints in this intf
+    HID_INTF,               // Class code
+    0,                      // Subclass code - no boot protocol, the bitmap is not a boot report
+    0,                      // Protocol code
+    0,                      // Interface string index
+
+    /* HID Class-Specific Descriptor */
+    0x09,//sizeof(USB_HID_DSC)+3,    // Size of this descriptor in bytes
+    DSC_HID,                // HID descriptor type
+    DESC_CONFIG_WORD(0x0111),                 // HID Spec Release Number in BCD format (1.11)
+    0x00,                   // Country Code (0x00 for Not supported)
+    HID_NUM_OF_DSC,         // Number of class descriptors, see usbcfg.h
+    DSC_RPT,                // Report descriptor type
+    DESC_CONFIG_WORD(HID_KBD_RPT_DESC_SIZE),   // Size of the report descriptor
+
+    /* Endpoint Descriptor */
+    0x07,/*sizeof(USB_EP_DSC)*/
+    USB_DESCRIPTOR_ENDPOINT,    //Endpoint Descriptor
+    KEYBOARD_EP | _EP_IN,            //EndpointAddress
+    _INTERRUPT,                       //Attributes
+    DESC_CONFIG_WORD(KEYBOARD_REPORT_SIZE),  //size
+    0x01,                        //Interval
 };
 
 
@@ -315,4 +361,24 @@ const struct{uint8_t report[HID_RPT01_SIZE];}hid_rpt01={{
 
   0xC0              //END_COLLECTION
 }};
+
+/* Interface 2: one bit per key, modifiers first (keyboard.h) */
+const struct{uint8_t report[HID_KBD_RPT_DESC_SIZE];}hid_kbd_rpt={{
+  0x05,0x01,        //USAGE_PAGE (Generic Desktop)
+  0x09,0x06,        //USAGE (Keyboard)
+  0xA1,0x01,        //COLLECTION (Application)
+  0x05,0x07,        //  USAGE_PAGE (Keyboard/Keypad)
+  0x19,0xE0,        //  USAGE_MINIMUM (Left Control)
+  0x29,0xE7,        //  USAGE_MAXIMUM (Right GUI)
+  0x15,0x00,        //  LOGICAL_MINIMUM (0)
+  0x25,0x01,        //  LOGICAL_MAXIMUM (1)
+  0x75,0x01,        //  REPORT_SIZE (1)
+  0x95,0x08,        //  REPORT_COUNT (8)
+  0x81,0x02,        //  INPUT (Data,Var,Abs)
+  0x19,0x00,        //  USAGE_MINIMUM (0)
+  0x29,0x67,        //  USAGE_MAXIMUM (Keypad =)
+  0x95,0x68,        //  REPORT_COUNT (104)
+  0x81,0x02,        //  INPUT (Data,Var,Abs)
+  0xC0              //END_COLLECTION
+}};
 /** EOF usb_descriptors.c ***************************************************/
@@ -22,6 +22,11 @@ please contact mla_licensing@microchip.com
  * 
  * Changes from the original source:
  *     - deleted unused header file inclusion
+ *     - telemetry counters and their Feature report on interface 1
+ *     - latency histogram Feature report on interface 1
+ *     - bootloader request Feature report on interface 1
+ *     - GET_REPORT(Input) on interfaces 0 and 2
+ *     - sleep through a suspend, remote wakeup on a button
  ********************************************************************/
 
 /** INCLUDES *******************************************************/
@@ -33,8 +38,17 @@ please contact mla_licensing@microchip.com
 #include "usb_framework/inc/usb_device.h"
 
 #include "app_device_joystick.h"
+#include "my_app_device_gamepad.h"
 #include "mapping.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "boot_request.h"
+#include "power.h"
+#include "cadence.h"
+#include "inject.h"
+#include "keyboard.h"
 #include "demo_src/hid_rpt_map.h"
+#include "ram_map.h"
 
 /*******************************************************************
  * Function:        bool USER_USB_CALLBACK_EVENT_HANDLER(
@@ -62,12 +76,20 @@ bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size
     switch( (int) event )
     {
         case EVENT_TRANSFER:
+            /* TRNIF of an endpoint other than EP0; pdata is the USTAT copy */
+            if (USBHALGetLastEndpoint((*(USTAT_FIELDS*)pdata)) == JOYSTICK_EP) {
+                Latency_TransferComplete();
+                POWER_ReportComplete();
+                Cadence_TransferComplete();
+            }
             break;
 
         case EVENT_SOF:
             /* We are using the SOF as a timer to time the LED indicator.  Call
              * the LED update function here. */
 //            APP_LEDUpdateUSBStatus();
+            TELEMETRY_Sof();
+            INJECT_Sof();
             break;
 
         case EVENT_SUSPEND:
@@ -81,6 +103,9 @@ bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size
             //no further processing is needed for purely self powered applications that
             //don't consume power from the host.
             SYSTEM_Initialize(SYSTEM_STATE_USB_SUSPEND);
+            Power_Suspend();
+            Cadence_Reset();            // the host may poll otherwise after the resume
+            Inject_Reset();             // no SOFs to play along
             break;
 
         case EVENT_RESUME:
@@ -98,6 +123,7 @@ bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size
             /* When the device is configured, we can (re)initialize the demo
              * code. */
             APP_DeviceJoystickInitialize();
+            TELEMETRY_Boot(telemetry.bootConfigured);
             break;
 
         case EVENT_SET_DESCRIPTOR:
@@ -110,6 +136,7 @@ bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size
             break;
 
         case EVENT_BUS_ERROR:
+            TELEMETRY_BusError();
             break;
 
         case EVENT_TRANSFER_TERMINATED:
@@ -121,41 +148,103 @@ bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size
     return true;
 }
 
-// Feature report buffers for two interfaces
-static uint8_t featureBuf[64];            // Interface 0 受信用バッファ
-static uint8_t mapFeatureBuf[64];         // Interface 1 mapping feature buffer
+// Feature reports of interface 1 pass through configArena (ram_map.h)
 
 /* ---------- ② 64B受信し終わったとき自動で呼ばれる ---------- */
 void USBCB_HIDSetReportComplete(void)
 {
     // Process the mapping data immediately after receiving
-    Mapping_SetFromFeatureReport(mapFeatureBuf, sizeof(mapFeatureBuf));
+    Mapping_SetFromFeatureReport(configArena.feature, sizeof(configArena.feature));
 
 }
 
-/* ---------- SET_REPORT handler for both interfaces ---------- */
+/* SET_REPORT of the latency histogram: the data does not matter */
+static void USBCB_LatencyResetComplete(void)
+{
+    Latency_Reset();
+}
+
+/* GET_REPORT(Input) of the gamepad: a sample taken from the ports now,
+   built in configArena so that joystick_input and lastTransmission, which
+   belong to the EP1 IN side, are left alone */
+static void sendInputReport(void)
+{
+    INPUT_CONTROLS *sample = (INPUT_CONTROLS *)configArena.feature;
+
+    App_DeviceGamepadAct(sample);
+    USBEP0SendRAMPtr(configArena.feature, sizeof(INPUT_CONTROLS), USB_EP0_INCLUDE_ZERO);
+}
+
+/* ---------- SET_REPORT / GET_REPORT handler for all interfaces ---------- */
 void HIDFeatureReceive(void)
 {
     uint8_t reportID = SetupPkt.W_Value.byte.LB;  // Report ID is in the low byte of wValue
     uint8_t interfaceNum = SetupPkt.W_Index.byte.LB;  // Interface number is in the low byte of wIndex
     
+    if (interfaceNum == 0) {
+        // one report without an ID; anything else is left unhandled and stalls
+        if (SetupPkt.bRequest == GET_REPORT && reportID == 0
+                && SetupPkt.W_Value.byte.HB == HID_REPORT_TYPE_INPUT) {
+            sendInputReport();
+        }
+        return;
+    }
+    if (interfaceNum == 2) {
+        // the keyboard, as on EP3 now; left alone there
+        if (SetupPkt.bRequest == GET_REPORT && reportID == 0
+                && SetupPkt.W_Value.byte.HB == HID_REPORT_TYPE_INPUT) {
+            Keyboard_Build(configArena.feature);
+            USBEP0SendRAMPtr(configArena.feature, KEYBOARD_REPORT_SIZE, USB_EP0_INCLUDE_ZERO);
+        }
+        return;
+    }
     if (interfaceNum == 1) {
+        if (reportID == TELEMETRY_REPORT_ID) {
+            // telemetry is read only; a SET_REPORT is left unhandled and stalls
+            if (SetupPkt.bRequest == GET_REPORT) {
+                Telemetry_GetAsFeatureReport(configArena.feature);
+                USBEP0SendRAMPtr(configArena.feature, TELEMETRY_REPORT_SIZE, USB_EP0_INCLUDE_ZERO);
+            }
+            return;
+        }
+        if (reportID == LATENCY_REPORT_ID) {
+            if (SetupPkt.bRequest == SET_REPORT) {
+                USBEP0Receive(configArena.feature, LATENCY_REPORT_SIZE, USBCB_LatencyResetComplete);
+            } else if (SetupPkt.bRequest == GET_REPORT) {
+                Latency_GetAsFeatureReport(configArena.feature);
+                USBEP0SendRAMPtr(configArena.feature, LATENCY_REPORT_SIZE, USB_EP0_INCLUDE_ZERO);
+            }
+            return;
+        }
+        if (reportID == BOOT_REPORT_ID) {
+            // write only; the restart happens in BootRequest_Tasks()
+            if (SetupPkt.bRequest == SET_REPORT) {
+                BootRequest_Receive();
+            }
+            return;
+        }
+        if (reportID != MAP_REPORT_ID && reportID != 0) {
+            return;
+        }
+
+        // Mapping: report ID 1, or 0 from hosts written before the report IDs
         // Check if this is SET_REPORT (from host to device)
         if (SetupPkt.bRequest == SET_REPORT) {
             // SET_REPORT - receive data from host via control transfer
-            USBEP0Receive(mapFeatureBuf, HID_MAP_EP_BUF_SIZE, USBCB_HIDSetReportComplete);
+            USBEP0Receive(configArena.feature, HID_MAP_EP_BUF_SIZE, USBCB_HIDSetReportComplete);
 
             // Process the mapping data immediately after receiving
-            // Mapping_SetFromFeatureReport(mapFeatureBuf, sizeof(mapFeatureBuf));
+            // Mapping_SetFromFeatureReport(configArena.feature, sizeof(configArena.feature));
         } 
         else if (SetupPkt.bRequest == GET_REPORT) {
             // GET_REPORT - send data to host
             // Prepare feature report data
-            memset(mapFeatureBuf, 0, sizeof(mapFeatureBuf));  // Clear buffer
-            Mapping_GetAsFeatureReport(mapFeatureBuf);  // Fill with mapping data
+            memset(configArena.feature, 0, sizeof(configArena.feature));  // Clear buffer
+            Mapping_GetAsFeatureReport(configArena.feature);  // Fill with mapping data
+            configArena.feature[0] = reportID;                // Answer with the ID asked for
             
             // Send the data back to the host through endpoint 0
-            USBEP0SendRAMPtr(mapFeatureBuf, HID_MAP_EP_BUF_SIZE, USB_EP0_INCLUDE_ZERO);
+            USBEP0SendRAMPtr(configArena.feature, HID_MAP_EP_BUF_SIZE, USB_EP0_INCLUDE_ZERO);
         }
     }
 }
@@ -0,0 +1,86 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "ext_report.h"
+#include "command.h"
+#include "telemetry.h"
+
+uint32_t extSampleTicks;
+
+/* the USB module reads the report from its own RAM */
+#if defined(FIXED_ADDRESS_MEMORY) && defined(__XC8)
+    static EXT_INPUT_REPORT extReport HID_CUSTOM_IN_DATA_BUFFER_ADDRESS;
+#else
+    static EXT_INPUT_REPORT extReport;
+#endif
+
+USB_VOLATILE USB_HANDLE extTransmission;
+static uint8_t seq;
+static uint32_t lastTicks;
+static uint16_t clockUs;
+static uint8_t clockThirds;             // Timer1 ticks are 2/3 us
+
+void ExtReport_Initialize(void)
+{
+    extTransmission = 0;
+    ExtReport_Rebase();
+    // the OUT side takes the commands (command.h)
+    USBEnableEndpoint(EXT_REPORT_EP, USB_IN_ENABLED|USB_OUT_ENABLED|USB_HANDSHAKE_ENABLED|USB_DISALLOW_SETUP);
+}
+
+void ExtReport_Rebase(void)
+{
+    extSampleTicks = Telemetry_Now();
+    lastTicks = extSampleTicks;
+}
+
+void ExtReport_Send(const INPUT_CONTROLS* input)
+{
+    uint32_t gap;
+    uint16_t ticks, q;
+
+    // the clock follows every sample, sent or not; Telemetry_Now() counts
+    // 24 bits. A gap of more than 16 bits goes in 32768 us (49152 ticks)
+    // at a time, so the division stays 16-bit.
+    gap = (extSampleTicks - lastTicks) & 0x00FFFFFFu;
+    lastTicks = extSampleTicks;
+    while (gap > 0xFFFF) {
+        gap -= 49152u;
+        clockUs += 32768u;
+    }
+    ticks = (uint16_t)gap;
+    q = ticks / 3;
+    clockUs += q * 2;
+    clockThirds += (uint8_t)(ticks - q * 3) * 2;
+    while (clockThirds >= 3) {
+        clockThirds -= 3;
+        clockUs++;
+    }
+    seq++;
+
+    if (commandAnswer == CMD_ANSWER_WAITING || HIDTxHandleBusy(extTransmission)) {
+        return;
+    }
+    extReport.reportId = EXT_REPORT_ID;
+    extReport.seq = seq;
+    extReport.sampleUs = clockUs;
+    extReport.input = *input;
+    extTransmission = HIDTxPacket(EXT_REPORT_EP, (uint8_t*)&extReport, EXT_REPORT_SIZE);
+}
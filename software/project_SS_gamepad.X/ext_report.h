@@ -0,0 +1,85 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   ext_report.h
+ * Extended input report: the gamepad report with a sequence number and
+ * the time its sample was taken, as Input report EXT_REPORT_ID on the
+ * interrupt IN endpoint EXT_REPORT_EP of interface 1.
+ *
+ *   0      report ID (EXT_REPORT_ID)
+ *   1      sequence, +1 per sample taken for EP1, so a gap means the
+ *          host missed samples and a repeat means it read one twice
+ *   2-3    sample time, us, rolls over every 65.5 ms
+ *   4-10   the EP1 report (INPUT_CONTROLS)
+ *
+ * Interface 0 stays as it was. Hosts that do not read interface 1 leave
+ * the report in EP2, and the firmware just skips it until they do. The
+ * sample clock is Telemetry_Now() (telemetry.h), exact across gaps of up
+ * to 11 s; the time asleep in a USB suspend is not in it.
+ *
+ * The endpoint also carries the configuration commands (command.h): their
+ * answers go out on its IN side between two of these reports.
+ */
+
+#ifndef EXT_REPORT_H
+#define EXT_REPORT_H
+
+#include <stdint.h>
+
+#include "app_device_joystick.h"
+#include "telemetry.h"
+#include "usb.h"
+
+#define EXT_REPORT_ID       0x04
+#define EXT_REPORT_SIZE     11      // including the report ID
+
+typedef struct {
+    uint8_t reportId;
+    uint8_t seq;
+    uint16_t sampleUs;
+    INPUT_CONTROLS input;
+} EXT_INPUT_REPORT;
+
+/* last transfer on the IN side of EXT_REPORT_EP, command answers included */
+extern USB_VOLATILE USB_HANDLE extTransmission;
+
+/* Telemetry_Now() when joystick_input was last sampled */
+extern uint32_t extSampleTicks;
+
+/**
+ * Note the sample time; call right before App_DeviceGamepadAct()
+ */
+#define EXT_REPORT_Latch()  (extSampleTicks = Telemetry_Now())
+
+/**
+ * Enable EXT_REPORT_EP; from APP_DeviceJoystickInitialize()
+ */
+void ExtReport_Initialize(void);
+
+/**
+ * Go on with the sample clock from now; after Telemetry_RestartTimer1()
+ */
+void ExtReport_Rebase(void);
+
+/**
+ * Count the sample and queue it on EXT_REPORT_EP when the host has taken
+ * the previous one. Call after joystick_input has gone out on EP1.
+ * @param input the report just sent on EP1
+ */
+void ExtReport_Send(const INPUT_CONTROLS* input);
+
+#endif /* EXT_REPORT_H */
@@ -22,12 +22,28 @@ please contact mla_licensing@microchip.com
 
 #define FIXED_ADDRESS_MEMORY
 
+/* linear addresses of the buffers the SIE reads or writes besides the
+   BDT; ram_map.h has the whole map */
+#define JOYSTICK_DATA_ADDR                  0x2050  // bank 1
+#define HID_CUSTOM_IN_DATA_BUFFER_ADDR      0x20A0  // bank 2
+#define KEYBOARD_DATA_ADDR                  0x20B0  // bank 2, keyboard.c
+#define CMD_DATA_BUFFER_ADDR                0x20F0  // bank 3, command.c
+
+/* read on every report, kept in the bank of joystick_input */
+#define MAPPING_MASK_ADDR                   0x2058  // bank 1, mapping.c
+
 #if(__XC8_VERSION < 2000)
-    #define JOYSTICK_DATA_ADDRESS @0x2050
-    #define HID_CUSTOM_IN_DATA_BUFFER_ADDRESS @0x20A0
+    #define JOYSTICK_DATA_ADDRESS @JOYSTICK_DATA_ADDR
+    #define HID_CUSTOM_IN_DATA_BUFFER_ADDRESS @HID_CUSTOM_IN_DATA_BUFFER_ADDR
+    #define KEYBOARD_DATA_ADDRESS @KEYBOARD_DATA_ADDR
+    #define CMD_DATA_BUFFER_ADDRESS @CMD_DATA_BUFFER_ADDR
+    #define MAPPING_MASK_ADDRESS @MAPPING_MASK_ADDR
 #else
-    #define JOYSTICK_DATA_ADDRESS __at(0x2050)
-    #define HID_CUSTOM_IN_DATA_BUFFER_ADDRESS __at(0x20A0)
+    #define JOYSTICK_DATA_ADDRESS __at(JOYSTICK_DATA_ADDR)
+    #define HID_CUSTOM_IN_DATA_BUFFER_ADDRESS __at(HID_CUSTOM_IN_DATA_BUFFER_ADDR)
+    #define KEYBOARD_DATA_ADDRESS __at(KEYBOARD_DATA_ADDR)
+    #define CMD_DATA_BUFFER_ADDRESS __at(CMD_DATA_BUFFER_ADDR)
+    #define MAPPING_MASK_ADDRESS __at(MAPPING_MASK_ADDR)
 #endif
 
 #endif //FIXED_MEMORY_ADDRESS
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <stdbool.h>
+
+#include "io_mapping.h"
+#include "telemetry.h"
+#include "history.h"
+
+/* Telemetry_Now() differences hold for 256 epochs; a run stops at half */
+#define LONG_EPOCHS     128
+#define LONG_TICKS      ((uint32_t)LONG_EPOCHS << 16)
+
+typedef struct
+{
+    uint16_t state;         // buttons and scale
+    uint16_t run;
+} HISTORY_ENTRY;
+
+static HISTORY_ENTRY ring[HISTORY_ENTRIES];
+static uint16_t next;                   // sequence number of the next entry
+static uint8_t held;                    // entries in the ring
+static uint16_t lastButtons;
+static uint32_t lastAt;                 // Telemetry_Now() at the last change
+static bool longRun;
+
+/* the pins are low while pressed */
+uint16_t History_ReadButtons(void)
+{
+    uint8_t a = ~PORTA & PORTA_BUTTONS;
+    uint8_t b = ~PORTB & PORTB_BUTTONS;
+    uint8_t c = ~PORTC & PORTC_BUTTONS;
+
+    return (uint16_t)(c >> 1) | (uint16_t)b << 3 | (uint16_t)a << 7;
+}
+
+static void encode(HISTORY_ENTRY *e, uint16_t buttons, uint32_t ticks)
+{
+    uint8_t scale = 0;
+
+    if (longRun || ticks >= LONG_TICKS) {
+        scale = HISTORY_SCALE_LONG;
+        ticks = 0xFFFF;
+    }
+    // at most 4 steps below LONG_TICKS
+    while (ticks > 0xFFFF) {
+        ticks >>= 2;
+        scale++;
+    }
+    e->state = buttons | (uint16_t)scale << HISTORY_SCALE_SHIFT;
+    e->run = (uint16_t)ticks;
+}
+
+static void putEntry(uint8_t *p, const HISTORY_ENTRY *e)
+{
+    p[0] = (uint8_t)e->state;
+    p[1] = (uint8_t)(e->state >> 8);
+    p[2] = (uint8_t)e->run;
+    p[3] = (uint8_t)(e->run >> 8);
+}
+
+void History_Initialize(void)
+{
+    next = 0;
+    held = 0;
+    longRun = false;
+    lastButtons = History_ReadButtons();
+    lastAt = Telemetry_Now();
+}
+
+void History_Scan(void)
+{
+    uint16_t buttons = History_ReadButtons();
+    uint32_t now;
+
+    if (buttons == lastButtons) {
+        // an 8-bit look at the epoch, so an idle pass stays cheap
+        if ((uint8_t)(telemetryEpoch - (uint8_t)(lastAt >> 16)) >= LONG_EPOCHS) {
+            longRun = true;
+        }
+        return;
+    }
+    now = Telemetry_Now();
+    encode(&ring[(uint8_t)next & (HISTORY_ENTRIES - 1)], buttons, (now - lastAt) & 0x00FFFFFFu);
+    next++;
+    if (held < HISTORY_ENTRIES) {
+        held++;
+    }
+    lastButtons = buttons;
+    lastAt = now;
+    longRun = false;
+}
+
+void History_GetAsCommandData(uint16_t from, uint8_t *data)
+{
+    HISTORY_ENTRY now;
+    uint16_t after;
+    uint8_t n, i;
+
+    if ((int16_t)(next - from) < 0) {
+        from = next;                    // not there yet
+    } else if ((uint16_t)(next - from) > held) {
+        from = next - held;             // overwritten
+    }
+    after = next - from;
+    n = after > HISTORY_PER_ANSWER ? HISTORY_PER_ANSWER : (uint8_t)after;
+
+    data[0] = (uint8_t)from;
+    data[1] = (uint8_t)(from >> 8);
+    data[2] = n;
+    data[3] = (uint8_t)(after - n);
+    encode(&now, lastButtons, (Telemetry_Now() - lastAt) & 0x00FFFFFFu);
+    putEntry(&data[4], &now);
+    for (i = 0; i < n; i++) {
+        putEntry(&data[8 + i * HISTORY_ENTRY_SIZE], &ring[(uint8_t)(from + i) & (HISTORY_ENTRIES - 1)]);
+    }
+}
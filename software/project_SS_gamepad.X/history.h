@@ -0,0 +1,104 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   history.h
+ * The last HISTORY_ENTRIES changes of the buttons, with the time
+ * between them, for input displays and for looking back at a match.
+ *
+ * The scan task (scheduler.h) reads all button pins once a pass; a pass
+ * whose pins differ from the last adds an entry: the buttons as they
+ * are now, and how long the buttons before them were held. That run is
+ * in Timer1 ticks (2/3 us), so the timing is as fine as a pass, well
+ * under the 1 ms of the reports. Entries are numbered from 0 at reset;
+ * the oldest is overwritten when the ring is full.
+ *
+ * Entry, 4 bytes, little endian:
+ *   0-1    bits 0-12: the buttons pressed, HISTORY_BTN_*
+ *          bits 13-15: scale of the run, s
+ *   2-3    run: the buttons before this entry were held for run << 2s
+ *          ticks; scale HISTORY_SCALE_LONG for 5.6 s or more
+ *
+ * Runs up to 43 ms are exact; longer ones lose their low bits. The
+ * time asleep in a USB suspend is not in them (power.h).
+ *
+ * The host reads the ring with CMD_GET_HISTORY on the command endpoint
+ * (command.h), HISTORY_PER_ANSWER entries at a time, without touching
+ * EP1. It puts the entries on its own clock from the newest backwards,
+ * with the run of the buttons as they are now, which comes with every
+ * answer.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+
+#define HISTORY_ENTRIES         32      // a power of two; 128 bytes of RAM
+#define HISTORY_ENTRY_SIZE      4
+#define HISTORY_PER_ANSWER      13
+
+/* the answer to CMD_GET_HISTORY: header, the current run, the entries */
+#define HISTORY_DATA_SIZE       (4 + HISTORY_ENTRY_SIZE * (1 + HISTORY_PER_ANSWER))
+
+/* bits of the buttons, from PORTC RC1-RC7, PORTB RB4-RB7, PORTA RA4-RA5 */
+#define HISTORY_BTN_TL          0x0001
+#define HISTORY_BTN_DOWN        0x0002
+#define HISTORY_BTN_C           0x0004
+#define HISTORY_BTN_Z           0x0008
+#define HISTORY_BTN_Y           0x0010
+#define HISTORY_BTN_B           0x0020
+#define HISTORY_BTN_A           0x0040
+#define HISTORY_BTN_RIGHT       0x0080
+#define HISTORY_BTN_UP          0x0100
+#define HISTORY_BTN_LEFT        0x0200
+#define HISTORY_BTN_START       0x0400
+#define HISTORY_BTN_TR          0x0800
+#define HISTORY_BTN_X           0x1000
+
+#define HISTORY_SCALE_SHIFT     13
+#define HISTORY_SCALE_LONG      7
+
+/**
+ * The button pins now, as HISTORY_BTN_* bits
+ */
+uint16_t History_ReadButtons(void);
+
+/**
+ * Start the history from the buttons as they are now. Telemetry_Initialize()
+ * must have started Timer1.
+ */
+void History_Initialize(void);
+
+/**
+ * Add an entry if the buttons changed; call once per main-loop pass
+ */
+void History_Scan(void);
+
+/**
+ * Put the entries from sequence number from on into the answer to
+ * CMD_GET_HISTORY:
+ *   0-1    sequence number of the first entry in the answer; later than
+ *          from when those have been overwritten
+ *   2      entries in the answer, up to HISTORY_PER_ANSWER
+ *   3      entries after them, for the next CMD_GET_HISTORY
+ *   4-7    the buttons now and their run so far, as an entry
+ *   8-     the entries
+ * @param data HISTORY_DATA_SIZE bytes, cleared
+ */
+void History_GetAsCommandData(uint16_t from, uint8_t *data);
+
+#endif /* HISTORY_H */
@@ -0,0 +1,136 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "command.h"
+#include "telemetry.h"
+#include "inject.h"
+
+#define FRAME_MASK      0x07FF      // UFRM counts 11 bits
+
+uint8_t injectState;
+uint16_t injectButtons;
+bool injectOverride;
+
+/* the queue; the entry being played is taken off it */
+static uint16_t queueButtons[INJECT_ENTRIES];
+static uint8_t queueFrames[INJECT_ENTRIES];
+static uint8_t head, count;
+static bool ending;                 // INJECT_LAST is queued
+static bool override;
+static uint8_t framesLeft;          // of the entry being played
+static uint16_t lastFrame;
+static uint16_t played;
+
+void Inject_Reset(void)
+{
+    injectState = INJECT_IDLE;
+    injectButtons = 0;
+    injectOverride = false;
+    head = 0;
+    count = 0;
+    ending = false;
+    framesLeft = 0;
+}
+
+/* one frame of the sequence */
+static void step(void)
+{
+    played++;
+    if (framesLeft != 0 && --framesLeft != 0) {
+        return;
+    }
+    if (count == 0) {
+        if (ending) {
+            Inject_Reset();
+        } else {
+            telemetry.injectUnderruns++;    // the state before holds
+        }
+        return;
+    }
+    injectButtons = queueButtons[head];
+    framesLeft = queueFrames[head];
+    head = (head + 1) & (INJECT_ENTRIES - 1);
+    count--;
+}
+
+void Inject_Sof(void)
+{
+    uint16_t frame = ((uint16_t)UFRMH << 8 | UFRML) & FRAME_MASK;
+    uint16_t frames;
+
+    if (injectState == INJECT_ARMED) {
+        injectState = INJECT_PLAYING;
+        injectOverride = override;
+        played = 0;
+        framesLeft = 0;
+        step();
+    } else {
+        frames = (frame - lastFrame) & FRAME_MASK;
+        if (frames > 1) {
+            telemetry.injectSlips += frames - 1;
+        }
+        // the SOFs in between were lost, not their frames
+        while (frames-- != 0 && injectState == INJECT_PLAYING) {
+            step();
+        }
+    }
+    lastFrame = frame;
+}
+
+uint8_t Inject_Command(uint8_t *data)
+{
+    uint8_t flags = data[0];
+    uint8_t n = data[1];
+    uint8_t i, at;
+    const uint8_t *e;
+
+    if (flags & INJECT_STOP) {
+        Inject_Reset();
+    }
+    if (n > INJECT_PER_COMMAND || n > INJECT_ENTRIES - count) {
+        return CMD_STATUS_RANGE;
+    }
+    for (i = 0, e = &data[2]; i < n; i++, e += 3) {
+        if (e[2] == 0) {
+            return CMD_STATUS_RANGE;
+        }
+    }
+
+    // SOFs come from USBDeviceTasks() in the same loop, so no lock
+    for (i = 0, e = &data[2]; i < n; i++, e += 3) {
+        at = (head + count) & (INJECT_ENTRIES - 1);
+        queueButtons[at] = e[0] | (uint16_t)e[1] << 8;
+        queueFrames[at] = e[2];
+        count++;
+    }
+    if (flags & INJECT_LAST) {
+        ending = true;
+    }
+    if ((flags & INJECT_START) && injectState == INJECT_IDLE) {
+        override = (flags & INJECT_OVERRIDE) != 0;
+        injectState = INJECT_ARMED;
+    }
+
+    memset(data, 0, CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+    data[0] = INJECT_ENTRIES - count;
+    data[1] = injectState;
+    data[2] = (uint8_t)played;
+    data[3] = (uint8_t)(played >> 8);
+    return CMD_STATUS_OK;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   inject.h
+ * Button states sent by the host and played back one USB frame at a
+ * time, for latency tests of games and for demos.
+ *
+ * The host queues entries with CMD_INJECT on the command endpoint
+ * (command.h): the buttons to press, in the layout of the history
+ * (HISTORY_BTN_*, history.h), and for how many frames. Playback starts
+ * at the SOF after a command with INJECT_START. From then on each SOF
+ * is one frame of the entry being played, and App_DeviceGamepadAct()
+ * ORs its buttons into the pins, or puts them in place of the pins with
+ * INJECT_OVERRIDE. A state is in the reports queued after its first
+ * SOF, for exactly as many frames as the entry asks.
+ *
+ * The queue holds INJECT_ENTRIES; each answer tells the host how many
+ * are free, so a long sequence streams in while it plays. It ends after
+ * the entries of a command with INJECT_LAST; INJECT_STOP ends it at
+ * once.
+ *   underrun   the queue ran dry before INJECT_LAST: the last state is
+ *              held and every frame of it counts, and the entries that
+ *              come later play that much late
+ *   slip       the frame number went on by more than one between two
+ *              SOF events, as when a long task held up the USB service:
+ *              the missed frames are played on, unseen, so the entries
+ *              stay on the bus's frames
+ * Both are counted in the telemetry (telemetry.h); a test run is frame
+ * exact when they did not move.
+ *
+ * The chords and the history see the pins only.
+ *
+ * Data of CMD_INJECT:
+ *   0      INJECT_* flags
+ *   1      entries that follow, up to INJECT_PER_COMMAND
+ *   2-     entries, 3 bytes each: buttons (2, little endian), frames
+ *          (1-255)
+ * and of its answer:
+ *   0      free entries in the queue, after these
+ *   1      state, INJECT_IDLE/ARMED/PLAYING
+ *   2-3    frames played since the start
+ * A command with more entries than are free, or an entry of 0 frames,
+ * is answered CMD_STATUS_RANGE and queues nothing.
+ */
+
+#ifndef INJECT_H
+#define INJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INJECT_ENTRIES          32      // a power of two; 96 bytes of RAM
+#define INJECT_PER_COMMAND      19
+#define INJECT_DATA_SIZE        (2 + 3 * INJECT_PER_COMMAND)
+
+/* flags of CMD_INJECT */
+#define INJECT_START            0x01    // play from the next SOF on
+#define INJECT_OVERRIDE         0x02    // the pins do not count while playing
+#define INJECT_LAST             0x04    // the sequence ends with these entries
+#define INJECT_STOP             0x08    // drop the queue and stop, first
+
+#define INJECT_IDLE             0
+#define INJECT_ARMED            1       // INJECT_START came, waiting for a SOF
+#define INJECT_PLAYING          2
+
+extern uint8_t injectState;
+
+/* read by App_DeviceGamepadAct(): the buttons played now, 0 when idle,
+   and whether the pins are left out */
+extern uint16_t injectButtons;
+extern bool injectOverride;
+
+/**
+ * One SOF; cheap while nothing is queued
+ */
+#define INJECT_Sof()                                    \
+    do {                                                \
+        if (injectState != INJECT_IDLE) {               \
+            Inject_Sof();                               \
+        }                                               \
+    } while (0)
+
+/**
+ * Stop and empty the queue; at SET_CONFIGURATION and at a suspend
+ */
+void Inject_Reset(void);
+
+/**
+ * Play one frame; see INJECT_Sof()
+ */
+void Inject_Sof(void);
+
+/**
+ * Handle CMD_INJECT
+ * @param data the command's data in, the answer's out
+ * @return CMD_STATUS_*
+ */
+uint8_t Inject_Command(uint8_t *data);
+
+#endif /* INJECT_H */
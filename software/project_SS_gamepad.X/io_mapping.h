@@ -29,3 +29,8 @@ limitations under the License.
 #define BUTTON_RIGHT    PORTBbits.RB4
 #define BUTTON_DOWN     PORTCbits.RC2
 #define BUTTON_TL       PORTCbits.RC1
+
+/* the same buttons per port, for code that reads a whole port */
+#define PORTA_BUTTONS   0x30            // RA4 TR, RA5 X
+#define PORTB_BUTTONS   0xF0            // RB4-RB7 RIGHT, UP, LEFT, START
+#define PORTC_BUTTONS   0xFE            // RC1-RC7, no interrupt-on-change
@@ -0,0 +1,83 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "mapping.h"
+#include "history.h"
+#include "inject.h"
+#include "keyboard.h"
+
+/* the last report queued; the USB module reads it from its own RAM */
+#if defined(FIXED_ADDRESS_MEMORY) && defined(__XC8)
+    static uint8_t keyboardReport[KEYBOARD_REPORT_SIZE] KEYBOARD_DATA_ADDRESS;
+#else
+    static uint8_t keyboardReport[KEYBOARD_REPORT_SIZE];
+#endif
+
+static USB_VOLATILE USB_HANDLE keyboardTransmission;
+static bool sent;                       // keyboardReport went out since the configuration
+
+/* the buttons in the order of the keycodes (mapping.h) */
+static const uint16_t keyButtons[MAP_KEYS] = {
+    HISTORY_BTN_A, HISTORY_BTN_B, HISTORY_BTN_C,
+    HISTORY_BTN_X, HISTORY_BTN_Y, HISTORY_BTN_Z,
+    HISTORY_BTN_TL, HISTORY_BTN_TR, HISTORY_BTN_START,
+    HISTORY_BTN_UP, HISTORY_BTN_DOWN, HISTORY_BTN_LEFT, HISTORY_BTN_RIGHT,
+};
+
+void Keyboard_Initialize(void)
+{
+    keyboardTransmission = 0;
+    sent = false;
+    USBEnableEndpoint(KEYBOARD_EP, USB_IN_ENABLED|USB_HANDSHAKE_ENABLED|USB_DISALLOW_SETUP);
+}
+
+void Keyboard_Build(uint8_t *report)
+{
+    uint16_t buttons = injectButtons;
+    uint8_t i;
+
+    // the same buttons App_DeviceGamepadAct() reads
+    if (!injectOverride) {
+        buttons |= History_ReadButtons();
+    }
+    memset(report, 0, KEYBOARD_REPORT_SIZE);
+    for (i = 0; i < MAP_KEYS; i++) {
+        if (buttons & keyButtons[i]) {
+            report[mappingKeyByte[i]] |= mappingKeyBit[i];  // a button without a key sets no bit
+        }
+    }
+}
+
+void Keyboard_Tasks(void)
+{
+    uint8_t report[KEYBOARD_REPORT_SIZE];
+
+    if (HIDTxHandleBusy(keyboardTransmission)) {
+        return;
+    }
+    Keyboard_Build(report);
+    if (sent && memcmp(report, keyboardReport, KEYBOARD_REPORT_SIZE) == 0) {
+        return;
+    }
+    memcpy(keyboardReport, report, KEYBOARD_REPORT_SIZE);
+    keyboardTransmission = HIDTxPacket(KEYBOARD_EP, keyboardReport, KEYBOARD_REPORT_SIZE);
+    sent = true;
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   keyboard.h
+ * The buttons as keys of an NKRO keyboard, on interface 2, for
+ * programs that only read the keyboard.
+ *
+ * Each of the MAP_KEYS buttons (mapping.h: A B C X Y Z L R START, then
+ * UP DOWN LEFT RIGHT) has a keycode of the Keyboard/Keypad page in the
+ * mapping, 0 for none. Until a host sets some (CMD_SET_KEYS, command.h,
+ * or bytes 40-52 of a version 2 mapping Feature report) they are all 0
+ * and the keyboard stays silent, so a pad used as a gamepad types
+ * nothing.
+ *
+ * Report, KEYBOARD_REPORT_SIZE bytes, one bit per key, any number of
+ * keys at once:
+ *   0      modifiers, keycodes 0xE0-0xE7
+ *   1-13   keycodes 0x00-0x67, keycode k at byte 1 + k / 8, bit k % 8
+ *
+ * The report goes out on KEYBOARD_EP (bInterval 1) when it changes,
+ * built right after the EP1 report of the same pass (SCHED_REPORT,
+ * scheduler.h) from the same buttons, pins and injection (inject.h)
+ * alike; EP1 goes first and does not wait for it.
+ */
+
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KEYBOARD_REPORT_SIZE    14
+
+/* keycodes a button can have, besides 0 */
+#define KEYBOARD_KEY_FIRST      0x04    // a
+#define KEYBOARD_KEY_LAST       0x67    // Keypad =
+#define KEYBOARD_MOD_FIRST      0xE0    // Left Control
+#define KEYBOARD_MOD_LAST       0xE7    // Right GUI
+
+#define KEYBOARD_Valid(k)   ((k) == 0                                               \
+                             || ((k) >= KEYBOARD_KEY_FIRST && (k) <= KEYBOARD_KEY_LAST) \
+                             || ((k) >= KEYBOARD_MOD_FIRST && (k) <= KEYBOARD_MOD_LAST))
+
+/**
+ * Enable KEYBOARD_EP; from APP_DeviceJoystickInitialize()
+ */
+void Keyboard_Initialize(void);
+
+/**
+ * Queue the report on KEYBOARD_EP if it changed and the host has taken
+ * the last one; after APP_DeviceJoystickTasks()
+ */
+void Keyboard_Tasks(void);
+
+/**
+ * The report as it is now, for GET_REPORT(Input) on interface 2
+ * @param report KEYBOARD_REPORT_SIZE bytes
+ */
+void Keyboard_Build(uint8_t *report);
+
+#endif /* KEYBOARD_H */
@@ -0,0 +1,179 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "io_mapping.h"
+#include "latency.h"
+#include "telemetry.h"
+
+#define BUCKET_TICKS    (LATENCY_BUCKET_US * 3 / 2)     // Timer1 runs at 1.5MHz
+
+volatile uint8_t latencyPending;
+uint8_t latencyInFlight;
+
+static volatile uint16_t pendingStart;
+static volatile uint8_t pendingEpoch;
+static uint16_t flightStart;
+static uint8_t flightEpoch;
+static uint8_t lastPortC;
+
+/* stamp an edge unless one is waiting; the epoch as Telemetry_Now() has
+   it, with a rollover Telemetry_LoopPass() has not counted yet. A macro,
+   so the interrupt routine calls no function the main loop calls too */
+#define STAMP()                                                 \
+    do {                                                        \
+        if (!latencyPending) {                                  \
+            TELEMETRY_ReadTimer1(pendingStart);                 \
+            pendingEpoch = telemetryEpoch;                      \
+            if (PIR1bits.TMR1IF && pendingStart < 0x8000) {     \
+                pendingEpoch++;                                 \
+            }                                                   \
+            latencyPending = 1;                                 \
+        }                                                       \
+    } while (0)
+
+/* shortest and longest in Timer1 ticks, converted when read */
+static struct {
+    uint16_t count;
+    uint16_t shortest;
+    uint16_t longest;
+    uint16_t bucket[LATENCY_BUCKETS];
+} hist;
+
+void Latency_Reset(void)
+{
+    memset(&hist, 0, sizeof(hist));
+    hist.shortest = 0xFFFF;
+}
+
+void Latency_Initialize(void)
+{
+    Latency_Reset();
+    latencyPending = 0;
+    latencyInFlight = 0;
+    lastPortC = PORTC & PORTC_BUTTONS;
+
+    // both edges; the flags alone wake the interrupt routine
+    IOCAP = PORTA_BUTTONS;
+    IOCAN = PORTA_BUTTONS;
+    IOCBP = PORTB_BUTTONS;
+    IOCBN = PORTB_BUTTONS;
+    IOCAF = 0;
+    IOCBF = 0;
+    INTCONbits.IOCIE = 1;
+}
+
+void Latency_Scan(void)
+{
+    uint8_t c = PORTC & PORTC_BUTTONS;
+    uint8_t gie;
+
+    if (c == lastPortC) {
+        return;
+    }
+    lastPortC = c;
+
+    gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;                 // the IOC handler stamps too
+    STAMP();
+    INTCONbits.GIE = gie;               // left off if the caller had it off
+}
+
+void Latency_InterruptOnChange(void)
+{
+    IOCAF = 0;
+    IOCBF = 0;
+    STAMP();
+}
+
+void Latency_Queue(void)
+{
+    // the IOC handler leaves pendingStart alone while latencyPending is set
+    flightStart = pendingStart;
+    flightEpoch = pendingEpoch;
+    latencyInFlight = 1;
+    latencyPending = 0;
+}
+
+void Latency_TransferComplete(void)
+{
+    uint16_t now, ticks, rest;
+    uint8_t epochs, b;
+
+    if (!latencyInFlight) {
+        return;
+    }
+    latencyInFlight = 0;
+
+    TELEMETRY_ReadTimer1(now);
+    epochs = telemetryEpoch - flightEpoch;
+    if (PIR1bits.TMR1IF) {
+        epochs++;                       // not yet counted by Telemetry_LoopPass()
+    }
+    if (epochs > 1 || (epochs == 1 && now >= flightStart)) {
+        ticks = 0xFFFF;
+    } else {
+        ticks = now - flightStart;
+    }
+
+    // once per report at most, so no division
+    b = 0;
+    rest = ticks;
+    while (b < LATENCY_BUCKETS - 1 && rest >= BUCKET_TICKS) {
+        rest -= BUCKET_TICKS;
+        b++;
+    }
+
+    if (hist.bucket[b] != 0xFFFF) {
+        hist.bucket[b]++;
+    }
+    if (hist.count != 0xFFFF) {
+        hist.count++;
+    }
+    if (ticks < hist.shortest) {
+        hist.shortest = ticks;
+    }
+    if (ticks > hist.longest) {
+        hist.longest = ticks;
+    }
+}
+
+static uint16_t ticksToUs(uint16_t ticks)
+{
+    if (ticks == 0xFFFF) {
+        return 0xFFFF;
+    }
+    return (uint16_t)(((uint32_t)ticks * 2) / 3);
+}
+
+void Latency_GetAsFeatureReport(uint8_t* featureReport)
+{
+    uint16_t v;
+
+    memset(featureReport, 0, LATENCY_REPORT_SIZE);
+    featureReport[0] = LATENCY_REPORT_ID;
+    featureReport[1] = LATENCY_VER;
+    featureReport[2] = LATENCY_BUCKETS;
+    featureReport[3] = LATENCY_BUCKET_US;
+    memcpy(&featureReport[4], &hist.count, sizeof(hist.count));
+    v = hist.count ? ticksToUs(hist.shortest) : 0;
+    memcpy(&featureReport[6], &v, sizeof(v));
+    v = ticksToUs(hist.longest);
+    memcpy(&featureReport[8], &v, sizeof(v));
+    memcpy(&featureReport[12], hist.bucket, sizeof(hist.bucket));
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   latency.h
+ * Input-to-USB latency measured by the pad itself.
+ *
+ * A button edge is timestamped with Timer1 (telemetry.h): in the
+ * interrupt-on-change handler for the PORTA/PORTB buttons, and by the
+ * scan at the top of the main loop for PORTC, which has no IOC. The
+ * first report queued after the edge carries it, and the measurement
+ * ends when USBDeviceTasks() handles the TRNIF of that EP1 IN transfer.
+ * Edges that come while one is waiting for its report are part of it.
+ *
+ * The histogram is Feature report LATENCY_REPORT_ID on interface 1.
+ * A SET_REPORT of that ID, with any data, clears it.
+ *   1      version (LATENCY_VER)
+ *   2      number of buckets (LATENCY_BUCKETS)
+ *   3      bucket width in us (LATENCY_BUCKET_US)
+ *   4-5    measurements
+ *   6-7    shortest, us
+ *   8-9    longest, us, 0xFFFF when 43 ms or more
+ *   10-11  reserved, 0
+ *   12-43  buckets, uint16_t each; the last one also counts everything
+ *          longer. Counts stop at 0xFFFF.
+ *   44-47  reserved, 0
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+#define LATENCY_REPORT_ID       0x03
+#define LATENCY_REPORT_SIZE     48      // including the report ID
+#define LATENCY_VER             0x01
+#define LATENCY_BUCKETS         16
+#define LATENCY_BUCKET_US       128
+
+/* edge waiting for a report, edge in the report on EP1 */
+extern volatile uint8_t latencyPending;
+extern uint8_t latencyInFlight;
+
+/**
+ * The report just queued on EP1 carries the pending edge, if there is
+ * one and the previous report has been seen complete
+ */
+#define LATENCY_ReportQueued()                          \
+    do {                                                \
+        if (latencyPending && !latencyInFlight) {       \
+            Latency_Queue();                            \
+        }                                               \
+    } while (0)
+
+/**
+ * Enable interrupt-on-change on the PORTA/PORTB buttons and clear the
+ * histogram. Telemetry_Initialize() must have started Timer1.
+ */
+void Latency_Initialize(void);
+
+/**
+ * Clear the histogram
+ */
+void Latency_Reset(void);
+
+/**
+ * Timestamp a change of the PORTC buttons; call once per main-loop pass
+ */
+void Latency_Scan(void);
+
+/**
+ * Interrupt-on-change handler, from the interrupt routine
+ */
+void Latency_InterruptOnChange(void);
+
+/**
+ * Move the pending edge to the report in flight, for LATENCY_ReportQueued()
+ */
+void Latency_Queue(void);
+
+/**
+ * TRNIF of an EP1 IN transfer was handled; ends the measurement in flight
+ */
+void Latency_TransferComplete(void);
+
+/**
+ * Copy the histogram to the Feature Report buffer
+ * @param featureReport at least LATENCY_REPORT_SIZE bytes
+ */
+void Latency_GetAsFeatureReport(uint8_t* featureReport);
+
+#endif /* LATENCY_H */
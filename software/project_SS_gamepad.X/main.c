@@ -21,6 +21,13 @@ please contact mla_licensing@microchip.com
  * 
  * Changes from the original source:
  *     - added device settings
+ *     - telemetry counters
+ *     - latency measurement
+ *     - restart into the bootloader on request
+ *     - GPIO, mapping and a first scan before attaching to the bus
+ *     - configuration commands on the interrupt endpoints
+ *     - sleep and remote wakeup while suspended
+ *     - the loop body moved to a scheduler with task budgets
  ********************************************************************/
 
 /** INCLUDES *******************************************************/
@@ -30,19 +37,23 @@ please contact mla_licensing@microchip.com
 #include "usb_device_hid.h"
 
 #include "app_device_joystick.h"
+#include "my_app_device_gamepad.h"
 #include "mapping.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "history.h"
+#include "code_map.h"
+#include "scheduler.h"
 
 
 
-MAIN_RETURN main(void)
+HOT_PATH MAIN_RETURN main(void)
 {
     SYSTEM_Initialize(SYSTEM_STATE_USB_START);
 
-    USBDeviceInit();
-    USBDeviceAttach();
-    
-    // Load button-to-usage mapping from High-Endurance Flash
-    Mapping_Load();
+    // Timer1 and the counters read through the interface 1 Feature report;
+    // first, so the boot times in it count from here
+    Telemetry_Initialize();
 
     /* set all ports input*/
     TRISA = 0x30;
@@ -59,68 +70,33 @@ MAIN_RETURN main(void)
     ANSELB = 0x00;
     ANSELC = 0x00;
     
-    /* initializing timer0 and interruption*/
-    
-    OPTION_REGbits.PS = 0b111;        // clock divided by 256
-    OPTION_REGbits.PSA = 0;         // enabling prescaler
-    OPTION_REGbits.TMR0SE = 0;      // edge select (rise)
-    OPTION_REGbits.TMR0CS = 0;      // clock source select (internal)
-    OPTION_REGbits.INTEDG = 1;      // interrupt edge select (rise)
-//    INTCONbits.TMR0IF = 0;          // reset timer0 interrupt flag
-//    INTCONbits.TMR0IE = 1;          // enabling peripheral interrupts
+    // Load button-to-usage mapping from High-Endurance Flash; this also
+    // builds the button masks the report uses. The pull-ups settle meanwhile.
+    Mapping_Load();
+
+    // timestamps button edges for the latency histogram, from the pins as
+    // they are now
+    Latency_Initialize();
+    // and every change of them, with its time, for the host to read back
+    History_Initialize();
+
+    // Everything the first report needs is ready before the host can see
+    // us: the pins are digital with their pull-ups, and joystick_input
+    // already holds the buttons as they are.
+    App_DeviceGamepadInit();
+    App_DeviceGamepadAct(&joystick_input);
+
+    USBDeviceInit();
+    USBDeviceAttach();
+    TELEMETRY_Boot(telemetry.bootAttach);
+
     INTCONbits.GIE = 1;             // enabling interrupts
-    
-    // setting initial value of timer 0.
-    // 1 clock = 256/16MHz = 16us 
-    // the timer interrupt happens every 16us x 0xff(255) = 4080us .
-    // 
-    // set the timer0 value so that timer interruption happens every 4000us.
-    // 80us / 16us = 5 clocks
-    TMR0bits.TMR0 = (uint8_t)5;
-    
-    
+
+    // the tasks, their budgets and periods: scheduler.h
     while(1)
     {
         SYSTEM_Tasks();
-
-        #if defined(USB_POLLING)
-            // Interrupt or polling method.  If using polling, must call
-            // this function periodically.  This function will take care
-            // of processing and responding to SETUP transactions
-            // (such as during the enumeration process when you first
-            // plug in).  USB hosts require that USB devices should accept
-            // and process SETUP packets in a timely fashion.  Therefore,
-            // when using polling, this function should be called
-            // regularly (such as once every 1.8ms or faster** [see
-            // inline code comments in usb_device.c for explanation when
-            // "or faster" applies])  In most cases, the USBDeviceTasks()
-            // function does not take very long to execute (ex: <100
-            // instruction cycles) before it returns.
-            USBDeviceTasks();
-        #endif
-
-        /* If the USB device isn't configured yet, we can't really do anything
-         * else since we don't have a host to talk to.  So jump back to the
-         * top of the while loop. */
-        if( USBGetDeviceState() < CONFIGURED_STATE )
-        {
-            /* Jump back to the top of the while loop. */
-            continue;
-        }
-
-        /* If we are currently suspended, then we need to see if we need to
-         * issue a remote wakeup.  In either case, we shouldn't process any
-         * keyboard commands since we aren't currently communicating to the host
-         * thus just continue back to the start of the while loop. */
-        if( USBIsDeviceSuspended() == true )
-        {
-            /* Jump back to the top of the while loop. */
-            continue;
-        }
-
-        //Application specific tasks
-        APP_DeviceJoystickTasks();
-
+        Scheduler_Tasks();
     }//end while
 }//end main
 
@@ -10,59 +10,138 @@ Mapping functionality for button-to-usage configuration
 #include <string.h>
 // NVM ドライバを使う
 #include "mcc_generated_files/nvm/nvm.h"
+#include "usb.h"
 #include "demo_src/hid_rpt_map.h"
+#include "telemetry.h"
+#include "ram_map.h"
+#include "keyboard.h"
 
-/* RAM working copy of the mapping data */
-static struct {
-    // Bytes 0-7: Global settings
-    uint8_t report_id;                // Report ID (Feature Report送信時に0x00設定)
-    uint8_t ver;                      // Version for compatibility checking
-    uint8_t crc;                      // CRC8 checksum for data integrity
-    uint8_t global_reserved[5];       // Reserved for future global settings
-    
-    // Bytes 8-23: Normal mode mapping (16 bytes)
-    uint8_t normal_tbl[NUM_BUTTONS];  // Normal mode button-to-usage mapping table (9 bytes)
-    uint8_t normal_reserved[7];       // Reserved for normal mode expansion
-    
-    // Bytes 24-39: Special mode mapping (16 bytes)
-    uint8_t special_tbl[NUM_BUTTONS]; // Special mode button-to-usage mapping table (9 bytes)
-    uint8_t special_reserved[7];      // Reserved for special mode expansion
-    
-    // Bytes 40-63: Future expansion (24 bytes)
-    uint8_t future_reserved[24];      // Reserved for future features
-} map ;            
+/*
+ * Image of the mapping in flash and in the Feature report (64 bytes):
+ *   Bytes 0-7:   Global settings (report ID, version, CRC8, reserved)
+ *   Bytes 8-23:  Normal mode mapping, NUM_BUTTONS used
+ *   Bytes 24-39: Special mode mapping, NUM_BUTTONS used
+ *   Bytes 40-52: Keyboard keycode per button, MAP_KEYS (keyboard.h), from
+ *                version 2 on; version 1 images had zeros here, and load
+ *                with no keys
+ *   Bytes 53-63: Future expansion
+ * Only the tables and the CRC are kept in RAM; the reserved bytes are 0
+ * and the image is put together byte by byte where it is needed.
+ */
+#define MAP_SIZE        64
+#define OFS_VER         1
+#define OFS_CRC         2
+#define OFS_NORMAL      8
+#define OFS_SPECIAL     24
+#define OFS_KEYS        40
+
+static uint8_t normal_tbl[NUM_BUTTONS];     // Normal mode button-to-usage mapping table
+static uint8_t special_tbl[NUM_BUTTONS];    // Special mode button-to-usage mapping table
+static uint8_t key_tbl[MAP_KEYS];          // Keyboard keycode per button, 0 for none
+static uint8_t map_crc;
 
-#define MAP_VER 0x01           // Current data structure version
+/* Mapping_CommitTasks(): erase then write each row, one step per call */
+#define COMMIT_NONE     0xFF
+static uint8_t commit_step = COMMIT_NONE;
+
+#define MAP_VER 0x02           // Current data structure version
+#define MAP_VER_KEYS 0x02      // the first version with the keycodes
+#define MAP_VER_OLDEST 0x01    // still loaded from flash
 #define HEF_ADDR 0x1F80        // High-Endurance Flash starting address (row0)
 
 #define ROW_WORDS   32                  // 64B / 2B
-static flash_data_t rowBuf[ROW_WORDS];  // uint16_t[32]
+#define MAP_ROWS    (MAP_SIZE / ROW_WORDS)  // one byte per word: 2 rows
+RAM_CHECK(mapRow, sizeof(configArena.row) == ROW_WORDS * sizeof(flash_data_t));
+
+#if defined(FIXED_ADDRESS_MEMORY) && defined(__XC8)
+    uint16_t mappingMask[2][NUM_BUTTONS] MAPPING_MASK_ADDRESS;
+#else
+    uint16_t mappingMask[2][NUM_BUTTONS];
+#endif
+uint8_t mappingKeyByte[MAP_KEYS];
+uint8_t mappingKeyBit[MAP_KEYS];
 
 /**
- * Calculate CRC8 checksum (0x07 polynomial)
- * @param d Pointer to data
- * @param l Data length in bytes
+ * Add one byte to a CRC8 checksum (0x07 polynomial)
+ * @param c CRC so far, 0 to start
+ * @param d Data byte
  * @return CRC8 checksum
  */
-static uint8_t crc8(const uint8_t *d, uint8_t l) {
+static uint8_t crc8(uint8_t c, uint8_t d) {
+    c ^= d;
+    for (uint8_t i = 0; i < 8; i++) {
+        c = (uint8_t)((c & 0x80) ? ((c << 1) ^ 0x07) : (c << 1));
+    }
+    return c;
+}
+
+/**
+ * Byte i of the image; the report ID byte is 0 as in flash
+ */
+static uint8_t imageByte(uint8_t i) {
+    if (i == OFS_VER) {
+        return MAP_VER;
+    }
+    if (i == OFS_CRC) {
+        return map_crc;
+    }
+    if (i >= OFS_NORMAL && i < OFS_NORMAL + NUM_BUTTONS) {
+        return normal_tbl[i - OFS_NORMAL];
+    }
+    if (i >= OFS_SPECIAL && i < OFS_SPECIAL + NUM_BUTTONS) {
+        return special_tbl[i - OFS_SPECIAL];
+    }
+    if (i >= OFS_KEYS && i < OFS_KEYS + MAP_KEYS) {
+        return key_tbl[i - OFS_KEYS];
+    }
+    return 0;
+}
+
+/**
+ * CRC8 of the image up to its last byte, with the CRC byte taken as 0
+ */
+static uint8_t imageCrc(void) {
     uint8_t c = 0;
-    while (l--) {
-        c ^= *d++;
-        for (uint8_t i = 0; i < 8; i++) {
-            c = (uint8_t)((c & 0x80) ? ((c << 1) ^ 0x07) : (c << 1));
-        }
+    for (uint8_t i = 0; i < MAP_SIZE - 1; i++) {
+        c = crc8(c, i == OFS_CRC ? 0 : imageByte(i));
     }
     return c;
 }
 
-void map_to_rowbuf(void)
-{
-    /* 0x3FFF で初期化（未使用上位バイトは 0x3F） */
-    for (uint8_t i = 0; i < ROW_WORDS; i++) rowBuf[i] = 0x3FFF;
+/**
+ * Turn the usage tables into mappingMask, and the keycodes into their
+ * place in the keyboard report; usages outside 1-14 and keycodes that
+ * are not keys set no bit
+ */
+static void compileMasks(void) {
+    for (uint8_t i = 0; i < NUM_BUTTONS; i++) {
+        uint8_t n = normal_tbl[i];
+        uint8_t s = special_tbl[i];
+        mappingMask[0][i] = (n >= 1 && n <= 14) ? (uint16_t)(1u << (n - 1)) : 0;
+        mappingMask[1][i] = (s >= 1 && s <= 14) ? (uint16_t)(1u << (s - 1)) : 0;
+    }
+    for (uint8_t i = 0; i < MAP_KEYS; i++) {
+        uint8_t k = key_tbl[i];
+        mappingKeyByte[i] = 0;
+        mappingKeyBit[i] = 0;
+        if (k >= KEYBOARD_MOD_FIRST && k <= KEYBOARD_MOD_LAST) {
+            mappingKeyBit[i] = (uint8_t)(1u << (k - KEYBOARD_MOD_FIRST));
+        } else if (k >= KEYBOARD_KEY_FIRST && k <= KEYBOARD_KEY_LAST) {
+            mappingKeyByte[i] = 1 + (k >> 3);
+            mappingKeyBit[i] = (uint8_t)(1u << (k & 7));
+        }
+    }
+}
 
-    /* uint8_t map 構造体をuint16_t rowBufにコピー */
-    for (uint8_t b = 0; b < sizeof(map); b++) {
-        rowBuf[b] = 0x3F00 | ((uint8_t*) &map)[b]; 
+/**
+ * Put one row (32 bytes) of the image into configArena for the flash write
+ * @param row Row of the mapping data (0 or 1)
+ */
+static void map_to_rowbuf(uint8_t row)
+{
+    /* 1ワード1バイト、上位バイトは 0x3F */
+    for (uint8_t b = 0; b < ROW_WORDS; b++) {
+        configArena.row[b] = 0x3F00 | imageByte((uint8_t)(row * ROW_WORDS + b));
     }
 }
 
@@ -71,79 +150,130 @@ void map_to_rowbuf(void)
  * If invalid data detected, initialize with default mapping
  */
 void Mapping_Load(void) {
-    // Read mapping data from flash to RAM via FLASH_Read
-    for(uint8_t i = 0; i < sizeof(map); i ++){
-        // Read 14-bit words from flash and convert to 8-bit
-        flash_data_t data = FLASH_Read(HEF_ADDR + i);
-        ((uint8_t*)&map)[i] = (uint8_t)(data & 0x00FF); // Use lower byte
+    // Read the image from flash, 14-bit words to 8-bit, and check it on the way
+    uint8_t ver = 0, crc = 0, c = 0;
+    for (uint8_t i = 0; i < MAP_SIZE; i++) {
+        uint8_t d = (uint8_t)(FLASH_Read(HEF_ADDR + i) & 0x00FF);  // Use lower byte
+        if (i == OFS_VER) {
+            ver = d;
+        } else if (i == OFS_CRC) {
+            crc = d;
+            d = 0;                  // the CRC is taken with its own byte as 0
+        } else if (i >= OFS_NORMAL && i < OFS_NORMAL + NUM_BUTTONS) {
+            normal_tbl[i - OFS_NORMAL] = d;
+        } else if (i >= OFS_SPECIAL && i < OFS_SPECIAL + NUM_BUTTONS) {
+            special_tbl[i - OFS_SPECIAL] = d;
+        } else if (i >= OFS_KEYS && i < OFS_KEYS + MAP_KEYS) {
+            key_tbl[i - OFS_KEYS] = d;
+        }
+        if (i < MAP_SIZE - 1) {
+            c = crc8(c, d);
+        }
     }
-    
-    // Validate data (version and CRC)
-    if (map.ver != MAP_VER || map.crc != crc8((uint8_t*)&map, sizeof(map) - 1)) {
+
+    // Validate data (version and CRC); an older image is taken as it is,
+    // and saved as this version with the next change
+    if (ver < MAP_VER_OLDEST || ver > MAP_VER || crc != c) {
         // Invalid data, initialize with standardized default mapping
         
         // Normal mode mapping (A=1, B=2, ..., Start=9)
-        map.normal_tbl[0] = 1;  // A -> Button 1
-        map.normal_tbl[1] = 2;  // B -> Button 2
-        map.normal_tbl[2] = 3;  // C -> Button 3
-        map.normal_tbl[3] = 4;  // X -> Button 4
-        map.normal_tbl[4] = 5;  // Y -> Button 5
-        map.normal_tbl[5] = 6;  // Z -> Button 6
-        map.normal_tbl[6] = 7;  // L -> Button 7
-        map.normal_tbl[7] = 8;  // R -> Button 8
-        map.normal_tbl[8] = 9;  // Start -> Button 9
+        normal_tbl[0] = 1;  // A -> Button 1
+        normal_tbl[1] = 2;  // B -> Button 2
+        normal_tbl[2] = 3;  // C -> Button 3
+        normal_tbl[3] = 4;  // X -> Button 4
+        normal_tbl[4] = 5;  // Y -> Button 5
+        normal_tbl[5] = 6;  // Z -> Button 6
+        normal_tbl[6] = 7;  // L -> Button 7
+        normal_tbl[7] = 8;  // R -> Button 8
+        normal_tbl[8] = 9;  // Start -> Button 9
         
         // Special mode mapping (same as normal initially)
-        map.special_tbl[0] = 1;  // A -> Button 1
-        map.special_tbl[1] = 2;  // B -> Button 2
-        map.special_tbl[2] = 3;  // C -> Button 3
-        map.special_tbl[3] = 13;  // X -> Button 13
-        map.special_tbl[4] = 14;  // Y -> Button 14
-        map.special_tbl[5] = 12;  // Z -> Button 12
-        map.special_tbl[6] = 10;  // L -> Button 10
-        map.special_tbl[7] = 11;  // R -> Button 11
-        map.special_tbl[8] = 9;  // Start -> Button 9
-        
-        // Clear all reserved areas
-        map.report_id = 0x00;  // Initialize report ID
-        memset(map.global_reserved, 0, sizeof(map.global_reserved));
-        memset(map.normal_reserved, 0, sizeof(map.normal_reserved));
-        memset(map.special_reserved, 0, sizeof(map.special_reserved));
-        memset(map.future_reserved, 0, sizeof(map.future_reserved));
+        special_tbl[0] = 1;  // A -> Button 1
+        special_tbl[1] = 2;  // B -> Button 2
+        special_tbl[2] = 3;  // C -> Button 3
+        special_tbl[3] = 13;  // X -> Button 13
+        special_tbl[4] = 14;  // Y -> Button 14
+        special_tbl[5] = 12;  // Z -> Button 12
+        special_tbl[6] = 10;  // L -> Button 10
+        special_tbl[7] = 11;  // R -> Button 11
+        special_tbl[8] = 9;  // Start -> Button 9
 
-        map.ver = MAP_VER;  // Set version
-        map.crc = crc8((uint8_t*)&map, sizeof(map) - 1); // Calculate CRC
+        // No keys: the keyboard stays silent until a host gives it some
+        memset(key_tbl, 0, MAP_KEYS);
+    } else if (ver < MAP_VER_KEYS) {
+        memset(key_tbl, 0, MAP_KEYS);   // reserved bytes then
     }
+    // the reserved bytes read back as 0 from here on
+    map_crc = imageCrc();
+    compileMasks();
 }
 
 /**
- * Save mapping from RAM to High-Endurance Flash
- * @param normal_tbl Pointer to normal mode button-to-usage mapping table
- * @param special_tbl Pointer to special mode button-to-usage mapping table
+ * Take a new mapping into use; it goes to High-Endurance Flash in the
+ * following calls of Mapping_CommitTasks()
+ * @param normal Pointer to normal mode button-to-usage mapping table
+ * @param special Pointer to special mode button-to-usage mapping table
+ * @param keys Pointer to the keycode table
+ * A table given as NULL stays as it is.
  */
-void Mapping_Save(const uint8_t *normal_tbl, const uint8_t *special_tbl) {
-    // Copy new mapping tables to RAM structure
-    memcpy(map.normal_tbl, normal_tbl, NUM_BUTTONS);
-    memcpy(map.special_tbl, special_tbl, NUM_BUTTONS);
-    
-    // Update version and CRC, ensure report ID is set
-    map.report_id = 0x00;  // Set report ID
-    map.ver = MAP_VER;
-    map.crc = crc8((uint8_t*)&map, sizeof(map) - 1);
-    
-    // Convert map structure to row buffer for flash write
-    map_to_rowbuf();
+void Mapping_Save(const uint8_t *normal, const uint8_t *special, const uint8_t *keys) {
+    // Copy new mapping tables and update the CRC
+    if (normal != NULL) {
+        memcpy(normal_tbl, normal, NUM_BUTTONS);
+    }
+    if (special != NULL) {
+        memcpy(special_tbl, special, NUM_BUTTONS);
+    }
+    if (keys != NULL) {
+        memcpy(key_tbl, keys, MAP_KEYS);
+    }
+    map_crc = imageCrc();
+    compileMasks();
+
+    // a commit on its way starts over, so the flash ends up with this one
+    commit_step = 0;
+}
+
+/**
+ * One step of the flash write: erase a row, or write it from the tables.
+ * The core stalls for the step, about 2 ms (scheduler.h).
+ */
+void Mapping_CommitTasks(void) {
+    uint8_t row = commit_step >> 1;
+    uint16_t addr = HEF_ADDR + row * ROW_WORDS;
 
-    // Save to flash via FLASH_RowWrite
+    if (commit_step == COMMIT_NONE) {
+        return;
+    }
+    // the write goes out through configArena: not under an EP0 data stage
+    if ((commit_step & 1) && ConfigArena_Busy()) {
+        return;
+    }
+    if (commit_step & 1) {
+        map_to_rowbuf(row);         // Put the row of the image into configArena for flash write
+    }
+
+    // Save to flash via FLASH_RowWrite, one byte per word: the map takes two rows
     uint8_t gie = INTCONbits.GIE;
     INTCONbits.GIE = 0;
     NVM_UnlockKeySet(UNLOCK_KEY);
-    FLASH_PageErase(HEF_ADDR);  // Erase the page before writing
-    while(NVM_IsBusy());  // Wait for erase to complete
-    FLASH_RowWrite(HEF_ADDR, rowBuf);    // Write the row buffer to flash
-    while(NVM_IsBusy());     
+    if (commit_step & 1) {
+        FLASH_RowWrite(addr, configArena.row);  // Write the row buffer to flash
+    } else {
+        FLASH_PageErase(addr);      // Erase the page before writing
+    }
+    while(NVM_IsBusy());
     NVM_UnlockKeyClear();
     INTCONbits.GIE = gie;
+
+    if (++commit_step == 2 * MAP_ROWS) {
+        commit_step = COMMIT_NONE;
+        TELEMETRY_FlashCommit();
+    }
+}
+
+bool Mapping_CommitPending(void) {
+    return commit_step != COMMIT_NONE;
 }
 
 /**
@@ -154,12 +284,21 @@ void Mapping_Save(const uint8_t *normal_tbl, const uint8_t *special_tbl) {
  */
 uint8_t Mapping_GetUsage(uint8_t physBtn, uint8_t mode) {
     if (mode == 0) {
-        return map.normal_tbl[physBtn];
+        return normal_tbl[physBtn];
     } else {
-        return map.special_tbl[physBtn];
+        return special_tbl[physBtn];
     }
 }
 
+/**
+ * Get the keyboard keycode of a button
+ * @param key Button index (0-12)
+ * @return Keycode
+ */
+uint8_t Mapping_GetKey(uint8_t key) {
+    return key_tbl[key];
+}
+
 /**
  * Copy mapping data from Feature Report buffer to the mapping table
  * @param featureReport The feature report buffer received from the host
@@ -167,7 +306,8 @@ uint8_t Mapping_GetUsage(uint8_t physBtn, uint8_t mode) {
  */
 void Mapping_SetFromFeatureReport(uint8_t* featureReport, uint16_t length) {
     // Feature report structure: [Report ID + 63 bytes data] = 64 bytes total
-    // Byte 0: Report ID, Byte 1: version, Byte 2: crc, Byte 8-16: normal, Byte 24-32: special
+    // Byte 0: Report ID, Byte 1: version, Byte 2: crc, Byte 8-16: normal, Byte 24-32: special,
+    // Byte 40-52: keycodes (version 2 on)
     
     // Ensure we have enough data for complete structure
     if (length < 64) {
@@ -187,8 +327,21 @@ void Mapping_SetFromFeatureReport(uint8_t* featureReport, uint16_t length) {
         newSpecialMapping[i] = featureReport[24 + i];
     }
     
-    // Save both mapping tables to flash
-    Mapping_Save(newNormalMapping, newSpecialMapping);
+    // Keycodes only from a host that knows the layout with them, and all
+    // of them keys; otherwise the keys stay as they are
+    const uint8_t *keys = NULL;
+    if (featureReport[OFS_VER] >= MAP_VER_KEYS) {
+        keys = &featureReport[OFS_KEYS];
+        for (uint8_t i = 0; i < MAP_KEYS; i++) {
+            if (!KEYBOARD_Valid(keys[i])) {
+                keys = NULL;
+                break;
+            }
+        }
+    }
+
+    // Save both mapping tables, and the keycodes if taken, to flash
+    Mapping_Save(newNormalMapping, newSpecialMapping, keys);
 }
 
 /**
@@ -196,9 +349,11 @@ void Mapping_SetFromFeatureReport(uint8_t* featureReport, uint16_t length) {
  * @param featureReport The feature report buffer to be sent to the host
  */
 void Mapping_GetAsFeatureReport(uint8_t* featureReport) {
-    // Copy entire map structure (64 bytes) directly
-    memcpy(featureReport, &map, sizeof(map));
+    // Put the whole image (64 bytes) together
+    for (uint8_t i = 0; i < MAP_SIZE; i++) {
+        featureReport[i] = imageByte(i);
+    }
     
     // Ensure Report ID is set correctly
-    featureReport[0] = 0x00;  // Report ID 0
+    featureReport[0] = MAP_REPORT_ID;
 }
@@ -8,14 +8,26 @@ Mapping functionality for button-to-usage configuration
 #define _MAPPING_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #define NUM_BUTTONS 9
+#define MAP_KEYS    13         // NUM_BUTTONS, then UP DOWN LEFT RIGHT (keyboard.h)
+#define MAP_REPORT_ID 0x01     // Feature report ID of the mapping on interface 1
 
+/**
+ * Button bits of the gamepad report for each physical button, per mode:
+ * usage n (1-14) is bit n-1, 0 for no usage. Rebuilt from the table
+ * whenever it is loaded or saved, so the report path needs no lookup.
+ */
+extern uint16_t mappingMask[2][NUM_BUTTONS];
 
 /**
- * convert mapping data structure to row buffer for flash write
+ * Byte of the keyboard report and bit in it for each button's keycode,
+ * bit 0 for none; rebuilt with mappingMask
  */
-void map_to_rowbuf(void);
+extern uint8_t mappingKeyByte[MAP_KEYS];
+extern uint8_t mappingKeyBit[MAP_KEYS];
+
 
 /**
  * Load mapping from High-Endurance Flash to RAM
@@ -23,11 +35,27 @@ void map_to_rowbuf(void);
 void Mapping_Load(void);
 
 /**
- * Save mapping from RAM to High-Endurance Flash
- * @param normal_tbl Pointer to normal mode button-to-usage mapping table (at least NUM_BUTTONS bytes)
- * @param special_tbl Pointer to special mode button-to-usage mapping table (at least NUM_BUTTONS bytes)
+ * Take a new mapping into use at once and have Mapping_CommitTasks()
+ * save it to High-Endurance Flash; a save while one is on its way
+ * starts the flash write over
+ * @param normal Pointer to normal mode button-to-usage mapping table (at least NUM_BUTTONS bytes)
+ * @param special Pointer to special mode button-to-usage mapping table (at least NUM_BUTTONS bytes)
+ * @param keys Keycode per button (MAP_KEYS bytes)
+ * A table given as NULL stays as it is.
+ */
+void Mapping_Save(const uint8_t *normal, const uint8_t *special, const uint8_t *keys);
+
+/**
+ * Write a saved mapping to flash, one row erase or row write per call
+ * (SCHED_FLASH, scheduler.h); the rows go out through configArena
+ * (ram_map.h), so a write waits while an EP0 data stage uses it
  */
-void Mapping_Save(const uint8_t *normal_tbl, const uint8_t *special_tbl);
+void Mapping_CommitTasks(void);
+
+/**
+ * Whether a saved mapping has not reached the flash yet
+ */
+bool Mapping_CommitPending(void);
 
 /**
  * Get the usage value for a physical button
@@ -37,6 +65,13 @@ void Mapping_Save(const uint8_t *normal_tbl, const uint8_t *special_tbl);
  */
 uint8_t Mapping_GetUsage(uint8_t physBtn, uint8_t mode);
 
+/**
+ * Get the keyboard keycode of a button
+ * @param key Button index (0-12, MAP_KEYS)
+ * @return Keycode, 0 for none
+ */
+uint8_t Mapping_GetKey(uint8_t key);
+
 /**
  * Copy mapping data from Feature Report buffer to the mapping table
  * @param featureReport The feature report buffer received from the host
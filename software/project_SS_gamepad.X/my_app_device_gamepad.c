@@ -23,7 +23,11 @@ limitations under the License.
 #include "usb.h"
 #include "usb_device_hid.h"
 #include "mapping.h"
+#include "telemetry.h"
+#include "history.h"
+#include "inject.h"
 #include "hid_rpt_map.h"
+#include "code_map.h"
 #include "usb_framework/inc/usb_ch9.h"
 #include "usb_framework/inc/usb_device.h"
 
@@ -34,74 +38,17 @@ typedef struct _Flags{
 } Flags;
 
 
-Flags flags;
-
-/* ----------------------------------------------------------------------------
-   mapping.h などで定義済み
-   NUM_BUTTONS = 14
-   BUTTON_* 列挙体は 0..13 の物理ボタン番号に対応している想定
----------------------------------------------------------------------------- */
-
-/* ────────────────────────────────────────────────────────────────────────────
-   usageByte[usage]: 
-     usage (1–14) が INPUT_CONTROLS.val[] の何バイト目に対応するか
-   ──────────────────────────────────────────────────────────────────────────── */
-static const uint8_t usageByte[15] = {
-    /*  0: 未使用 (無効) */  0,
-    /*  1: A            */  0,    // val[0].bit0
-    /*  2: B            */  0,    // val[0].bit1
-    /*  3: C            */  0,    // val[0].bit2
-    /*  4: X            */  0,    // val[0].bit3
-    /*  5: Y            */  0,    // val[0].bit4
-    /*  6: Z            */  0,    // val[0].bit5
-    /*  7: L1           */  0,    // val[0].bit6
-    /*  8: R1           */  0,    // val[0].bit7
-    /*  9: Start        */  1,    // val[1].bit0
-    /* 10: L2           */  1,    // val[1].bit1
-    /* 11: R2           */  1,    // val[1].bit2
-    /* 12: Home         */  1,    // val[1].bit3
-    /* 13: Right Stick  */  1,    // val[1].bit4
-    /* 14: Left Stick   */  1     // val[1].bit5
-};
-
-/* ────────────────────────────────────────────────────────────────────────────
-   usageMask[usage]:
-     各 usage (1–14) がそのバイト内で何ビット目かを表すマスク
-   ──────────────────────────────────────────────────────────────────────────── */
-static const uint8_t usageMask[15] = {
-    /*  0: 無効      */  0x00,
-    /*  1: A         */  1 << 0,  // val[0] bit0 → a
-    /*  2: B         */  1 << 1,  // val[0] bit1 → b
-    /*  3: C         */  1 << 2,  // val[0] bit2 → c
-    /*  4: X         */  1 << 3,  // val[0] bit3 → x
-    /*  5: Y         */  1 << 4,  // val[0] bit4 → y
-    /*  6: Z         */  1 << 5,  // val[0] bit5 → z
-    /*  7: L1        */  1 << 6,  // val[0] bit6 → L1
-    /*  8: R1        */  1 << 7,  // val[0] bit7 → R1
-    /*  9: Start     */  1 << 0,  // val[1] bit0 → start
-    /* 10: L2        */  1 << 1,  // val[1] bit1 → L2
-    /* 11: R2        */  1 << 2,  // val[1] bit2 → R2
-    /* 12: Home      */  1 << 3,  // val[1] bit3 → home
-    /* 13: RightStick*/  1 << 4,  // val[1] bit4 → right_stick
-    /* 14: LeftStick */  1 << 5   // val[1] bit5 → left_stick
-};
-
-/* 物理 idx をハードボタンに変換して押下を調べる関数 */
-static bool isPhysPressed(uint8_t phys)
-{
-    switch(phys){
-        case 0:  return BUTTON_IsPressed(BUTTON_A);
-        case 1:  return BUTTON_IsPressed(BUTTON_B);
-        case 2:  return BUTTON_IsPressed(BUTTON_C);
-        case 3:  return BUTTON_IsPressed(BUTTON_X);
-        case 4:  return BUTTON_IsPressed(BUTTON_Y);
-        case 5:  return BUTTON_IsPressed(BUTTON_Z);
-        case 6:  return BUTTON_IsPressed(BUTTON_TL);   // L
-        case 7:  return BUTTON_IsPressed(BUTTON_TR);   // R
-        case 8:  return BUTTON_IsPressed(BUTTON_START);
-        default: return false;   // no physical button for this index
-    }
-}
+// read on every report: common RAM, reached from any bank (ram_map.h)
+__near Flags flags;
+
+/* mode switch chords, looked at every 4 ms (SCHED_CHORD, scheduler.h) */
+#define CHORD_NONE      0
+#define CHORD_DPAD      1       // START+TL
+#define CHORD_MAPPING   2       // START+TR
+#define CHORD_TICKS     250     // 1 s
+
+static uint8_t chordHeld;       // the chord held at the last look
+static uint8_t chordTicks;      // looks it has been held; CHORD_TICKS once acted on
 
 // The HIDFeatureReceive function has been moved to usb_events.c
 // to handle both Interface 0 and Interface 1 Feature reports
@@ -109,10 +56,33 @@ static bool isPhysPressed(uint8_t phys)
 void App_DeviceGamepadInit(void){
     flags.crosskey_flag = 0;
     flags.sw_flag = false;
+    chordHeld = CHORD_NONE;
+    chordTicks = 0;
+}
+
+
+void App_DeviceGamepadGetModes(uint8_t *mapping, uint8_t *dpad){
+    *mapping = flags.sw_flag;
+    *dpad = flags.crosskey_flag;
 }
 
+// ホストからのモード変更 (command.h); 範囲外なら何も変えない
+bool App_DeviceGamepadSetModes(uint8_t mapping, uint8_t dpad){
+    if (mapping > 1 || dpad > 2) return false;
+    flags.sw_flag = mapping;
+    flags.crosskey_flag = dpad;
+    return true;
+}
+
+
+#if NUM_BUTTONS != 9
+#error "App_DeviceGamepadAct() reads physical buttons 0..8 one by one"
+#endif
+
+/* a pin, or the same button from the host (inject.h); needs pins and injected */
+#define PRESSED(button, bit)    ((pins && BUTTON_IsPressed(button)) || (injected & (bit)))
 
-void App_DeviceGamepadAct(INPUT_CONTROLS* gamepad_input){
+HOT_PATH void App_DeviceGamepadAct(INPUT_CONTROLS* gamepad_input){
 
     // No Report ID in Interface 0
     
@@ -120,22 +90,31 @@ void App_DeviceGamepadAct(INPUT_CONTROLS* gamepad_input){
     memset(gamepad_input->val, 0, sizeof(gamepad_input->val));
     
     
-    // D-Padの状態を取得（全ての処理で使えるように上部で定義）
-    bool up = BUTTON_IsPressed(BUTTON_UP);
-    bool down = BUTTON_IsPressed(BUTTON_DOWN);
-    bool left = BUTTON_IsPressed(BUTTON_LEFT);
-    bool right = BUTTON_IsPressed(BUTTON_RIGHT);
-
-    for (uint8_t phys = 0; phys < NUM_BUTTONS; phys++){
-        if(!isPhysPressed(phys)) continue;          // 押されていなければスキップ
-
-        uint8_t usage = Mapping_GetUsage(phys, flags.sw_flag);  // sw_flagでモード選択
-        if(!usage || usage > 14) continue;             // 無効は無視
+    // ホストからの注入 (inject.h): 再生していなければ 0 とピンのみ
+    uint16_t injected = injectButtons;
+    bool pins = !injectOverride;
 
-        uint8_t idx  = usageByte[usage];               // val のバイト番号
-        uint8_t mask = usageMask[usage];               // 立てるビット
-        gamepad_input->val[idx] |= mask;               // ワンショットでセット
-    }
+    // D-Padの状態を取得（全ての処理で使えるように上部で定義）
+    bool up = PRESSED(BUTTON_UP, HISTORY_BTN_UP);
+    bool down = PRESSED(BUTTON_DOWN, HISTORY_BTN_DOWN);
+    bool left = PRESSED(BUTTON_LEFT, HISTORY_BTN_LEFT);
+    bool right = PRESSED(BUTTON_RIGHT, HISTORY_BTN_RIGHT);
+
+    // mappingMask は Mapping_Load/Save で作成済み (usage n → bit n-1)
+    // 物理ボタン番号 0..8 の順にポートを直接読む (関数呼び出しなし)
+    const uint16_t *mask = mappingMask[flags.sw_flag];  // sw_flagでモード選択
+    uint16_t bits = 0;
+    if(PRESSED(BUTTON_A, HISTORY_BTN_A))           bits |= mask[0];    // 無効な usage は 0
+    if(PRESSED(BUTTON_B, HISTORY_BTN_B))           bits |= mask[1];
+    if(PRESSED(BUTTON_C, HISTORY_BTN_C))           bits |= mask[2];
+    if(PRESSED(BUTTON_X, HISTORY_BTN_X))           bits |= mask[3];
+    if(PRESSED(BUTTON_Y, HISTORY_BTN_Y))           bits |= mask[4];
+    if(PRESSED(BUTTON_Z, HISTORY_BTN_Z))           bits |= mask[5];
+    if(PRESSED(BUTTON_TL, HISTORY_BTN_TL))         bits |= mask[6];    // L
+    if(PRESSED(BUTTON_TR, HISTORY_BTN_TR))         bits |= mask[7];    // R
+    if(PRESSED(BUTTON_START, HISTORY_BTN_START))   bits |= mask[8];
+    gamepad_input->val[0] = (uint8_t)bits;             // A..R1
+    gamepad_input->val[1] = (uint8_t)(bits >> 8);      // Start..Left Stick
 
 
 
@@ -214,56 +193,40 @@ void App_DeviceGamepadAct(INPUT_CONTROLS* gamepad_input){
 
 }
 
-void ChangeSWMode_Button_Start(void){
-    uint16_t cnt_timer =0;
-    
-    if (BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TR)){
-        INTCONbits.TMR0IF = 0;          // reset timer0 interrupt flag
-        TMR0bits.TMR0 = (uint8_t)5;
-        cnt_timer = 0;
-        while(BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TR)){
-            if(INTCONbits.TMR0IF){          // INTCONbits.TMR0IF happens every 4ms
-                cnt_timer++;
-                if(cnt_timer >=250){        // 1s
-                    flags.sw_flag = ~(flags.sw_flag);
-                    cnt_timer =0;
-                    while(BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TR));
-                }
-                INTCONbits.TMR0IF = 0;
-                TMR0bits.TMR0 = (uint8_t)5;
-            }
+/* START+TL cycles the D-pad mode, START+TR the mapping, once held 1 s */
+void App_DeviceGamepadChords(void){
+    uint8_t chord = CHORD_NONE;
+
+    if (BUTTON_IsPressed(BUTTON_START)) {
+        if (BUTTON_IsPressed(BUTTON_TL)) {
+            chord = CHORD_DPAD;
+        } else if (BUTTON_IsPressed(BUTTON_TR)) {
+            chord = CHORD_MAPPING;
         }
     }
-        
-    return;
-}
+    if (chord != chordHeld) {
+        chordHeld = chord;
+        chordTicks = 0;
+        return;
+    }
+    // nothing held, or switched already and waiting for the release
+    if (chord == CHORD_NONE || chordTicks == CHORD_TICKS) {
+        return;
+    }
+    if (++chordTicks < CHORD_TICKS) {
+        return;
+    }
 
-void ChangeSWMode_Button_Select(void){
-    uint16_t cnt_timer =0;
-    
-    if (BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TL)){
-        INTCONbits.TMR0IF = 0;          // reset timer0 interrupt flag
-        TMR0bits.TMR0 = (uint8_t)5;
-        cnt_timer = 0;
-        while(BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TL)){
-            if(INTCONbits.TMR0IF){          // INTCONbits.TMR0IF happens every 4ms
-                cnt_timer++;
-                if(cnt_timer >=250){        // 1s
-                    switch(flags.crosskey_flag){
-                        case 0: flags.crosskey_flag =1; break;
-                        case 1: flags.crosskey_flag =2; break;
-                        case 2: flags.crosskey_flag =0; break;
-                    }
-                    cnt_timer =0;
-                    while(BUTTON_IsPressed(BUTTON_START)&&BUTTON_IsPressed(BUTTON_TL));
-                }
-                INTCONbits.TMR0IF = 0;
-                TMR0bits.TMR0 = (uint8_t)5;
-            }
+    if (chord == CHORD_DPAD) {
+        switch(flags.crosskey_flag){
+            case 0: flags.crosskey_flag =1; break;
+            case 1: flags.crosskey_flag =2; break;
+            case 2: flags.crosskey_flag =0; break;
         }
+    } else {
+        flags.sw_flag = ~(flags.sw_flag);
     }
-        
-    return;
+    TELEMETRY_ModeSwitch();
 }
 
 #endif	/* MY_APP_DEVICE_GAMEPAD_C */
\ No newline at end of file
@@ -26,8 +26,13 @@ limitations under the License.
 
 void App_DeviceGamepadInit(void);
 void App_DeviceGamepadAct(INPUT_CONTROLS* gamepad_input);
-void ChangeSWMode_Button_Start(void);
-void ChangeSWMode_Button_Select(void);
+
+/* mapping in use (0 normal, 1 special) and D-pad mode (0 X/Y, 1 hat, 2 Z/Rz) */
+void App_DeviceGamepadGetModes(uint8_t *mapping, uint8_t *dpad);
+bool App_DeviceGamepadSetModes(uint8_t mapping, uint8_t dpad);
+
+/* the START+TL / START+TR mode switches; every 4 ms, never waits */
+void App_DeviceGamepadChords(void);
 
 #endif	/* MY_APP_DEVICE_GAMEPAD_H */
 
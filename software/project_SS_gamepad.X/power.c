@@ -0,0 +1,144 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+
+#include "system.h"
+#include "usb.h"
+#include "app_device_joystick.h"
+#include "my_app_device_gamepad.h"
+#include "io_mapping.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "ext_report.h"
+#include "power.h"
+
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ          48000000UL
+#endif
+
+#define POLL_TICKS          (31u * POWER_POLL_MS)   // LFINTOSC, 31kHz
+
+uint8_t powerWakePending;
+
+static uint8_t idleA, idleB, idleC;     // the buttons when the suspend began
+static uint8_t polled;                  // a whole poll period went by asleep
+static uint32_t wakeAt;
+
+static bool buttonsChanged(void)
+{
+    return (PORTA & PORTA_BUTTONS) != idleA
+        || (PORTB & PORTB_BUTTONS) != idleB
+        || (PORTC & PORTC_BUTTONS) != idleC;
+}
+
+void Power_Suspend(void)
+{
+    idleA = PORTA & PORTA_BUTTONS;
+    idleB = PORTB & PORTB_BUTTONS;
+    idleC = PORTC & PORTC_BUTTONS;
+    polled = 0;
+    powerWakePending = 0;               // a resume that never got its report
+}
+
+/* one SLEEP; true when a button ended it */
+static bool sleepOnce(void)
+{
+    bool button;
+
+    // with GIE off a wake-up source only ends the SLEEP: the interrupt
+    // routine knows nothing of Timer1 or the USB flags
+    INTCONbits.GIE = 0;
+
+    T1CON = 0x00;
+    T1CONbits.TMR1CS = 0b11;            // LFINTOSC, which runs in Sleep
+    T1CONbits.nT1SYNC = 1;              // not synchronized, or it stops too
+    TMR1H = (uint8_t)((0x10000u - POLL_TICKS) >> 8);
+    TMR1L = (uint8_t)(0x10000u - POLL_TICKS);
+    PIR1bits.TMR1IF = 0;
+    PIE1bits.TMR1IE = 1;
+    PIE2bits.USBIE = 1;                 // ACTVIF; the stack set ACTVIE at the suspend
+    INTCONbits.PEIE = 1;
+    T1CONbits.TMR1ON = 1;
+
+    // an edge or bus activity since the last pass: the SLEEP would end at once
+    if (!INTCONbits.IOCIF && !USBActivityIF && !buttonsChanged()) {
+        SLEEP();
+        NOP();
+    }
+    button = INTCONbits.IOCIF || buttonsChanged();
+    if (PIR1bits.TMR1IF) {
+        polled = 1;
+    }
+
+    PIE1bits.TMR1IE = 0;
+    PIE2bits.USBIE = 0;
+    INTCONbits.PEIE = 0;
+    Telemetry_RestartTimer1();
+    ExtReport_Rebase();
+    // a stamp from before the sleep would count the sleep as latency
+    latencyPending = 0;
+    latencyInFlight = 0;
+    INTCONbits.GIE = 1;                 // IOCIF: latency.c stamps the edge
+    return button;
+}
+
+/* USB 2.0 7.1.7.7; the stack takes the host's resume from its ACTVIF */
+static void sendResume(void)
+{
+    USBSuspendControl = 0;
+    USBBusIsSuspended = false;
+    if (!polled) {
+        __delay_ms(POWER_IDLE_MS);      // suspended only just now
+    }
+    USBResumeControl = 1;
+    __delay_ms(POWER_RESUME_MS);
+    USBResumeControl = 0;
+}
+
+void Power_SuspendTasks(void)
+{
+    if (!sleepOnce()) {
+        return;
+    }
+    if (!USBGetRemoteWakeupStatus()) {
+        Power_Suspend();                // not allowed; wait for the next change
+        return;
+    }
+    wakeAt = Telemetry_Now();
+    SYSTEM_Initialize(SYSTEM_STATE_USB_RESUME);
+
+    // the SIE leaves an armed buffer alone until the bus is back, so the
+    // report waiting on EP1 can still be made to carry the press
+    App_DeviceGamepadAct(&joystick_input);
+    sendResume();
+    TELEMETRY_Wakeup();
+    powerWakePending = 1;
+}
+
+void Power_WakeReported(void)
+{
+    uint32_t ticks = (Telemetry_Now() - wakeAt) & 0x00FFFFFFu;
+    uint16_t t;
+
+    powerWakePending = 0;
+    ticks /= 150;                       // 1.5MHz -> 100us
+    t = (ticks > 0xFFFF) ? 0xFFFF : (uint16_t)ticks;
+    telemetry.wakeLast = t;
+    if (t > telemetry.wakeLongest) {
+        telemetry.wakeLongest = t;
+    }
+}
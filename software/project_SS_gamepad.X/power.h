@@ -0,0 +1,77 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   power.h
+ * USB suspend: the core sleeps while the bus is suspended, and a button
+ * wakes it and, when the host has allowed it with
+ * SET_FEATURE(DEVICE_REMOTE_WAKEUP), the host too.
+ *
+ * The main loop goes on through the suspend, one SLEEP per pass, so the
+ * USB stack still sees the host resume the bus. The PORTA/PORTB buttons
+ * end a SLEEP through interrupt-on-change (latency.c sets it up). PORTC
+ * has none: Timer1 runs from the LFINTOSC while asleep and ends the
+ * SLEEP every POWER_POLL_MS, so those buttons wake the pad that much
+ * later at most. telemetry.c gets Timer1 back after each SLEEP.
+ *
+ * A report armed on EP1 before the suspend is the first one the host
+ * reads after the resume. It is sampled again at the wake, so it
+ * carries the button that woke the pad even if that was only a tap.
+ * The time from the wake to the end of that transfer is kept in the
+ * telemetry (wake fields, telemetry.h).
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+
+#define POWER_POLL_MS           16      // PORTC look while asleep
+#define POWER_RESUME_MS         2       // remote wakeup K state; 1-15 ms allowed
+#define POWER_IDLE_MS           2       // bus idle before it, on top of the 3 ms
+                                        // the suspend took; 5 ms needed
+
+/* a remote wakeup waits for its first report */
+extern uint8_t powerWakePending;
+
+/**
+ * End the wake-to-report time at the TRNIF of an EP1 IN transfer
+ */
+#define POWER_ReportComplete()                          \
+    do {                                                \
+        if (powerWakePending) {                         \
+            Power_WakeReported();                       \
+        }                                               \
+    } while (0)
+
+/**
+ * The bus has been suspended; from the EVENT_SUSPEND handler. Takes the
+ * buttons as they are, so that only a change wakes the pad.
+ */
+void Power_Suspend(void);
+
+/**
+ * Sleep until a button, the poll timer or the bus ends it; on a button,
+ * signal remote wakeup. Call once per main-loop pass while suspended.
+ */
+void Power_SuspendTasks(void);
+
+/**
+ * Record the wake-to-report time, for POWER_ReportComplete()
+ */
+void Power_WakeReported(void);
+
+#endif /* POWER_H */
@@ -0,0 +1,90 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stddef.h>
+
+#include "system.h"
+#include "usb.h"
+#include "usb_config.h"
+#include "app_device_joystick.h"
+#include "ext_report.h"
+#include "command.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "boot_protocol.h"
+#include "mapping.h"
+#include "scheduler.h"
+#include "history.h"
+#include "inject.h"
+#include "keyboard.h"
+#include "ram_map.h"
+
+CONFIG_ARENA configArena;
+
+/* traditional bank address (bank << 7 | 0x20-0x6F) to linear */
+#define LINEAR(a)   (0x2000 + ((a) >> 7) * 80 + ((a) & 0x7F) - 0x20)
+
+/** FIXED REGIONS ***************************************************/
+
+#if defined(BDT_NUM_ENTRIES)
+    #if CTRL_TRF_DATA_ADDR + USB_EP0_BUFF_SIZE > JOYSTICK_DATA_ADDR
+        #error "BDT and EP0 buffers run into joystick_input"
+    #endif
+#endif
+#if MAPPING_MASK_ADDR + 2 * 2 * NUM_BUTTONS > HID_CUSTOM_IN_DATA_BUFFER_ADDR
+    #error "mappingMask runs into extReport"
+#endif
+#if HID_CUSTOM_IN_DATA_BUFFER_ADDR + EXT_REPORT_SIZE > KEYBOARD_DATA_ADDR
+    #error "extReport runs into keyboardReport"
+#endif
+#if KEYBOARD_DATA_ADDR + KEYBOARD_REPORT_SIZE > LINEAR(BOOT_REQUEST_ADDRESS)
+    #error "keyboardReport runs into bootRequest"
+#endif
+#if LINEAR(BOOT_REQUEST_ADDRESS) + 2 > CMD_DATA_BUFFER_ADDR
+    #error "bootRequest runs into cmdBuf"
+#endif
+
+RAM_CHECK(joystick, sizeof(INPUT_CONTROLS) == HID_INT_IN_EP_SIZE);
+RAM_CHECK(ext, offsetof(EXT_INPUT_REPORT, input) + sizeof(INPUT_CONTROLS) == EXT_REPORT_SIZE);
+RAM_CHECK(cmdPacket, CMD_REPORT_SIZE <= 64);
+RAM_CHECK(cmdSchedule, SCHED_DATA_SIZE <= CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+RAM_CHECK(cmdHistory, HISTORY_DATA_SIZE <= CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+RAM_CHECK(cmdInject, INJECT_DATA_SIZE <= CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+RAM_CHECK(cmdKeys, MAP_KEYS <= CMD_REPORT_SIZE - CMD_DATA_OFFSET);
+RAM_CHECK(keyboardKeys, 1 + (KEYBOARD_KEY_LAST >> 3) < KEYBOARD_REPORT_SIZE);
+
+/** HOT DATA ********************************************************/
+
+#define BANK_OF(linear) (((linear) - 0x2000) / 80)
+
+#if JOYSTICK_DATA_ADDR + HID_INT_IN_EP_SIZE > MAPPING_MASK_ADDR
+    #error "joystick_input runs into mappingMask"
+#endif
+#if BANK_OF(MAPPING_MASK_ADDR + 2 * 2 * NUM_BUTTONS - 1) != BANK_OF(JOYSTICK_DATA_ADDR)
+    #error "mappingMask has left the bank of joystick_input"
+#endif
+
+RAM_CHECK(mappingMask, sizeof(mappingMask) == 2 * 2 * NUM_BUTTONS);
+
+/** ARENA USERS *****************************************************/
+
+RAM_CHECK(mapping, HID_MAP_EP_BUF_SIZE <= CONFIG_ARENA_SIZE);
+RAM_CHECK(telemetry, TELEMETRY_REPORT_SIZE <= CONFIG_ARENA_SIZE);
+RAM_CHECK(telemetryFields, 2 + offsetof(TELEMETRY_COUNTERS, injectSlips) + 2 == TELEMETRY_REPORT_SIZE);
+RAM_CHECK(latency, LATENCY_REPORT_SIZE <= CONFIG_ARENA_SIZE);
+RAM_CHECK(boot, BOOT_REPORT_SIZE <= CONFIG_ARENA_SIZE);
+RAM_CHECK(inputSample, sizeof(INPUT_CONTROLS) <= CONFIG_ARENA_SIZE);
+RAM_CHECK(keyboardSample, KEYBOARD_REPORT_SIZE <= CONFIG_ARENA_SIZE);
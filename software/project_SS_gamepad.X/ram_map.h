@@ -0,0 +1,81 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   ram_map.h
+ * Where the 1 KB of RAM goes. Linear addresses, 80 bytes a bank.
+ *
+ * Fixed (fixed_address_memory.h, usb_hal_pic16f1.h, boot_protocol.h):
+ *   0x2000  bank 0  BDT, 4 entries for each of EP0-3 (64 bytes), then
+ *                   the EP0 SETUP and data buffers (8 + 8)
+ *   0x2050  bank 1  joystick_input, the EP1 report (7)
+ *   0x2058          mappingMask (36)
+ *   0x20A0  bank 2  extReport, the extended report on EP2 IN (11)
+ *   0x20B0          keyboardReport, the keyboard on EP3 IN (14)
+ *   0x20EE          bootRequest, read by the bootloader after a RESET (2)
+ *   0x20F0  bank 3  cmdBuf, commands on EP2 OUT and their answers (64)
+ *
+ * Shared: configArena, which only a configuration transaction uses, one
+ * at a time: the data stage of a Feature report on EP0 (usb_events.c,
+ * boot_request.c), the sample answering GET_REPORT(Input) on interface
+ * 0 or 2, or a flash row on its way out of Mapping_CommitTasks(). The
+ * mapping itself stays in RAM only as its usage tables and the masks
+ * built from them (mapping.h); its 64-byte image is made up on the way
+ * to the host or the flash.
+ *
+ * Hot: what the report path reads every frame sits where it costs no
+ * bank switch, or one. flags (my_app_device_gamepad.c) and
+ * lastTransmission (app_device_joystick.c) are __near, in the 16 bytes
+ * of common RAM that every bank sees; mappingMask shares bank 1 with
+ * joystick_input, the report it is ORed into. The configuration state
+ * (the usage tables, telemetry, the arena) is left to the linker.
+ * tools/picsim/bench/hotcheck.py checks the .sym of a build for it.
+ *
+ * Big: the button history (history.h), 128 bytes, is the largest
+ * block after the USB buffers. It is only touched by the scan task and
+ * one command, so the linker may put it anywhere in linear memory.
+ *
+ * Everything else is placed by the linker, whose memory summary lists
+ * it per psect. ram_map.c checks the fixed regions against each other
+ * and the arena against the reports that pass through it, so a report
+ * that outgrows its buffer stops the build.
+ */
+
+#ifndef RAM_MAP_H
+#define RAM_MAP_H
+
+#include <stdint.h>
+
+#define CONFIG_ARENA_SIZE       64
+
+typedef union
+{
+    uint8_t  feature[CONFIG_ARENA_SIZE];        // EP0 data stage, report ID first
+    uint16_t row[CONFIG_ARENA_SIZE / 2];        // a flash row, one word per byte
+} CONFIG_ARENA;
+
+extern CONFIG_ARENA configArena;
+
+/* fails the build when cond is false; for the sizes the preprocessor can't see */
+#define RAM_CHECK(name, cond)   typedef char ramCheck_##name[(cond) ? 1 : -1]
+
+/**
+ * Whether an EP0 data stage is still reading or writing configArena;
+ * Mapping_CommitTasks() holds a row write back until it is not
+ */
+#define ConfigArena_Busy()  (outPipes[0].info.bits.busy || inPipes[0].wCount.Val != 0)
+
+#endif /* RAM_MAP_H */
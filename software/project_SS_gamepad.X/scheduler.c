@@ -0,0 +1,192 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <stdbool.h>
+
+#include "system.h"
+#include "usb.h"
+#include "app_device_joystick.h"
+#include "my_app_device_gamepad.h"
+#include "mapping.h"
+#include "telemetry.h"
+#include "latency.h"
+#include "history.h"
+#include "keyboard.h"
+#include "boot_request.h"
+#include "command.h"
+#include "power.h"
+#include "code_map.h"
+#include "scheduler.h"
+
+typedef struct
+{
+    uint16_t period;        // from one start to the next, 0 for every pass
+    uint16_t budget;        // one run
+    uint16_t gap;           // the USB gap the task may run into
+} SCHED_TASK;
+
+static const SCHED_TASK tasks[SCHED_TASKS] = {
+    { 0,                SCHED_US(300),  SCHED_USB_GAP },                // SCHED_USB
+    { 0,                SCHED_US(20),   SCHED_USB_GAP },                // SCHED_TELEMETRY
+    { 0,                SCHED_US(40),   SCHED_USB_GAP },                // SCHED_SCAN
+    { 0,                SCHED_US(200),  SCHED_USB_GAP },                // SCHED_REPORT
+    { 0,                SCHED_US(300),  SCHED_USB_GAP },                // SCHED_COMMAND
+    { SCHED_US(4000),   SCHED_US(30),   SCHED_USB_GAP },                // SCHED_CHORD
+    { 0,                SCHED_US(2600), SCHED_USB_GAP_CONFIGURED },     // SCHED_FLASH
+};
+
+static uint16_t lastStart[SCHED_TASKS];
+static uint16_t worst[SCHED_TASKS];
+static uint16_t overruns[SCHED_TASKS];
+static uint32_t usbAt;                  // Telemetry_Now() at the last USB service
+static bool usbAtValid;
+
+/* the calls are spelled out, so the stack depth stays visible (picsim --stack) */
+static void run(uint8_t task)
+{
+    switch (task) {
+        case SCHED_TELEMETRY:
+            Telemetry_LoopPass();
+            break;
+        case SCHED_SCAN:
+            Latency_Scan();
+            History_Scan();
+            break;
+        case SCHED_REPORT:
+            APP_DeviceJoystickTasks();
+            Keyboard_Tasks();           // after EP1, which must not wait for it
+            break;
+        case SCHED_COMMAND:
+            // configuration commands on interface 1, answered on EP2
+            Command_Tasks();
+            break;
+        case SCHED_CHORD:
+            App_DeviceGamepadChords();
+            break;
+        case SCHED_FLASH:
+            Mapping_CommitTasks();
+            break;
+    }
+}
+
+static void account(uint8_t task, uint16_t took)
+{
+    if (took > worst[task]) {
+        worst[task] = took;
+    }
+    if (took > tasks[task].budget) {
+        overruns[task]++;
+        telemetry.overruns++;
+        telemetry.overrunTask = task + 1;
+    }
+}
+
+static void serviceUsb(void)
+{
+    uint32_t now = Telemetry_Now();
+
+    if (usbAtValid) {
+        uint32_t gap = (now - usbAt) & 0x00FFFFFFu;
+
+        if (gap > 0xFFFF) {
+            gap = 0xFFFF;
+        }
+        if (gap > telemetry.usbGapLongest) {
+            telemetry.usbGapLongest = (uint16_t)gap;
+        }
+    }
+    usbAt = now;
+    usbAtValid = true;
+
+    #if defined(USB_POLLING)
+        // Interrupt or polling method.  If using polling, must call
+        // this function periodically.  This function will take care
+        // of processing and responding to SETUP transactions
+        // (such as during the enumeration process when you first
+        // plug in).  USB hosts require that USB devices should accept
+        // and process SETUP packets in a timely fashion.  Therefore,
+        // when using polling, this function should be called
+        // regularly (such as once every 1.8ms or faster** [see
+        // inline code comments in usb_device.c for explanation when
+        // "or faster" applies])
+        USBDeviceTasks();
+    #endif
+
+    // after a bootloader request has been answered
+    BootRequest_Tasks();
+}
+
+HOT_PATH void Scheduler_Tasks(void)
+{
+    uint16_t passStart, start, now;
+    uint8_t task, count;
+
+    TELEMETRY_ReadTimer1(passStart);
+    serviceUsb();
+    TELEMETRY_ReadTimer1(now);
+    account(SCHED_USB, now - passStart);
+
+    /* If the USB device isn't configured yet, or we are suspended, there
+     * is no host to talk to: only the tasks before SCHED_REPORT run. */
+    count = SCHED_TASKS;
+    if (USBGetDeviceState() < CONFIGURED_STATE || USBIsDeviceSuspended() == true) {
+        count = SCHED_REPORT;
+    }
+
+    for (task = SCHED_USB + 1; task < count; task++) {
+        start = now;
+        if ((uint16_t)(start - lastStart[task]) < tasks[task].period) {
+            continue;
+        }
+        if ((uint16_t)(start - passStart) > tasks[task].gap - tasks[task].budget) {
+            continue;                   // no room before the next USB service
+        }
+        lastStart[task] = start;
+        run(task);
+        TELEMETRY_ReadTimer1(now);
+        account(task, now - start);
+    }
+
+    /* Sleep until something happens, and issue a remote wakeup if it
+     * was a button; Timer1 starts over after it. */
+    if (USBGetDeviceState() >= CONFIGURED_STATE && USBIsDeviceSuspended() == true) {
+        Power_SuspendTasks();
+        Scheduler_Restart();
+    }
+}
+
+void Scheduler_Restart(void)
+{
+    usbAtValid = false;
+}
+
+void Scheduler_GetAsCommandData(uint8_t *data)
+{
+    uint8_t task;
+
+    *data++ = SCHED_TASKS;
+    for (task = 0; task < SCHED_TASKS; task++) {
+        *data++ = (uint8_t)tasks[task].period;
+        *data++ = (uint8_t)(tasks[task].period >> 8);
+        *data++ = (uint8_t)tasks[task].budget;
+        *data++ = (uint8_t)(tasks[task].budget >> 8);
+        *data++ = (uint8_t)worst[task];
+        *data++ = (uint8_t)(worst[task] >> 8);
+        *data++ = (uint8_t)overruns[task];
+        *data++ = (uint8_t)(overruns[task] >> 8);
+    }
+}
@@ -0,0 +1,93 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   scheduler.h
+ * The main loop: every task of the firmware with the time it may take
+ * (budget) and how often it runs (period), in Timer1 ticks (1.5 MHz,
+ * telemetry.h). One Scheduler_Tasks() call is one pass.
+ *
+ *   task             period   budget
+ *   SCHED_USB        pass     300us   USBDeviceTasks(), BootRequest_Tasks()
+ *   SCHED_TELEMETRY  pass      20us   Telemetry_LoopPass()
+ *   SCHED_SCAN       pass      40us   Latency_Scan(), History_Scan()
+ *   SCHED_REPORT     pass     200us   APP_DeviceJoystickTasks(), Keyboard_Tasks()
+ *   SCHED_COMMAND    pass     300us   Command_Tasks()
+ *   SCHED_CHORD      4 ms      30us   App_DeviceGamepadChords()
+ *   SCHED_FLASH      pass    2600us   Mapping_CommitTasks()
+ *
+ * The USB service opens every pass. usb_device.c wants it at least every
+ * 1.8 ms while enumerating (SCHED_USB_GAP), so the tasks after it run
+ * only when their budget fits in what is left of that since the pass
+ * began; one that does not waits for the next pass. The tasks from
+ * SCHED_REPORT on run only while configured and not suspended; in a
+ * suspend the pass ends with Power_SuspendTasks() instead.
+ *
+ * A flash row erase or write stalls the core for about 2 ms, which no
+ * budget under 1.8 ms holds. Once configured the stack can go 9.8 ms
+ * between services (SCHED_USB_GAP_CONFIGURED), and SCHED_FLASH, which
+ * only runs then, is held to that: a mapping save costs four passes
+ * with a 2.x ms gap each, and no other task ever runs into one.
+ *
+ * A run longer than its budget is an overrun. Overruns, the longest
+ * gap between two USB services and the worst run of each task are
+ * kept (telemetry.h, Scheduler_GetAsCommandData()).
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+/* us to Timer1 ticks */
+#define SCHED_US(us)                ((uint16_t)((us) * 3UL / 2))
+
+#define SCHED_USB_GAP               SCHED_US(1800)
+#define SCHED_USB_GAP_CONFIGURED    SCHED_US(9800)
+
+/* in the order of a pass */
+#define SCHED_USB           0
+#define SCHED_TELEMETRY     1
+#define SCHED_SCAN          2
+#define SCHED_REPORT        3       // first of the tasks that need the host
+#define SCHED_COMMAND       4
+#define SCHED_CHORD         5
+#define SCHED_FLASH         6
+#define SCHED_TASKS         7
+
+/* Scheduler_GetAsCommandData(): the task count, then per task */
+#define SCHED_DATA_SIZE     (1 + 8 * SCHED_TASKS)
+
+/**
+ * One pass of the main loop; call it forever
+ */
+void Scheduler_Tasks(void);
+
+/**
+ * Forget the time of the last USB service, so the next pass does not
+ * count as a gap; after Timer1 has been restarted or the loop has left
+ * the scheduler for a while
+ */
+void Scheduler_Restart(void);
+
+/**
+ * Per task, 2 bytes each little endian: period, budget, worst run (all
+ * in Timer1 ticks) and overruns, after one byte with SCHED_TASKS
+ * @param data at least SCHED_DATA_SIZE bytes
+ */
+void Scheduler_GetAsCommandData(uint8_t *data);
+
+#endif /* SCHEDULER_H */
@@ -22,9 +22,12 @@ please contact mla_licensing@microchip.com
  * 
  * Changes from the original source:
  *     - deleted unused function calls
+ *     - interrupt-on-change for the latency measurement
+ *     - clock tuning off through a USB suspend
  ********************************************************************/
 
 #include "system.h"
+#include "latency.h"
 
 /** CONFIGURATION Bits **********************************************/
 // PIC16F1459 configuration bit settings:
@@ -102,9 +105,18 @@ void SYSTEM_Initialize( SYSTEM_STATE state )
             break;
             
         case SYSTEM_STATE_USB_SUSPEND: 
+            #if defined(USE_INTERNAL_OSC)
+                //No SOF packets to tune to on a suspended bus
+                ACTCONbits.ACTEN = 0;
+            #endif
             break;
             
         case SYSTEM_STATE_USB_RESUME:
+            #if defined(USE_INTERNAL_OSC)
+                //The PLL relocks after Sleep before the clock is used for USB
+                while(!OSCSTATbits.PLLRDY);
+                ACTCON = 0x90;
+            #endif
             break;
     }
 }
@@ -120,4 +132,7 @@ void INTERRUPT SYS_InterruptHigh(void)
     #if defined(USB_INTERRUPT)
         USBDeviceTasks();
     #endif
+    if (INTCONbits.IOCIE && INTCONbits.IOCIF) {
+        Latency_InterruptOnChange();
+    }
 }
@@ -0,0 +1,116 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <xc.h>
+#include <string.h>
+
+#include "telemetry.h"
+
+TELEMETRY_COUNTERS telemetry;
+uint16_t telemetryLoops;                // passes since the last report
+uint8_t telemetryEpoch;
+
+static uint16_t passStart;              // Timer1 at the top of the last pass
+
+static void startTimer1(void)
+{
+    // Fosc/4 = 12MHz, 1:8 -> 1.5MHz, rolls over every 43.7ms
+    T1CON = 0x00;
+    T1CONbits.TMR1CS = 0b00;            // instruction clock
+    T1CONbits.T1CKPS = 0b11;            // prescaler 1:8
+    TMR1H = 0;
+    TMR1L = 0;
+    PIR1bits.TMR1IF = 0;
+    T1CONbits.TMR1ON = 1;
+    passStart = 0;
+}
+
+void Telemetry_Initialize(void)
+{
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetryLoops = 0;
+    startTimer1();
+}
+
+void Telemetry_RestartTimer1(void)
+{
+    // Timer1 starts over from 0, so the epoch moves on for Telemetry_Now()
+    // to keep counting up: one for the restart and one for a rollover
+    // before the sleep that Telemetry_LoopPass() never saw. The time
+    // asleep is simply not in it.
+    telemetryEpoch += 2;
+    startTimer1();
+}
+
+void Telemetry_LoopPass(void)
+{
+    uint16_t now, pass;
+
+    TELEMETRY_ReadTimer1(now);
+    pass = now - passStart;
+    if (PIR1bits.TMR1IF) {
+        PIR1bits.TMR1IF = 0;
+        telemetryEpoch++;
+        if (now >= passStart) {
+            pass = 0xFFFF;              // a whole rollover or more
+            telemetryEpoch++;
+        }
+    }
+    passStart = now;
+
+    if (pass > telemetry.longestPass) {
+        telemetry.longestPass = pass;
+    }
+    if (telemetryLoops != 0xFFFF) {
+        telemetryLoops++;
+    }
+}
+
+uint32_t Telemetry_Now(void)
+{
+    uint16_t now;
+    uint8_t epoch = telemetryEpoch;
+
+    TELEMETRY_ReadTimer1(now);
+    if (PIR1bits.TMR1IF && now < 0x8000) {
+        epoch++;                        // rolled over, not yet counted by Telemetry_LoopPass()
+    }
+    return ((uint32_t)epoch << 16) | now;
+}
+
+void Telemetry_Stamp(uint16_t *stamp)
+{
+    uint32_t ticks;
+
+    // the 8-bit epoch covers 11 s, well past the 6.5 s the field can hold
+    ticks = Telemetry_Now() / 150;      // 1.5MHz -> 100us
+    if (ticks > 0xFFFF) {
+        ticks = 0xFFFF;
+    } else if (ticks == 0) {
+        ticks = 1;                      // 0 means not yet
+    }
+    *stamp = (uint16_t)ticks;
+}
+
+void Telemetry_GetAsFeatureReport(uint8_t* featureReport)
+{
+    memset(featureReport, 0, TELEMETRY_REPORT_SIZE);
+    featureReport[0] = TELEMETRY_REPORT_ID;
+    featureReport[1] = TELEMETRY_VER;
+    // XC8 stores multi-byte values little endian, as the report wants them;
+    // the size leaves out the tail padding a PC build adds (ram_map.c)
+    memcpy(&featureReport[2], &telemetry, TELEMETRY_REPORT_SIZE - 2);
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   telemetry.h
+ * Counters kept by the firmware while it runs, read by the host as
+ * Feature report TELEMETRY_REPORT_ID on interface 1.
+ *
+ * The counters are only touched from the main loop (the USB stack is
+ * polled, so the SOF and bus error events arrive there too). Counting an
+ * event is a single increment; a GET_REPORT copies them to the feature
+ * buffer in one go, so the host never sees a half-updated value.
+ *
+ * Report layout (little endian, byte 0 is the report ID):
+ *   1      version (TELEMETRY_VER)
+ *   2-5    IN reports queued on the joystick endpoint
+ *   6-9    main-loop passes that found the joystick endpoint busy
+ *   10-13  SOF packets
+ *   14-15  main-loop passes between the last two reports
+ *   16-17  most main-loop passes between two reports
+ *   18-19  longest main-loop pass in Timer1 ticks (1.5 MHz),
+ *          0xFFFF when it took 43 ms or more
+ *   20-21  USB bus errors
+ *   22-23  mapping rows written to flash
+ *   24-25  mode switches (START+TL, START+TR)
+ *   26-27  boot: USBDeviceAttach() called
+ *   28-29  boot: first SET_CONFIGURATION handled
+ *   30-31  boot: first report queued on EP1
+ *   32-33  remote wakeups signalled (power.h)
+ *   34-35  wake to report, last: from a button waking the core in
+ *          suspend to the end of the first EP1 transfer after the
+ *          resume, in 100us, 0xFFFF from 6.5 s on
+ *   36-37  wake to report, longest
+ *   38-39  longest time between two USB services in Timer1 ticks,
+ *          0xFFFF when it took 43 ms or more (scheduler.h)
+ *   40-41  task runs that took longer than their budget
+ *   42-43  the task of the last one, SCHED_* + 1; 0 for none yet
+ *   44-45  the host's EP1 poll interval in frames, 0 until one is
+ *          confirmed (cadence.h)
+ *   46-47  poll interval changes
+ *   48-49  reports held for the poll that missed it
+ *   50-51  injection underruns: frames played with the queue empty
+ *          (inject.h)
+ *   52-53  injection slips: frames whose SOF was not seen
+ *
+ * Boot times (since version 2) are in 100us from the start of Timer1 at
+ * the top of main(), 0 until the step happened and 0xFFFF from 6.5 s on.
+ * They are taken once per reset, so each hot-plug of a bus-powered pad
+ * records a fresh set. The wake fields are there since version 3, the
+ * scheduler fields since version 4, the poll fields since version 5,
+ * the injection fields since version 6.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#define TELEMETRY_REPORT_ID     0x02
+#define TELEMETRY_REPORT_SIZE   54      // including the report ID
+#define TELEMETRY_VER           0x06
+
+typedef struct {
+    uint32_t reports;
+    uint32_t busyMisses;
+    uint32_t sofs;
+    uint16_t loopsLast;
+    uint16_t loopsMax;
+    uint16_t longestPass;
+    uint16_t busErrors;
+    uint16_t flashCommits;
+    uint16_t modeSwitches;
+    uint16_t bootAttach;
+    uint16_t bootConfigured;
+    uint16_t bootFirstReport;
+    uint16_t wakeups;
+    uint16_t wakeLast;
+    uint16_t wakeLongest;
+    uint16_t usbGapLongest;
+    uint16_t overruns;
+    uint16_t overrunTask;
+    uint16_t pollInterval;
+    uint16_t pollChanges;
+    uint16_t pollMissed;
+    uint16_t injectUnderruns;
+    uint16_t injectSlips;
+} TELEMETRY_COUNTERS;
+
+extern TELEMETRY_COUNTERS telemetry;
+extern uint16_t telemetryLoops;
+extern uint8_t telemetryEpoch;          // Timer1 rollovers, 2 or more per long pass
+
+/**
+ * Read the free-running Timer1 (1.5MHz) into a uint16_t
+ * TMR1L may carry into TMR1H between the two reads, hence the retry
+ */
+#define TELEMETRY_ReadTimer1(now)                       \
+    do {                                                \
+        uint8_t hi_;                                    \
+        do {                                            \
+            hi_ = TMR1H;                                \
+            (now) = TMR1L;                              \
+        } while (hi_ != TMR1H);                         \
+        (now) |= (uint16_t)hi_ << 8;                    \
+    } while (0)
+
+/* one event each; a few instructions, so they can sit in the hot path */
+#define TELEMETRY_BusyMiss()        (telemetry.busyMisses++)
+#define TELEMETRY_Sof()             (telemetry.sofs++)
+#define TELEMETRY_BusError()        (telemetry.busErrors++)
+#define TELEMETRY_FlashCommit()     (telemetry.flashCommits++)
+#define TELEMETRY_ModeSwitch()      (telemetry.modeSwitches++)
+#define TELEMETRY_Wakeup()          (telemetry.wakeups++)
+
+/**
+ * Record the time since Timer1 started in one of the boot fields, the
+ * first time only; the test keeps it cheap on the report path
+ */
+#define TELEMETRY_Boot(stamp)                           \
+    do {                                                \
+        if ((stamp) == 0) {                             \
+            Telemetry_Stamp(&(stamp));                  \
+        }                                               \
+    } while (0)
+
+/**
+ * Count a report queued on the joystick endpoint and close the count of
+ * main-loop passes since the previous one
+ */
+#define TELEMETRY_ReportSent()                          \
+    do {                                                \
+        telemetry.reports++;                            \
+        telemetry.loopsLast = telemetryLoops;           \
+        if (telemetryLoops > telemetry.loopsMax) {      \
+            telemetry.loopsMax = telemetryLoops;        \
+        }                                               \
+        telemetryLoops = 0;                             \
+    } while (0)
+
+/**
+ * Start Timer1 as the free-running clock for the loop pass time
+ */
+void Telemetry_Initialize(void);
+
+/**
+ * Give Timer1 back its 1.5MHz clock after power.c has run it from the
+ * LFINTOSC through a sleep; that loop pass is not counted as the longest.
+ * Telemetry_Now() goes on from past where it stood before the sleep.
+ */
+void Telemetry_RestartTimer1(void);
+
+/**
+ * Timer1 with the epoch above it, in ticks; the difference of two
+ * readings, taken modulo 2^24, is exact for up to 11 s
+ */
+uint32_t Telemetry_Now(void);
+
+/**
+ * Store the time since Telemetry_Initialize() in 100us, at least 1;
+ * see TELEMETRY_Boot()
+ */
+void Telemetry_Stamp(uint16_t *stamp);
+
+/**
+ * Call once at the top of every main-loop pass
+ */
+void Telemetry_LoopPass(void);
+
+/**
+ * Copy the counters to the Feature Report buffer
+ * @param featureReport at least TELEMETRY_REPORT_SIZE bytes
+ */
+void Telemetry_GetAsFeatureReport(uint8_t* featureReport);
+
+#endif /* TELEMETRY_H */
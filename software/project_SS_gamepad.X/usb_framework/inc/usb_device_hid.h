@@ -37,6 +37,11 @@ please contact mla_licensing@microchip.com
 #define SET_IDLE        0x0A
 #define SET_PROTOCOL    0x0B
 
+/* Report types (wValue high byte of GET_REPORT / SET_REPORT) */
+#define HID_REPORT_TYPE_INPUT       0x01
+#define HID_REPORT_TYPE_OUTPUT      0x02
+#define HID_REPORT_TYPE_FEATURE     0x03
+
 /* Class Descriptor Types */
 #define DSC_HID         0x21
 #define DSC_RPT         0x22
@@ -24,6 +24,8 @@ please contact mla_licensing@microchip.com
  * 
  * Changes from the original source:
  *     - comment out unused functions
+ *     - USB_DEVICE_PIC16F1_ONLY build profile: early return from an idle
+ *       USBDeviceTasks() pass, no 32-bit 1 ms tick counter
  ********************************************************************/
 
 /*******************************************************************************
@@ -61,6 +63,7 @@ please contact mla_licensing@microchip.com
 #include "usb_ch9.h"
 #include "usb_device.h"
 #include "usb_device_local.h"
+#include "code_map.h"
 
 #ifndef uintptr_t
     #if  defined(__XC8__) || defined(__XC16__)
@@ -105,6 +108,17 @@ please contact mla_licensing@microchip.com
     #define USB_MAX_NUM_CONFIG_DSC      1
 #endif
 
+#if defined(USB_DEVICE_PIC16F1_ONLY)
+    //The shortcuts below rely on these: one flag register covers every event,
+    //no OTG, SOF is the only time base and USB_BUS_SENSE is left at 1.
+    #if !defined(_PIC14E) || !defined(USB_POLLING) || defined(USB_SUPPORT_OTG) \
+        || (USB_PING_PONG_MODE != USB_PING_PONG__FULL_PING_PONG) || (USB_SPEED_OPTION != USB_FULL_SPEED) \
+        || defined(USE_USB_BUS_SENSE_IO)
+        #error "USB_DEVICE_PIC16F1_ONLY needs a PIC16F1, USB_POLLING, full speed, full ping-pong and no bus sense pin"
+    #endif
+    #define USB_SOFIF_MASK  0x40        //UIRbits.SOFIF, serviced whether or not SOFIE is set
+#endif
+
 #if defined(__XC8)
     //Suppress expected/harmless compiler warning message about unused RAM variables
     //and certain function pointer usage.
@@ -170,7 +184,9 @@ volatile bool USBStatusStageEnabledFlag1;
 volatile bool USBStatusStageEnabledFlag2;
 volatile bool USBDeferINDataStagePackets;
 volatile bool USBDeferOUTDataStagePackets;
+#if !defined(USB_DEVICE_PIC16F1_ONLY)
 USB_VOLATILE uint32_t USB1msTickCount;
+#endif
 USB_VOLATILE uint8_t USBTicksSinceSuspendEnd;
 
 /** USB FIXED LOCATION VARIABLES ***********************************/
@@ -374,7 +390,9 @@ void USBDeviceInit(void)
     // Clear active configuration
     USBActiveConfiguration = 0;
 
+    #if !defined(USB_DEVICE_PIC16F1_ONLY)
     USB1msTickCount = 0;            //Keeps track of total number of milliseconds since calling USBDeviceInit() when first initializing the USB module/stack code.
+    #endif
     USBTicksSinceSuspendEnd = 0;    //Keeps track of the number of milliseconds since a suspend condition has ended.
 
     //Indicate that we are now in the detached state
@@ -485,10 +503,20 @@ void USBDeviceInit(void)
     the USBDeviceAttach() and USBDeviceDetach() API documentation for additional
     considerations.
     ***************************************************************************/
-void USBDeviceTasks(void)
+HOT_PATH void USBDeviceTasks(void)
 {
     uint8_t i;
 
+    #if defined(USB_DEVICE_PIC16F1_ONLY)
+    //Most passes find nothing to do. Once past the attach states, which are
+    //polled rather than flagged, everything below is gated by a UIR flag.
+    if(USBDeviceState >= POWERED_STATE && (UIR & (UIE | USB_SOFIF_MASK)) == 0 && USBSuspendControl == 0)
+    {
+        USBClearUSBInterrupt();
+        return;
+    }
+    #endif
+
     #ifdef USB_SUPPORT_OTG
         //SRP Time Out Check
         if (USBOTGSRPIsReady())
@@ -725,7 +753,14 @@ void USBDeviceTasks(void)
         }
         USBClearInterruptFlag(USBSOFIFReg,USBSOFIFBitNum);
 
-        #if defined(__XC8__) || defined(__C18__)
+        #if defined(USB_DEVICE_PIC16F1_ONLY)
+            //USBGet1msTickCount() is not built, so only the 8-bit counter is
+            //kept; SOFs stop while suspended, so it needs no suspend check.
+            if(USBTicksSinceSuspendEnd != 255u)
+            {
+                USBTicksSinceSuspendEnd++;
+            }
+        #elif defined(__XC8__) || defined(__C18__)
             USBIncrement1msInternalTimers();
         #endif
 
@@ -1003,7 +1038,7 @@ void USBEnableEndpoint(uint8_t ep, uint8_t options)
     function first.
 
   *************************************************************************/
-USB_HANDLE USBTransferOnePacket(uint8_t ep,uint8_t dir,uint8_t* data,uint8_t len)
+HOT_PATH USB_HANDLE USBTransferOnePacket(uint8_t ep,uint8_t dir,uint8_t* data,uint8_t len)
 {
     volatile BDT_ENTRY* handle;
 
@@ -3002,6 +3037,7 @@ static void USBStdFeatureReqHandler(void)
         This function does not need to be called during USB suspend conditions, when
         the USB module/stack is disabled, or when the USB cable is detached from the host.
   ***************************************************************************/
+#if !defined(USB_DEVICE_PIC16F1_ONLY)
 void USBIncrement1msInternalTimers(void)
 {
     #if(USB_SPEED_OPTION == USB_LOW_SPEED)
@@ -3021,6 +3057,7 @@ void USBIncrement1msInternalTimers(void)
         }
     }
 }
+#endif
 
 
 
@@ -89,6 +89,7 @@ static uint8_t idle_rate;
 static uint8_t active_protocol;   // [0] Boot Protocol [1] Report Protocol
 
 extern const struct{uint8_t report[HID_RPT01_SIZE];}hid_rpt01;
+extern const struct{uint8_t report[HID_KBD_RPT_DESC_SIZE];}hid_kbd_rpt;
 
 // *****************************************************************************
 // *****************************************************************************
@@ -162,8 +163,8 @@ extern const struct{uint8_t report[HID_RPT01_SIZE];}hid_rpt01;
 void USBCheckHIDRequest(void)
 {
     if(SetupPkt.Recipient != USB_SETUP_RECIPIENT_INTERFACE_BITFIELD) return;
-    // Allow Interface 0 and Interface 1 (HID_INTF_ID = 0)
-    if(SetupPkt.bIntfID > 1) return;
+    // Allow Interface 0, 1 and 2 (HID_INTF_ID = 0)
+    if(SetupPkt.bIntfID > 2) return;
 
     /*
      * There are two standard requests that hid.c may support.
@@ -187,7 +188,14 @@ void USBCheckHIDRequest(void)
                     else if(SetupPkt.bIntfID == 1) {
                         // Interface 1 - Mapping Feature HID descriptor
                         USBEP0SendROMPtr(
-                            (const uint8_t*)&configDescriptor1 + 45,		// offset from start of the configuration descriptor to the start of the second HID descriptor
+                            (const uint8_t*)&configDescriptor1 + 43,		// offset from start of the configuration descriptor to the start of the second HID descriptor
+                            sizeof(USB_HID_DSC)+3,
+                            USB_EP0_INCLUDE_ZERO);
+                    }
+                    else if(SetupPkt.bIntfID == 2) {
+                        // Interface 2 - Keyboard HID descriptor
+                        USBEP0SendROMPtr(
+                            (const uint8_t*)&configDescriptor1 + 75,		// offset from start of the configuration descriptor to the start of the third HID descriptor
                             sizeof(USB_HID_DSC)+3,
                             USB_EP0_INCLUDE_ZERO);
                     }
@@ -211,6 +219,13 @@ void USBCheckHIDRequest(void)
                             HID_MAP_RPT_DESC_SIZE,     //See usbcfg.h (ディスクリプタサイズ指定用途)
                             USB_EP0_INCLUDE_ZERO);
                     }
+                    else if(SetupPkt.bIntfID == 2) {
+                        // Interface 2 - Keyboard report descriptor
+                        USBEP0SendROMPtr(
+                            (const uint8_t*)&hid_kbd_rpt,
+                            HID_KBD_RPT_DESC_SIZE,     //See usbcfg.h
+                            USB_EP0_INCLUDE_ZERO);
+                    }
                 }
                 break;
             case DSC_PHY:  //Physical Descriptor
@@ -0,0 +1,85 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+#include "bootpacket.h"
+
+void BootPacket_PackRow(const uint16_t *words, uint8_t *out)
+{
+    uint32_t acc = 0;
+    unsigned bits = 0;
+
+    for (unsigned i = 0; i < BOOT_ROW_WORDS; i++) {
+        acc |= (uint32_t)(words[i] & 0x3FFF) << bits;
+        bits += 14;
+        while (bits >= 8) {
+            *out++ = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+}
+
+uint16_t BootPacket_Crc16(const uint16_t *words, unsigned count)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (count--) {
+        uint8_t b[2] = { (uint8_t)*words, (uint8_t)(*words >> 8) };
+
+        words++;
+        for (int n = 0; n < 2; n++) {
+            crc ^= (uint16_t)(b[n] << 8);
+            for (int i = 0; i < 8; i++) {
+                crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+            }
+        }
+    }
+    return crc;
+}
+
+bool BootPacket_Command(int fd, uint8_t cmd, uint16_t address, uint16_t count,
+                        const uint8_t *data, uint8_t *answer, int timeoutMs)
+{
+    uint8_t out[1 + BOOT_PACKET_SIZE] = { 0 };     // report number 0: no report IDs
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    out[1 + 0] = cmd;
+    out[1 + 2] = (uint8_t)address;
+    out[1 + 3] = (uint8_t)(address >> 8);
+    out[1 + 4] = (uint8_t)count;
+    out[1 + 5] = (uint8_t)(count >> 8);
+    if (data != NULL) memcpy(&out[1 + BOOT_DATA_OFFSET], data, BOOT_PACKET_SIZE - BOOT_DATA_OFFSET);
+    if (write(fd, out, sizeof(out)) != (ssize_t)sizeof(out)) return false;
+
+    if (poll(&pfd, 1, timeoutMs) != 1) return false;
+    if (read(fd, answer, BOOT_PACKET_SIZE) != BOOT_PACKET_SIZE) return false;
+    return answer[0] == cmd && answer[2] == out[1 + 2] && answer[3] == out[1 + 3];
+}
+
+bool BootPacket_Request(int fd)
+{
+    uint8_t report[BOOT_REPORT_SIZE] = { BOOT_REPORT_ID };
+
+    memcpy(&report[1], BOOT_REPORT_KEY, BOOT_REPORT_SIZE - 1);
+    return ioctl(fd, HIDIOCSFEATURE(BOOT_REPORT_SIZE), report) == BOOT_REPORT_SIZE;
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   bootpacket.h
+ * The host side of the bootloader protocol (boot_protocol.h): row
+ * packing, the CRC, and one command/answer exchange over the
+ * bootloader's hidraw node. The restart request goes to the
+ * application's interface 1 as Feature report BOOT_REPORT_ID.
+ */
+
+#ifndef BOOTPACKET_H
+#define BOOTPACKET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "boot_protocol.h"
+
+/** Pack one row of 14-bit words, 4 words in 7 bytes, into BOOT_ROW_BYTES. */
+void BootPacket_PackRow(const uint16_t *words, uint8_t *out);
+
+/** CRC-16/CCITT-FALSE of the words, each taken as 2 bytes little-endian. */
+uint16_t BootPacket_Crc16(const uint16_t *words, unsigned count);
+
+/**
+ * Send one command and wait for its answer.
+ * @param data    BOOT_PACKET_SIZE - BOOT_DATA_OFFSET bytes, or NULL
+ * @param answer  BOOT_PACKET_SIZE bytes
+ * @return false on I/O errors, a timeout or an answer to another command;
+ *         the status is left in answer[1]
+ */
+bool BootPacket_Command(int fd, uint8_t cmd, uint16_t address, uint16_t count,
+                        const uint8_t *data, uint8_t *answer, int timeoutMs);
+
+/** Ask the application on interface 1 to restart into the bootloader. */
+bool BootPacket_Request(int fd);
+
+#endif /* BOOTPACKET_H */
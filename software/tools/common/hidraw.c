@@ -0,0 +1,134 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <limits.h>
+
+#include "hidraw.h"
+
+#define SYS_HIDRAW  "/sys/class/hidraw"
+
+static bool readLine(const char *path, char *buf, size_t size)
+{
+    FILE *fp = fopen(path, "r");
+    bool ok;
+
+    if (fp == NULL) return false;
+    ok = fgets(buf, (int)size, fp) != NULL;
+    fclose(fp);
+    if (ok) buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+/* HID_ID=0003:000004D8:0000E76C and HID_PHYS=usb-0000:00:14.0-1/input0 */
+static bool readUevent(const char *node, unsigned *vendor, unsigned *product, char *phys, size_t size)
+{
+    char path[PATH_MAX], line[256];
+    FILE *fp;
+    bool haveId = false;
+
+    snprintf(path, sizeof(path), SYS_HIDRAW "/%s/device/uevent", node);
+    fp = fopen(path, "r");
+    if (fp == NULL) return false;
+    phys[0] = '\0';
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        unsigned bus;
+
+        line[strcspn(line, "\n")] = '\0';
+        if (sscanf(line, "HID_ID=%x:%x:%x", &bus, vendor, product) == 3) {
+            haveId = true;
+        } else if (strncmp(line, "HID_PHYS=", 9) == 0) {
+            if (snprintf(phys, size, "%s", line + 9) >= (int)size) phys[0] = '\0';
+        }
+    }
+    fclose(fp);
+    return haveId;
+}
+
+/* "1ms" or "125us" in ep_8x/interval of the USB interface above the HID device */
+static unsigned readInterval(const char *node)
+{
+    char path[PATH_MAX], dev[PATH_MAX], text[32];
+    DIR *dir;
+    struct dirent *de;
+    unsigned us = 0;
+
+    snprintf(path, sizeof(path), SYS_HIDRAW "/%s/device/..", node);
+    if (realpath(path, dev) == NULL) return 0;
+    dir = opendir(dev);
+    if (dir == NULL) return 0;
+    while ((de = readdir(dir)) != NULL) {
+        unsigned v;
+        char unit[8];
+
+        if (strncmp(de->d_name, "ep_8", 4) != 0) continue;
+        if (snprintf(path, sizeof(path), "%s/%s/interval", dev, de->d_name) >= (int)sizeof(path)) continue;
+        if (!readLine(path, text, sizeof(text))) continue;
+        if (sscanf(text, "%u%7s", &v, unit) != 2) continue;
+        us = strcmp(unit, "ms") == 0 ? v * 1000 : v;
+        break;
+    }
+    closedir(dir);
+    return us;
+}
+
+static int byName(const void *a, const void *b)
+{
+    return strcmp(((const HIDRAW_PAD *)a)->name, ((const HIDRAW_PAD *)b)->name);
+}
+
+int Hidraw_FindPads(uint16_t vendor, uint16_t product, HIDRAW_PAD *pads, int max)
+{
+    DIR *dir = opendir(SYS_HIDRAW);
+    struct dirent *de;
+    int n = 0;
+
+    if (dir == NULL) return 0;
+    while ((de = readdir(dir)) != NULL) {
+        unsigned v, p, intf = 0;
+        char phys[HIDRAW_PATH_MAX];
+        char *slash;
+        int i;
+
+        if (strncmp(de->d_name, "hidraw", 6) != 0 || strlen(de->d_name) > 16) continue;
+        if (!readUevent(de->d_name, &v, &p, phys, sizeof(phys))) continue;
+        if (v != vendor || p != product) continue;
+
+        slash = strrchr(phys, '/');
+        if (slash != NULL && sscanf(slash, "/input%u", &intf) == 1) *slash = '\0';
+        if (intf > 1) continue;
+
+        for (i = 0; i < n; i++) {
+            if (strcmp(pads[i].name, phys) == 0) break;
+        }
+        if (i == n) {
+            if (n == max) continue;
+            memset(&pads[n], 0, sizeof(pads[n]));
+            snprintf(pads[n].name, sizeof(pads[n].name), "%s", phys);
+            n++;
+        }
+        snprintf(pads[i].node[intf], sizeof(pads[i].node[intf]), "/dev/%.16s", de->d_name);
+        if (intf == 0) pads[i].intervalUs = readInterval(de->d_name);
+    }
+    closedir(dir);
+    qsort(pads, (size_t)n, sizeof(pads[0]), byName);
+    return n;
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   hidraw.h
+ * Finds the pads among the hidraw nodes through sysfs. A pad has one
+ * node per HID interface: the gamepad (interface 0) and the vendor
+ * interface (1) with the feature reports and the extended input report.
+ * The keyboard (interface 2, keyboard.h) is left out.
+ * Nodes are grouped by their HID_PHYS without the "/inputN" suffix, so
+ * uhid devices that follow the usbhid naming group the same way.
+ */
+
+#ifndef HIDRAW_H
+#define HIDRAW_H
+
+#include <stdint.h>
+
+#define HIDRAW_PATH_MAX     64
+
+typedef struct
+{
+    char     name[HIDRAW_PATH_MAX];     // HID_PHYS without the interface
+    char     node[2][HIDRAW_PATH_MAX];  // /dev/hidrawN per interface, "" if absent
+    unsigned intervalUs;                // interface 0 IN endpoint, 0 if unknown
+} HIDRAW_PAD;
+
+/**
+ * Fill pads with every device of vendor:product, sorted by name.
+ * @return number of pads found, at most max
+ */
+int Hidraw_FindPads(uint16_t vendor, uint16_t product, HIDRAW_PAD *pads, int max);
+
+#endif /* HIDRAW_H */
@@ -0,0 +1,145 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "ihex.h"
+
+static int hexByte(const char *s)
+{
+    int v = 0;
+    for (int i = 0; i < 2; i++) {
+        int c = toupper((unsigned char)s[i]);
+        if (c >= '0' && c <= '9') {
+            v = (v << 4) | (c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            v = (v << 4) | (c - 'A' + 10);
+        } else {
+            return -1;
+        }
+    }
+    return v;
+}
+
+void Ihex_Clear(IHEX_IMAGE *img)
+{
+    memset(img, 0, sizeof(*img));
+    for (unsigned i = 0; i < IHEX_PROGMEM_WORDS; i++) img->progmem[i] = IHEX_BLANK;
+    for (unsigned i = 0; i < IHEX_CONFIG_WORDS; i++) img->config[i] = IHEX_BLANK;
+    img->lowest = 0xFFFF;
+}
+
+/* store one byte at a byte address; words are little endian */
+static void putByte(IHEX_IMAGE *img, uint32_t byteAddr, uint8_t b)
+{
+    uint32_t word = byteAddr >> 1;
+    uint16_t *dst;
+    bool *used;
+
+    if (word < IHEX_PROGMEM_WORDS) {
+        dst = &img->progmem[word];
+        used = &img->used[word];
+    } else if (word >= IHEX_CONFIG_BASE && word < IHEX_CONFIG_BASE + IHEX_CONFIG_WORDS) {
+        dst = &img->config[word - IHEX_CONFIG_BASE];
+        used = &img->config_used[word - IHEX_CONFIG_BASE];
+    } else {
+        return;     // EEPROM or out of range, not present on this part
+    }
+
+    if (byteAddr & 1) {
+        *dst = (uint16_t)((*dst & 0x00FF) | ((b & 0x3F) << 8));
+    } else {
+        *dst = (uint16_t)((*dst & 0x3F00) | b);
+    }
+
+    if (!*used && word < IHEX_PROGMEM_WORDS) {
+        img->count++;
+        if (word < img->lowest) img->lowest = (uint16_t)word;
+        if (word > img->highest) img->highest = (uint16_t)word;
+    }
+    *used = true;
+}
+
+bool Ihex_Load(const char *path, IHEX_IMAGE *img)
+{
+    FILE *fp = fopen(path, "r");
+    char line[600];
+    uint32_t base = 0;
+    unsigned lineNo = 0;
+
+    Ihex_Clear(img);
+    if (fp == NULL) {
+        perror(path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        uint8_t rec[256 + 5];
+        size_t len;
+        int n, sum = 0;
+
+        lineNo++;
+        len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if (len == 0) continue;
+        if (line[0] != ':' || len < 11 || (len - 1) % 2 != 0) {
+            fprintf(stderr, "%s:%u: malformed record\n", path, lineNo);
+            fclose(fp);
+            return false;
+        }
+
+        n = (int)(len - 1) / 2;
+        for (int i = 0; i < n; i++) {
+            int b = hexByte(&line[1 + i * 2]);
+            if (b < 0) {
+                fprintf(stderr, "%s:%u: bad hex digit\n", path, lineNo);
+                fclose(fp);
+                return false;
+            }
+            rec[i] = (uint8_t)b;
+            sum += b;
+        }
+        if ((sum & 0xFF) != 0 || rec[0] + 5 != n) {
+            fprintf(stderr, "%s:%u: checksum or length mismatch\n", path, lineNo);
+            fclose(fp);
+            return false;
+        }
+
+        switch (rec[3]) {
+            case 0x00:  // data
+                for (int i = 0; i < rec[0]; i++) {
+                    putByte(img, base + ((uint32_t)rec[1] << 8 | rec[2]) + (uint32_t)i, rec[4 + i]);
+                }
+                break;
+            case 0x01:  // end of file
+                fclose(fp);
+                return true;
+            case 0x02:  // extended segment address
+                base = ((uint32_t)rec[4] << 8 | rec[5]) << 4;
+                break;
+            case 0x04:  // extended linear address
+                base = ((uint32_t)rec[4] << 8 | rec[5]) << 16;
+                break;
+            default:    // start address records carry nothing for PIC
+                break;
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
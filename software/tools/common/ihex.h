@@ -0,0 +1,62 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   ihex.h
+ * Intel HEX reader for PIC16F1 images produced by XC8.
+ *
+ * XC8 writes byte addresses (2 bytes per 14-bit word, little endian).
+ * The image is returned as an array of program words, configuration
+ * space (byte address 0x10000 and up, word 0x8000) included.
+ */
+
+#ifndef IHEX_H
+#define IHEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IHEX_PROGMEM_WORDS  0x2000u     // PIC16F1459: 8K words
+#define IHEX_CONFIG_BASE    0x8000u     // user ID / config words
+#define IHEX_CONFIG_WORDS   0x0010u
+#define IHEX_BLANK          0x3FFFu
+
+typedef struct
+{
+    uint16_t progmem[IHEX_PROGMEM_WORDS];
+    bool     used[IHEX_PROGMEM_WORDS];      // word was present in the file
+    uint16_t config[IHEX_CONFIG_WORDS];
+    bool     config_used[IHEX_CONFIG_WORDS];
+    uint16_t lowest;                        // lowest used program word
+    uint16_t highest;                       // highest used program word
+    uint16_t count;                         // number of used program words
+} IHEX_IMAGE;
+
+/**
+ * Load an Intel HEX file into a blank (0x3FFF filled) image.
+ * @param path HEX file path
+ * @param img  image to fill
+ * @return true on success; false on I/O, checksum or record errors
+ *         (a message is printed to stderr)
+ */
+bool Ihex_Load(const char *path, IHEX_IMAGE *img);
+
+/**
+ * Reset an image to blank flash.
+ */
+void Ihex_Clear(IHEX_IMAGE *img);
+
+#endif /* IHEX_H */
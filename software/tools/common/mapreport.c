@@ -0,0 +1,162 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+#include "mapreport.h"
+
+#define OFS_VER     1
+#define OFS_CRC     2
+#define OFS_NORMAL  8
+#define OFS_SPECIAL 24
+
+uint8_t MapReport_Crc8(const uint8_t *d, unsigned len)
+{
+    uint8_t c = 0;
+
+    while (len--) {
+        c ^= *d++;
+        for (int i = 0; i < 8; i++) {
+            c = (uint8_t)((c & 0x80) ? ((c << 1) ^ 0x07) : (c << 1));
+        }
+    }
+    return c;
+}
+
+/* as Mapping_Save() takes it: report ID and CRC byte as 0 */
+static uint8_t crcOf(const uint8_t *report)
+{
+    uint8_t copy[MAPREPORT_SIZE];
+
+    memcpy(copy, report, sizeof(copy));
+    copy[0] = 0x00;
+    copy[OFS_CRC] = 0x00;
+    return MapReport_Crc8(copy, MAPREPORT_SIZE - 1);
+}
+
+static bool parseTable(const char *path, int line, char *rest, uint8_t *tbl)
+{
+    for (int i = 0; i < MAPREPORT_BUTTONS; i++) {
+        char *tok = strtok(i == 0 ? rest : NULL, " \t\r\n,");
+        char *end;
+        long v;
+
+        if (tok == NULL) {
+            fprintf(stderr, "%s:%d: %d usages needed\n", path, line, MAPREPORT_BUTTONS);
+            return false;
+        }
+        v = strtol(tok, &end, 0);
+        if (*end != '\0' || v < 1 || v > MAPREPORT_USAGE_MAX) {
+            fprintf(stderr, "%s:%d: bad usage '%s' (1-%d)\n", path, line, tok, MAPREPORT_USAGE_MAX);
+            return false;
+        }
+        tbl[i] = (uint8_t)v;
+    }
+    if (strtok(NULL, " \t\r\n,") != NULL) {
+        fprintf(stderr, "%s:%d: more than %d usages\n", path, line, MAPREPORT_BUTTONS);
+        return false;
+    }
+    return true;
+}
+
+bool MapReport_LoadProfile(const char *path, MAP_PROFILE *prof)
+{
+    FILE *fp = fopen(path, "r");
+    char buf[256];
+    int line = 0;
+    bool haveNormal = false, haveSpecial = false, ok = true;
+
+    if (fp == NULL) {
+        perror(path);
+        return false;
+    }
+    while (ok && fgets(buf, sizeof(buf), fp) != NULL) {
+        char *p = buf, *word;
+
+        line++;
+        buf[strcspn(buf, "#")] = '\0';
+        word = strtok_r(p, " \t\r\n", &p);
+        if (word == NULL) continue;
+        if (strcmp(word, "normal") == 0) {
+            ok = parseTable(path, line, p, prof->normal);
+            haveNormal = true;
+        } else if (strcmp(word, "special") == 0) {
+            ok = parseTable(path, line, p, prof->special);
+            haveSpecial = true;
+        } else {
+            fprintf(stderr, "%s:%d: expected 'normal' or 'special'\n", path, line);
+            ok = false;
+        }
+    }
+    fclose(fp);
+    if (ok && !(haveNormal && haveSpecial)) {
+        fprintf(stderr, "%s: needs both a normal and a special line\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+void MapReport_WriteProfile(FILE *fp, const MAP_PROFILE *prof)
+{
+    fprintf(fp, "#       A  B  C  X  Y  Z  L  R  START\n");
+    fprintf(fp, "normal ");
+    for (int i = 0; i < MAPREPORT_BUTTONS; i++) fprintf(fp, " %2u", prof->normal[i]);
+    fprintf(fp, "\nspecial");
+    for (int i = 0; i < MAPREPORT_BUTTONS; i++) fprintf(fp, " %2u", prof->special[i]);
+    fputc('\n', fp);
+}
+
+void MapReport_ToProfile(const uint8_t *report, MAP_PROFILE *prof)
+{
+    memcpy(prof->normal, &report[OFS_NORMAL], MAPREPORT_BUTTONS);
+    memcpy(prof->special, &report[OFS_SPECIAL], MAPREPORT_BUTTONS);
+}
+
+void MapReport_Build(uint8_t *report, const MAP_PROFILE *prof, const uint8_t *prev)
+{
+    // what Mapping_Save() does to its RAM copy
+    memcpy(report, prev, MAPREPORT_SIZE);
+    memcpy(&report[OFS_NORMAL], prof->normal, MAPREPORT_BUTTONS);
+    memcpy(&report[OFS_SPECIAL], prof->special, MAPREPORT_BUTTONS);
+    report[0] = MAPREPORT_ID;
+    if (!MapReport_Valid(prev)) {
+        report[OFS_VER] = MAPREPORT_VER;
+    }
+    report[OFS_CRC] = crcOf(report);
+}
+
+bool MapReport_Valid(const uint8_t *report)
+{
+    return report[OFS_VER] >= MAPREPORT_VER_OLDEST && report[OFS_VER] <= MAPREPORT_VER
+        && report[OFS_CRC] == crcOf(report);
+}
+
+bool MapReport_Get(int fd, uint8_t *report)
+{
+    memset(report, 0, MAPREPORT_SIZE);
+    report[0] = MAPREPORT_ID;
+    return ioctl(fd, HIDIOCGFEATURE(MAPREPORT_SIZE), report) == MAPREPORT_SIZE;
+}
+
+bool MapReport_Set(int fd, const uint8_t *report)
+{
+    return ioctl(fd, HIDIOCSFEATURE(MAPREPORT_SIZE), report) == MAPREPORT_SIZE;
+}
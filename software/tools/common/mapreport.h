@@ -0,0 +1,88 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   mapreport.h
+ * The button mapping Feature report of interface 1 (mapping.c), as the
+ * host sees it through hidraw:
+ *
+ *   0      report ID (MAPREPORT_ID)
+ *   1      version, 1 (MAPREPORT_VER_OLDEST) up to MAPREPORT_VER
+ *   2      CRC8, polynomial 0x07
+ *   8-16   normal mode usage per button, A B C X Y Z L R START
+ *   24-32  special mode usage per button
+ *   40-52  version 2 on: keyboard keycode per button, the nine above
+ *          then UP DOWN LEFT RIGHT (keyboard.h), 0 for none
+ *
+ * The CRC runs over bytes 0-62 with the report ID and the CRC byte
+ * taken as 0. The firmware takes the two tables from a SET_REPORT, and
+ * the keycodes too if the report is version 2 or later and they are all
+ * keys; it keeps the other bytes as they were. MapReport_Build() sends
+ * the version and the keycodes of the report read before, so a pad
+ * keeps its keys whatever firmware it runs.
+ */
+
+#ifndef MAPREPORT_H
+#define MAPREPORT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAPREPORT_ID        0x01
+#define MAPREPORT_SIZE      64      // including the report ID
+#define MAPREPORT_VER       0x02
+#define MAPREPORT_VER_OLDEST 0x01
+#define MAPREPORT_BUTTONS   9
+#define MAPREPORT_USAGE_MAX 14
+
+typedef struct
+{
+    uint8_t normal[MAPREPORT_BUTTONS];
+    uint8_t special[MAPREPORT_BUTTONS];
+} MAP_PROFILE;
+
+uint8_t MapReport_Crc8(const uint8_t *d, unsigned len);
+
+/**
+ * Read a profile: "normal" and "special" lines of nine usages each, in
+ * button order. '#' starts a comment.
+ * @return false on I/O or syntax errors (a message is printed to stderr)
+ */
+bool MapReport_LoadProfile(const char *path, MAP_PROFILE *prof);
+
+void MapReport_WriteProfile(FILE *fp, const MAP_PROFILE *prof);
+
+void MapReport_ToProfile(const uint8_t *report, MAP_PROFILE *prof);
+
+/**
+ * The report the pad answers with after prof is written to it, which is
+ * also what to send.
+ * @param prev the report it answered with before
+ */
+void MapReport_Build(uint8_t *report, const MAP_PROFILE *prof, const uint8_t *prev);
+
+/**
+ * Check the version (any the tools know) and the CRC of a report the pad
+ * sent.
+ */
+bool MapReport_Valid(const uint8_t *report);
+
+/* HIDIOCGFEATURE / HIDIOCSFEATURE on an interface 1 hidraw fd */
+bool MapReport_Get(int fd, uint8_t *report);
+bool MapReport_Set(int fd, const uint8_t *report);
+
+#endif /* MAPREPORT_H */
@@ -0,0 +1,61 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "padcmd.h"
+
+static uint8_t nextTag;
+
+static int64_t nowMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+bool PadCmd_Exchange(int fd, uint8_t cmd, const uint8_t *data, unsigned len,
+                     uint8_t *answer, int timeoutMs)
+{
+    uint8_t out[CMD_REPORT_SIZE] = { CMD_REPORT_ID, cmd };
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    int64_t deadline = nowMs() + timeoutMs;
+
+    // one tag per exchange, so a late answer to an earlier one is not taken
+    out[2] = __atomic_fetch_add(&nextTag, 1, __ATOMIC_RELAXED);
+    if (data != NULL) {
+        if (len > CMD_REPORT_SIZE - CMD_DATA_OFFSET) len = CMD_REPORT_SIZE - CMD_DATA_OFFSET;
+        memcpy(&out[CMD_DATA_OFFSET], data, len);
+    }
+    if (write(fd, out, sizeof(out)) != (ssize_t)sizeof(out)) return false;
+
+    for (;;) {
+        int64_t left = deadline - nowMs();
+        ssize_t n;
+
+        if (left <= 0 || poll(&pfd, 1, (int)left) != 1) return false;
+        n = read(fd, answer, CMD_REPORT_SIZE);
+        if (n < 0) return false;
+        if (n == CMD_REPORT_SIZE && answer[0] == CMD_REPORT_ID && answer[1] == cmd && answer[2] == out[2]) {
+            return true;
+        }
+    }
+}
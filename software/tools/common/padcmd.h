@@ -0,0 +1,43 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   padcmd.h
+ * The host side of the configuration commands (command.h): one
+ * command/answer exchange over the interface 1 hidraw node. The write
+ * goes to the interrupt OUT endpoint; the extended input reports that
+ * arrive on the same node while waiting are skipped.
+ */
+
+#ifndef PADCMD_H
+#define PADCMD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "command.h"
+
+/**
+ * Send one command and wait for its answer.
+ * @param data    up to CMD_REPORT_SIZE - CMD_DATA_OFFSET bytes, or NULL
+ * @param answer  CMD_REPORT_SIZE bytes
+ * @return false on I/O errors or a timeout, including a pad without the
+ *         command endpoint; the status is left in answer[3]
+ */
+bool PadCmd_Exchange(int fd, uint8_t cmd, const uint8_t *data, unsigned len,
+                     uint8_t *answer, int timeoutMs);
+
+#endif /* PADCMD_H */
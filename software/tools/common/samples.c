@@ -0,0 +1,82 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "samples.h"
+
+void Sample_Add(SAMPLES *s, uint32_t v)
+{
+    if (s->n == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 1024;
+        s->v = realloc(s->v, s->cap * sizeof(uint32_t));
+        if (s->v == NULL) {
+            perror("samples");
+            exit(1);
+        }
+    }
+    s->v[s->n++] = v;
+}
+
+static int cmpU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void Sample_Stats(const SAMPLES *s, SAMPLE_STATS *st)
+{
+    uint32_t *sorted;
+
+    memset(st, 0, sizeof(*st));
+    st->count = s->n;
+    if (s->n == 0) return;
+
+    sorted = malloc(s->n * sizeof(uint32_t));
+    if (sorted == NULL) {
+        perror("samples");
+        exit(1);
+    }
+    memcpy(sorted, s->v, s->n * sizeof(uint32_t));
+    qsort(sorted, s->n, sizeof(uint32_t), cmpU32);
+    for (size_t i = 0; i < s->n; i++) st->total += sorted[i];
+    st->min = sorted[0];
+    st->max = sorted[s->n - 1];
+    st->mean = (double)st->total / (double)s->n;
+    st->p50 = sorted[(s->n - 1) * 50 / 100];
+    st->p90 = sorted[(s->n - 1) * 90 / 100];
+    st->p99 = sorted[(s->n - 1) * 99 / 100];
+    free(sorted);
+}
+
+void Sample_WriteJson(FILE *fp, const SAMPLES *s)
+{
+    SAMPLE_STATS st;
+
+    Sample_Stats(s, &st);
+    fprintf(fp, "\"count\": %zu, \"total\": %llu, \"min\": %u, \"max\": %u, "
+                "\"mean\": %.1f, \"p50\": %u, \"p90\": %u, \"p99\": %u",
+            st.count, (unsigned long long)st.total, st.min, st.max,
+            st.mean, st.p50, st.p90, st.p99);
+}
+
+void Sample_Free(SAMPLES *s)
+{
+    free(s->v);
+    memset(s, 0, sizeof(*s));
+}
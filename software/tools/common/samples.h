@@ -0,0 +1,59 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   samples.h
+ * Sample sets with min/max/mean/percentile summaries, written as the
+ * JSON objects the bench results use.
+ */
+
+#ifndef SAMPLES_H
+#define SAMPLES_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t *v;
+    size_t    n;
+    size_t    cap;
+} SAMPLES;
+
+typedef struct
+{
+    size_t   count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+    double   mean;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+} SAMPLE_STATS;
+
+void Sample_Add(SAMPLES *s, uint32_t v);
+void Sample_Stats(const SAMPLES *s, SAMPLE_STATS *st);
+
+/**
+ * Write a SAMPLE_STATS object body ("count": ..., "min": ...) as JSON.
+ */
+void Sample_WriteJson(FILE *fp, const SAMPLES *s);
+
+void Sample_Free(SAMPLES *s);
+
+#endif /* SAMPLES_H */
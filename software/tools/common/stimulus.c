@@ -0,0 +1,209 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include "stimulus.h"
+
+/* button wiring, see io_mapping.h */
+static const struct
+{
+    const char *name;
+    uint8_t port;
+    uint8_t bit;
+} buttons[] = {
+    { "X", 0, 5 }, { "TR", 0, 4 },
+    { "START", 1, 7 }, { "LEFT", 1, 6 }, { "UP", 1, 5 }, { "RIGHT", 1, 4 },
+    { "A", 2, 7 }, { "B", 2, 6 }, { "Y", 2, 5 }, { "Z", 2, 4 },
+    { "C", 2, 3 }, { "DOWN", 2, 2 }, { "TL", 2, 1 },
+};
+
+bool Stim_ParseTime(const char *text, double *us)
+{
+    char *end;
+    double v = strtod(text, &end);
+
+    if (end == text || v < 0) return false;
+    if (strcmp(end, "us") == 0) {
+        *us = v;
+    } else if (strcmp(end, "ms") == 0) {
+        *us = v * 1e3;
+    } else if (strcmp(end, "s") == 0) {
+        *us = v * 1e6;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parseTarget(const char *t, uint8_t *port, uint8_t *mask, bool *isButton)
+{
+    *isButton = false;
+    for (unsigned i = 0; i < sizeof(buttons) / sizeof(buttons[0]); i++) {
+        if (strcasecmp(t, buttons[i].name) == 0) {
+            *port = buttons[i].port;
+            *mask = (uint8_t)(1u << buttons[i].bit);
+            *isButton = true;
+            return true;
+        }
+    }
+    if (strncasecmp(t, "PORT", 4) == 0 && strlen(t) == 5) {
+        int p = toupper((unsigned char)t[4]) - 'A';
+        if (p < 0 || p >= STIM_PORTS) return false;
+        *port = (uint8_t)p;
+        *mask = 0xFF;
+        return true;
+    }
+    if (strlen(t) == 3 && toupper((unsigned char)t[0]) == 'R') {
+        int p = toupper((unsigned char)t[1]) - 'A';
+        int b = t[2] - '0';
+        if (p < 0 || p >= STIM_PORTS || b < 0 || b > 7) return false;
+        *port = (uint8_t)p;
+        *mask = (uint8_t)(1u << b);
+        return true;
+    }
+    return false;
+}
+
+static bool parseValue(const char *v, uint8_t mask, bool isButton, uint8_t *level)
+{
+    char *end;
+    unsigned long n;
+
+    if (strcasecmp(v, "press") == 0 && isButton) {
+        *level = 0;
+        return true;
+    }
+    if (strcasecmp(v, "release") == 0 && isButton) {
+        *level = mask;
+        return true;
+    }
+    n = strtoul(v, &end, 0);
+    if (*end != '\0' || end == v) return false;
+    if (mask == 0xFF) {
+        if (n > 0xFF) return false;
+        *level = (uint8_t)n;
+    } else {
+        if (n > 1) return false;
+        *level = n ? mask : 0;
+    }
+    return true;
+}
+
+static void push(STIMULUS *stim, const STIM_EVENT *e)
+{
+    if (stim->count == stim->cap) {
+        stim->cap = stim->cap ? stim->cap * 2 : 64;
+        stim->ev = realloc(stim->ev, stim->cap * sizeof(STIM_EVENT));
+        if (stim->ev == NULL) {
+            perror("stimulus");
+            exit(1);
+        }
+    }
+    stim->ev[stim->count++] = *e;
+}
+
+/* insertion sort keeps same-time events in file order */
+static void sortByTime(STIMULUS *stim)
+{
+    for (unsigned i = 1; i < stim->count; i++) {
+        STIM_EVENT e = stim->ev[i];
+        unsigned j = i;
+        while (j > 0 && stim->ev[j - 1].timeUs > e.timeUs) {
+            stim->ev[j] = stim->ev[j - 1];
+            j--;
+        }
+        stim->ev[j] = e;
+    }
+}
+
+bool Stim_Load(STIMULUS *stim, const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    unsigned lineNo = 0;
+
+    memset(stim, 0, sizeof(*stim));
+    if (fp == NULL) {
+        perror(path);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char a[64], b[64], c[64];
+        char *hash = strchr(line, '#');
+        int n;
+        STIM_EVENT e;
+        bool isButton;
+
+        lineNo++;
+        if (hash) *hash = '\0';
+        n = sscanf(line, "%63s %63s %63s", a, b, c);
+        if (n <= 0) continue;
+
+        if (n == 2 && strcasecmp(a, "repeat") == 0) {
+            if (!Stim_ParseTime(b, &stim->repeatUs)) goto bad;
+            continue;
+        }
+        if (n != 3
+                || !Stim_ParseTime(a, &e.timeUs)
+                || !parseTarget(b, &e.port, &e.mask, &isButton)
+                || !parseValue(c, e.mask, isButton, &e.level)) {
+            goto bad;
+        }
+        push(stim, &e);
+    }
+    fclose(fp);
+
+    sortByTime(stim);
+    if (stim->repeatUs > 0 && stim->count && stim->ev[stim->count - 1].timeUs >= stim->repeatUs) {
+        fprintf(stderr, "%s: repeat period must be longer than the last event\n", path);
+        return false;
+    }
+    return true;
+
+bad:
+    fprintf(stderr, "%s:%u: bad stimulus line\n", path, lineNo);
+    fclose(fp);
+    return false;
+}
+
+const STIM_EVENT *Stim_Next(STIMULUS *stim, double nowUs)
+{
+    const STIM_EVENT *e;
+
+    if (stim->count == 0) return NULL;
+    if (stim->next == stim->count) {
+        if (stim->repeatUs <= 0) return NULL;
+        stim->next = 0;
+        stim->baseUs += stim->repeatUs;
+    }
+    e = &stim->ev[stim->next];
+    if (stim->baseUs + e->timeUs > nowUs) return NULL;
+    stim->next++;
+    stim->applied++;
+    return e;
+}
+
+void Stim_Free(STIMULUS *stim)
+{
+    free(stim->ev);
+    memset(stim, 0, sizeof(*stim));
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   stimulus.h
+ * Pin stimulus scripts.
+ *
+ * One event per line, '#' starts a comment:
+ *
+ *     <time>  <target>  <value>
+ *
+ *   time    number with a unit: 250us, 4ms, 1.5s
+ *   target  a pin (RA0-RA5, RB4-RB7, RC0-RC7), a whole port
+ *           (PORTA/PORTB/PORTC) or a button name from io_mapping.h
+ *           (A B C X Y Z TL TR START UP DOWN LEFT RIGHT)
+ *   value   press / release for buttons (active low), 0 / 1 for pins,
+ *           a byte for ports
+ *
+ * "repeat <time>" replays the whole script with that period.
+ */
+
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STIM_PORTS      3       // PORTA..PORTC
+
+typedef struct
+{
+    double  timeUs;
+    uint8_t port;
+    uint8_t mask;       // pins affected
+    uint8_t level;      // new levels for those pins
+} STIM_EVENT;
+
+typedef struct
+{
+    STIM_EVENT *ev;
+    unsigned    count;
+    unsigned    cap;
+    unsigned    next;
+    double      repeatUs;   // 0 = play once
+    double      baseUs;     // start of the current repetition
+    unsigned    applied;
+} STIMULUS;
+
+/**
+ * Parse a stimulus script. Errors are reported on stderr.
+ */
+bool Stim_Load(STIMULUS *stim, const char *path);
+
+/**
+ * Next event due at time nowUs (microseconds since the script started),
+ * or NULL when nothing is due yet. Call repeatedly until NULL.
+ */
+const STIM_EVENT *Stim_Next(STIMULUS *stim, double nowUs);
+
+/**
+ * Parse "<number><unit>" into microseconds (units: us, ms, s).
+ */
+bool Stim_ParseTime(const char *text, double *us);
+
+void Stim_Free(STIMULUS *stim);
+
+#endif /* STIMULUS_H */
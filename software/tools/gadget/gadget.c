@@ -0,0 +1,250 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   gadget.c
+ * gadget: the application, HID and descriptor layers of
+ * project_SS_gamepad.X built for Linux and attached as a real USB device
+ * through raw-gadget, normally on dummy_hcd so that host and device are
+ * the same machine. A stimulus script (see common/stimulus.h) drives the
+ * button pins once the device is configured.
+ *
+ * With --latency every stimulus event is timed against the evdev frame
+ * it produces, and the stage statistics are written as JSON.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "system.h"
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "app_device_joystick.h"
+#include "my_app_device_gamepad.h"
+#include "mapping.h"
+#include "telemetry.h"
+#include "scheduler.h"
+#include "history.h"
+
+#include "native.h"
+#include "stimulus.h"
+#include "usb_device_raw.h"
+#include "press_latency.h"
+
+#define STIM_TICK_US        100
+#define EVDEV_TIMEOUT_MS    5000
+#define SETTLE_US           (PRESS_LATENCY_TIMEOUT_US + 100000)
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+
+typedef struct
+{
+    const char *driver;
+    const char *device;
+    const char *stimPath;
+    const char *hefPath;
+    const char *evdevPath;
+    const char *jsonPath;
+    double      runUs;          // 0 = until the stimulus ends (or forever)
+    bool        latency;
+} OPTIONS;
+
+static OPTIONS opt;
+static STIMULUS stim;
+static volatile bool stimDone;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: gadget [options]\n"
+        "  --driver NAME     UDC driver (default: dummy_udc)\n"
+        "  --device NAME     UDC device (default: dummy_udc.0)\n"
+        "  --stim FILE       pin stimulus script, started once the host has\n"
+        "                    configured the device\n"
+        "  --hef FILE        keep the High-Endurance Flash rows (button mapping) here\n"
+        "  --latency         time each stimulus event to its evdev frame\n"
+        "  --evdev PATH      input device for --latency (default: found by VID:PID)\n"
+        "  --time T          run time, e.g. 10s (default: until the stimulus\n"
+        "                    has ended, or forever without --stim)\n"
+        "  --json FILE       write results here (default: stdout)\n");
+    exit(2);
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->driver = "dummy_udc";
+    o->device = "dummy_udc.0";
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "--latency") == 0) {
+            o->latency = true;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--driver") == 0) {
+            o->driver = v;
+        } else if (strcmp(a, "--device") == 0) {
+            o->device = v;
+        } else if (strcmp(a, "--stim") == 0) {
+            o->stimPath = v;
+        } else if (strcmp(a, "--hef") == 0) {
+            o->hefPath = v;
+        } else if (strcmp(a, "--evdev") == 0) {
+            o->evdevPath = v;
+        } else if (strcmp(a, "--time") == 0) {
+            if (!Stim_ParseTime(v, &o->runUs)) {
+                fprintf(stderr, "gadget: --time needs a time such as 10s\n");
+                exit(2);
+            }
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else {
+            usage();
+        }
+    }
+}
+
+static void onSubmit(uint8_t ep, const uint8_t *data, uint8_t len)
+{
+    if (ep == JOYSTICK_EP) PressLatency_Submit(data, len, Native_NowUs());
+}
+
+static void onSent(uint8_t ep)
+{
+    if (ep == JOYSTICK_EP) PressLatency_Sent(Native_NowUs());
+}
+
+/* plays the script in real time from the moment it is started */
+static void *stimThread(void *arg)
+{
+    uint64_t start = Native_NowUs();
+
+    (void)arg;
+    while (stim.repeatUs > 0 || stim.next < stim.count) {
+        uint64_t now = Native_NowUs();
+        const STIM_EVENT *ev;
+        bool any = false;
+
+        while ((ev = Stim_Next(&stim, (double)(now - start))) != NULL) {
+            Native_SetPins(ev->port, ev->mask, ev->level);
+            any = true;
+        }
+        if (any && opt.latency) PressLatency_Stimulus(now);
+        usleep(STIM_TICK_US);
+    }
+    stimDone = true;
+    return NULL;
+}
+
+static void writeJson(FILE *fp, double runUs)
+{
+    fprintf(fp, "{\n  \"tool\": \"gadget\",\n");
+    fprintf(fp, "  \"udc\": \"%s\",\n", opt.device);
+    fprintf(fp, "  \"run_time_us\": %.0f,\n", runUs);
+    fprintf(fp, "  \"stimulus_events\": %u,\n", stim.applied);
+    fprintf(fp, "  \"configured\": %s", USBGetDeviceState() == CONFIGURED_STATE ? "true" : "false");
+    if (opt.latency) {
+        fprintf(fp, ",\n  \"latency\": ");
+        PressLatency_WriteJson(fp);
+    }
+    fprintf(fp, "\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    pthread_t stimTid;
+    bool stimStarted = false;
+    uint64_t start, doneAt = 0;
+    FILE *out = stdout;
+
+    parseArgs(argc, argv, &opt);
+    if (opt.stimPath && !Stim_Load(&stim, opt.stimPath)) return 1;
+    if (!UsbRaw_Open(opt.driver, opt.device)) return 1;
+    if (opt.latency) {
+        UsbRaw_OnSubmit = onSubmit;
+        UsbRaw_OnSent = onSent;
+    }
+
+    Native_NvmOpen(opt.hefPath);
+    Native_Start();
+
+    // what main() of the firmware does before its loop
+    SYSTEM_Initialize(SYSTEM_STATE_USB_START);
+    Telemetry_Initialize();
+    OPTION_REGbits.nWPUEN = 0;
+    Mapping_Load();
+    History_Initialize();
+    App_DeviceGamepadInit();
+    App_DeviceGamepadAct(&joystick_input);
+    USBDeviceInit();
+    USBDeviceAttach();
+    TELEMETRY_Boot(telemetry.bootAttach);
+
+    start = Native_NowUs();
+    for (;;) {
+        uint64_t now;
+
+        if (USBIsDeviceSuspended() == false) {
+            Scheduler_Tasks();
+        } else {
+            // no Sleep or remote wakeup on a raw gadget (power.h): the stack only
+            Telemetry_LoopPass();
+            USBDeviceTasks();
+            Scheduler_Restart();
+        }
+
+        if (!stimStarted && opt.stimPath && USBGetDeviceState() == CONFIGURED_STATE) {
+            // the input device exists once the host has bound the HID driver
+            if (opt.latency
+                    && !PressLatency_Start(device_dsc.idVendor, device_dsc.idProduct, opt.evdevPath, EVDEV_TIMEOUT_MS)) {
+                return 1;
+            }
+            if (pthread_create(&stimTid, NULL, stimThread, NULL) != 0) return 1;
+            stimStarted = true;
+        }
+
+        now = Native_NowUs();
+        if (opt.runUs > 0 && now - start >= opt.runUs) break;
+        if (opt.runUs <= 0 && stimDone) {
+            // leave time for the last press to arrive
+            if (doneAt == 0) doneAt = now;
+            if (now - doneAt >= SETTLE_US) break;
+        }
+    }
+
+    if (opt.jsonPath) {
+        out = fopen(opt.jsonPath, "w");
+        if (out == NULL) {
+            perror(opt.jsonPath);
+            return 1;
+        }
+    }
+    writeJson(out, (double)(Native_NowUs() - start));
+    if (out != stdout) fclose(out);
+
+    PressLatency_Free();
+    Stim_Free(&stim);
+    return 0;
+}
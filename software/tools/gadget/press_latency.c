@@ -0,0 +1,214 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * One press is tracked at a time. Its stages:
+ *
+ *   press   the stimulus thread changed the pins
+ *   report  the firmware queued the first report that differs from the
+ *           one before it
+ *   sent    the raw-gadget write of that report returned
+ *   input   evdev delivered the SYN_REPORT of the frame it produced
+ *
+ * "sent" is informational only: dummy_hcd completes the host URB, and so
+ * runs the HID driver, before the gadget side write returns.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include "samples.h"
+#include "press_latency.h"
+
+#define REPORT_MAX  64
+
+typedef struct
+{
+    bool     active;
+    uint64_t press;
+    uint64_t report;        // 0 = not yet
+    uint64_t sent;
+} PRESS;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t reader;
+static int evfd = -1;
+static PRESS cur;
+static bool waitSent;
+static uint8_t lastReport[REPORT_MAX];
+static uint8_t lastLen;
+static unsigned reports, changed, matched, overlapped, lost;
+static SAMPLES total, firmware, transport, epWrite;
+
+static void finish(uint64_t input)
+{
+    Sample_Add(&total, (uint32_t)(input - cur.press));
+    Sample_Add(&firmware, (uint32_t)(cur.report - cur.press));
+    Sample_Add(&transport, (uint32_t)(input - cur.report));
+    if (cur.sent) Sample_Add(&epWrite, (uint32_t)(cur.sent - cur.report));
+    matched++;
+    cur.active = false;
+}
+
+void PressLatency_Stimulus(uint64_t us)
+{
+    pthread_mutex_lock(&lock);
+    if (cur.active) {
+        if (us - cur.press >= PRESS_LATENCY_TIMEOUT_US) {
+            lost++;
+        } else {
+            overlapped++;
+        }
+    }
+    memset(&cur, 0, sizeof(cur));
+    cur.active = true;
+    cur.press = us;
+    pthread_mutex_unlock(&lock);
+}
+
+void PressLatency_Submit(const uint8_t *report, uint8_t len, uint64_t us)
+{
+    if (len > REPORT_MAX) len = REPORT_MAX;
+
+    pthread_mutex_lock(&lock);
+    reports++;
+    if (len != lastLen || memcmp(report, lastReport, len) != 0) {
+        memcpy(lastReport, report, len);
+        lastLen = len;
+        changed++;
+        if (cur.active && !cur.report) {
+            cur.report = us;
+            waitSent = true;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void PressLatency_Sent(uint64_t us)
+{
+    pthread_mutex_lock(&lock);
+    if (waitSent) {
+        if (cur.active) cur.sent = us;
+        waitSent = false;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+static void *readerThread(void *arg)
+{
+    struct input_event ev[16];
+    bool pending = false;       // key/abs events since the last SYN_REPORT
+
+    (void)arg;
+    for (;;) {
+        ssize_t n = read(evfd, ev, sizeof(ev));
+
+        if (n <= 0) break;
+        for (size_t i = 0; i < (size_t)n / sizeof(ev[0]); i++) {
+            if (ev[i].type == EV_KEY || ev[i].type == EV_ABS) {
+                pending = true;
+            } else if (ev[i].type == EV_SYN && ev[i].code == SYN_REPORT && pending) {
+                uint64_t us = (uint64_t)ev[i].input_event_sec * 1000000u + (uint64_t)ev[i].input_event_usec;
+
+                pending = false;
+                pthread_mutex_lock(&lock);
+                if (cur.active && cur.report) finish(us);
+                pthread_mutex_unlock(&lock);
+            }
+        }
+    }
+    return NULL;
+}
+
+static int findDevice(uint16_t vendor, uint16_t product)
+{
+    for (int i = 0; i < 64; i++) {
+        char path[32];
+        struct input_id id;
+        int fd;
+
+        snprintf(path, sizeof(path), "/dev/input/event%d", i);
+        fd = open(path, O_RDONLY);
+        if (fd < 0) continue;
+        if (ioctl(fd, EVIOCGID, &id) == 0 && id.vendor == vendor && id.product == product) {
+            return fd;
+        }
+        close(fd);
+    }
+    return -1;
+}
+
+bool PressLatency_Start(uint16_t vendor, uint16_t product, const char *path, unsigned timeoutMs)
+{
+    int clock = CLOCK_MONOTONIC;
+
+    for (unsigned ms = 0; evfd < 0 && ms <= timeoutMs; ms += 50) {
+        evfd = path ? open(path, O_RDONLY) : findDevice(vendor, product);
+        if (evfd < 0) usleep(50000);
+    }
+    if (evfd < 0) {
+        if (path) {
+            perror(path);
+        } else {
+            fprintf(stderr, "gadget: no input device %04x:%04x\n", vendor, product);
+        }
+        return false;
+    }
+    if (ioctl(evfd, EVIOCSCLOCKID, &clock) < 0) {
+        perror("EVIOCSCLOCKID");
+        return false;
+    }
+    return pthread_create(&reader, NULL, readerThread, NULL) == 0;
+}
+
+static void writeStage(FILE *fp, const char *name, const SAMPLES *s, bool last)
+{
+    fprintf(fp, "    \"%s\": { ", name);
+    Sample_WriteJson(fp, s);
+    fprintf(fp, " }%s\n", last ? "" : ",");
+}
+
+void PressLatency_WriteJson(FILE *fp)
+{
+    pthread_mutex_lock(&lock);
+    if (cur.active) lost++;
+    cur.active = false;
+    fprintf(fp, "{\n    \"reports\": %u,\n    \"changed_reports\": %u,\n", reports, changed);
+    fprintf(fp, "    \"matched\": %u,\n    \"overlapped\": %u,\n    \"lost\": %u,\n",
+            matched, overlapped, lost);
+    writeStage(fp, "press_to_input_us", &total, false);
+    writeStage(fp, "press_to_report_us", &firmware, false);
+    writeStage(fp, "report_to_input_us", &transport, false);
+    writeStage(fp, "report_to_sent_us", &epWrite, true);
+    fprintf(fp, "  }");
+    pthread_mutex_unlock(&lock);
+}
+
+void PressLatency_Free(void)
+{
+    Sample_Free(&total);
+    Sample_Free(&firmware);
+    Sample_Free(&transport);
+    Sample_Free(&epWrite);
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   press_latency.h
+ * Press-to-input latency of the gadget: each stimulus event is matched
+ * with the next changed IN report and the evdev frame it produces on
+ * the host side of dummy_hcd. All times are CLOCK_MONOTONIC in us.
+ */
+
+#ifndef PRESS_LATENCY_H
+#define PRESS_LATENCY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PRESS_LATENCY_TIMEOUT_US 1000000     // a press not seen on evdev by then is lost
+
+/**
+ * Find the input device of vendor:product (or open path when given),
+ * switch its timestamps to CLOCK_MONOTONIC and start reading it.
+ * Waits up to timeoutMs for the device to appear.
+ */
+bool PressLatency_Start(uint16_t vendor, uint16_t product, const char *path, unsigned timeoutMs);
+
+/* stimulus thread: pins changed */
+void PressLatency_Stimulus(uint64_t us);
+
+/* firmware thread: a packet was queued on an IN endpoint */
+void PressLatency_Submit(const uint8_t *report, uint8_t len, uint64_t us);
+
+/* endpoint thread: the host has read the packet */
+void PressLatency_Sent(uint64_t us);
+
+/**
+ * Write the "latency" object: matched/overlapped/lost counts and the
+ * stage statistics.
+ */
+void PressLatency_WriteJson(FILE *fp);
+
+void PressLatency_Free(void);
+
+#endif /* PRESS_LATENCY_H */
@@ -0,0 +1,160 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/usb/ch9.h>
+#include <linux/usb/raw_gadget.h>
+
+#include "raw.h"
+
+#define EP0_MAX_DATA    1024
+
+/* struct usb_raw_ep_io followed by its data */
+typedef struct
+{
+    struct usb_raw_ep_io io;
+    uint8_t data[EP0_MAX_DATA];
+} RAW_IO;
+
+int Raw_Open(const char *driver, const char *device)
+{
+    struct usb_raw_init init;
+    int fd = open("/dev/raw-gadget", O_RDWR);
+
+    if (fd < 0) return -1;
+    memset(&init, 0, sizeof(init));
+    snprintf((char *)init.driver_name, sizeof(init.driver_name), "%s", driver);
+    snprintf((char *)init.device_name, sizeof(init.device_name), "%s", device);
+    init.speed = USB_SPEED_FULL;
+    if (ioctl(fd, USB_RAW_IOCTL_INIT, &init) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool Raw_Run(int fd)
+{
+    return ioctl(fd, USB_RAW_IOCTL_RUN, 0) >= 0;
+}
+
+bool Raw_FetchEvent(int fd, RAW_EVENT *ev)
+{
+    struct
+    {
+        struct usb_raw_event ev;
+        uint8_t data[sizeof(struct usb_ctrlrequest)];
+    } buf;
+
+    memset(&buf, 0, sizeof(buf));
+    buf.ev.length = sizeof(buf.data);
+    if (ioctl(fd, USB_RAW_IOCTL_EVENT_FETCH, &buf) < 0) return false;
+    ev->type = buf.ev.type;
+    ev->length = buf.ev.length;
+    memcpy(ev->data, buf.data, sizeof(ev->data));
+    return true;
+}
+
+int Raw_Ep0Write(int fd, const uint8_t *data, unsigned len, bool zlp)
+{
+    RAW_IO io;
+
+    if (len > EP0_MAX_DATA) len = EP0_MAX_DATA;
+    io.io.ep = 0;
+    io.io.flags = zlp ? USB_RAW_IO_FLAGS_ZERO : 0;
+    io.io.length = len;
+    if (len) memcpy(io.data, data, len);
+    return ioctl(fd, USB_RAW_IOCTL_EP0_WRITE, &io);
+}
+
+int Raw_Ep0Read(int fd, uint8_t *data, unsigned len)
+{
+    RAW_IO io;
+    int n;
+
+    if (len > EP0_MAX_DATA) len = EP0_MAX_DATA;
+    io.io.ep = 0;
+    io.io.flags = 0;
+    io.io.length = len;
+    n = ioctl(fd, USB_RAW_IOCTL_EP0_READ, &io);
+    if (n > 0 && data != NULL) memcpy(data, io.data, (size_t)n);
+    return n;
+}
+
+bool Raw_Ep0Stall(int fd)
+{
+    return ioctl(fd, USB_RAW_IOCTL_EP0_STALL, 0) >= 0;
+}
+
+int Raw_EpEnable(int fd, const uint8_t desc[7])
+{
+    struct usb_endpoint_descriptor ep;
+
+    memset(&ep, 0, sizeof(ep));
+    ep.bLength = USB_DT_ENDPOINT_SIZE;
+    ep.bDescriptorType = USB_DT_ENDPOINT;
+    ep.bEndpointAddress = desc[2];
+    ep.bmAttributes = desc[3];
+    ep.wMaxPacketSize = (uint16_t)(desc[4] | desc[5] << 8);
+    ep.bInterval = desc[6];
+    return ioctl(fd, USB_RAW_IOCTL_EP_ENABLE, &ep);
+}
+
+bool Raw_EpDisable(int fd, int handle)
+{
+    return ioctl(fd, USB_RAW_IOCTL_EP_DISABLE, (unsigned long)handle) >= 0;
+}
+
+int Raw_EpWrite(int fd, int handle, const uint8_t *data, unsigned len)
+{
+    RAW_IO io;
+
+    if (len > EP0_MAX_DATA) len = EP0_MAX_DATA;
+    io.io.ep = (uint16_t)handle;
+    io.io.flags = 0;
+    io.io.length = len;
+    memcpy(io.data, data, len);
+    return ioctl(fd, USB_RAW_IOCTL_EP_WRITE, &io);
+}
+
+int Raw_EpRead(int fd, int handle, uint8_t *data, unsigned len)
+{
+    RAW_IO io;
+    int n;
+
+    if (len > EP0_MAX_DATA) len = EP0_MAX_DATA;
+    io.io.ep = (uint16_t)handle;
+    io.io.flags = 0;
+    io.io.length = len;
+    n = ioctl(fd, USB_RAW_IOCTL_EP_READ, &io);
+    if (n > 0) memcpy(data, io.data, (size_t)n);
+    return n;
+}
+
+bool Raw_Configure(int fd)
+{
+    return ioctl(fd, USB_RAW_IOCTL_CONFIGURE, 0) >= 0;
+}
+
+bool Raw_VbusDraw(int fd, unsigned maxPower)
+{
+    return ioctl(fd, USB_RAW_IOCTL_VBUS_DRAW, (unsigned long)maxPower) >= 0;
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   raw.h
+ * Thin wrapper around the Linux raw-gadget interface (/dev/raw-gadget).
+ *
+ * Kept apart from the MLA headers: <linux/usb/ch9.h> and usb_ch9.h
+ * define many of the same names.
+ */
+
+#ifndef RAW_H
+#define RAW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* event types; RESET and later exist since Linux 5.19 */
+#define RAW_EVENT_CONNECT       1
+#define RAW_EVENT_CONTROL       2
+#define RAW_EVENT_RESET         3
+#define RAW_EVENT_DISCONNECT    4
+#define RAW_EVENT_SUSPEND       5
+#define RAW_EVENT_RESUME        6
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t length;
+    uint8_t  data[8];       // SETUP packet for RAW_EVENT_CONTROL
+} RAW_EVENT;
+
+/**
+ * Open /dev/raw-gadget and bind to a UDC, e.g. "dummy_udc" / "dummy_udc.0".
+ * @return file descriptor, or -1 (errno set)
+ */
+int Raw_Open(const char *driver, const char *device);
+
+bool Raw_Run(int fd);
+
+/**
+ * Wait for the next event.
+ */
+bool Raw_FetchEvent(int fd, RAW_EVENT *ev);
+
+/**
+ * Data stage of an IN control transfer; zlp ends a short transfer
+ * whose length is a multiple of the packet size.
+ */
+int Raw_Ep0Write(int fd, const uint8_t *data, unsigned len, bool zlp);
+
+/**
+ * Data stage of an OUT control transfer, or the status stage of a
+ * request without data when len is 0.
+ */
+int Raw_Ep0Read(int fd, uint8_t *data, unsigned len);
+
+bool Raw_Ep0Stall(int fd);
+
+/**
+ * Enable an endpoint from its 7-byte descriptor.
+ * @return endpoint handle for Raw_EpWrite, or -1
+ */
+int Raw_EpEnable(int fd, const uint8_t desc[7]);
+
+bool Raw_EpDisable(int fd, int handle);
+
+/**
+ * Blocks until the host has taken the packet.
+ */
+int Raw_EpWrite(int fd, int handle, const uint8_t *data, unsigned len);
+
+/**
+ * Blocks until the host has sent a packet.
+ * @return its length, or -1
+ */
+int Raw_EpRead(int fd, int handle, uint8_t *data, unsigned len);
+
+bool Raw_Configure(int fd);
+
+bool Raw_VbusDraw(int fd, unsigned maxPower);
+
+#endif /* RAW_H */
@@ -0,0 +1,674 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * The UDC answers SET_ADDRESS itself and does the packet level work, so
+ * what is left of usb_device.c is the standard request handling on EP0
+ * and the BDT handles of the data endpoints. The request handlers below
+ * follow their namesakes in usb_device.c.
+ *
+ * raw-gadget calls block, so events are fetched on a thread of their own
+ * and processed by USBDeviceTasks() on the firmware thread, and each IN
+ * endpoint has a writer thread that clears UOWN of the handle when the
+ * host has read the packet. OUT endpoints have a reader thread that
+ * reads only while the firmware has a buffer armed, so the UDC NAKs the
+ * host in between, as the SIE does.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "system.h"
+#include "usb.h"
+#include "usb_device_hid.h"
+
+#include "raw.h"
+#include "usb_device_raw.h"
+
+#define EVENT_QUEUE     32
+#define EP_MAX_PACKET   64
+#define EVENT_IN_SENT   0x80    // queued by an IN endpoint thread, not by raw-gadget
+#define EVENT_OUT_DONE  0x81    // queued by an OUT endpoint thread
+
+#if !defined(self_power)
+    #define self_power  0       // bus powered, as in usb_device.c
+#endif
+
+#if !defined(USB_MAX_NUM_CONFIG_DSC)
+    #define USB_MAX_NUM_CONFIG_DSC  1
+#endif
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+USB_USER_CONFIG_DESCRIPTOR_INCLUDE;
+extern const uint8_t *const USB_SD_Ptr[];
+extern bool USER_USB_CALLBACK_EVENT_HANDLER(USB_EVENT event, void *pdata, uint16_t size);
+
+/** VARIABLES ******************************************************/
+USB_VOLATILE USB_DEVICE_STATE USBDeviceState;
+USB_VOLATILE uint8_t USBActiveConfiguration;
+USB_VOLATILE uint8_t USBAlternateInterface[USB_MAX_NUM_INT];
+USB_VOLATILE IN_PIPE inPipes[1];
+USB_VOLATILE OUT_PIPE outPipes[1];
+USB_VOLATILE bool RemoteWakeup;
+USB_VOLATILE bool USBBusIsSuspended;
+USB_VOLATILE uint8_t USBTicksSinceSuspendEnd;
+volatile bool USBDeferStatusStagePacket;
+volatile bool USBDeferINDataStagePackets;
+volatile bool USBDeferOUTDataStagePackets;
+
+volatile CTRL_TRF_SETUP SetupPkt;
+volatile uint8_t CtrlTrfData[USB_EP0_BUFF_SIZE];
+
+void (*UsbRaw_OnSubmit)(uint8_t ep, const uint8_t *data, uint8_t len);
+void (*UsbRaw_OnSent)(uint8_t ep);
+
+typedef struct
+{
+    pthread_t thread;
+    bool started;
+    int handle;                 // raw-gadget endpoint, -1 while disabled
+    volatile BDT_ENTRY bd[2];   // even/odd handles given to the firmware
+    uint8_t ppbi;
+    bool pending;
+    volatile BDT_ENTRY *current;
+    uint8_t data[EP_MAX_PACKET];
+    uint8_t len;
+} IN_ENDPOINT;
+
+typedef struct
+{
+    pthread_t thread;
+    bool started;
+    int handle;                 // raw-gadget endpoint, -1 while disabled
+    volatile BDT_ENTRY bd[2];
+    uint8_t ppbi;
+    bool armed;                 // the firmware has handed a buffer over
+    volatile BDT_ENTRY *current;
+    uint8_t *dst;
+    uint8_t len;
+} OUT_ENDPOINT;
+
+static int fd = -1;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+static RAW_EVENT events[EVENT_QUEUE];
+static unsigned eventHead, eventCount;
+static IN_ENDPOINT epIn[USB_MAX_EP_NUMBER + 1];
+static OUT_ENDPOINT epOut[USB_MAX_EP_NUMBER + 1];
+
+/** EVENTS *********************************************************/
+
+/* with lock held */
+static void queueEvent(const RAW_EVENT *ev)
+{
+    if (eventCount < EVENT_QUEUE) {
+        events[(eventHead + eventCount) % EVENT_QUEUE] = *ev;
+        eventCount++;
+    }
+}
+
+static void *eventThread(void *arg)
+{
+    RAW_EVENT ev;
+
+    (void)arg;
+    while (Raw_FetchEvent(fd, &ev)) {
+        pthread_mutex_lock(&lock);
+        queueEvent(&ev);
+        pthread_mutex_unlock(&lock);
+    }
+    perror("raw-gadget event");
+    return NULL;
+}
+
+static bool nextEvent(RAW_EVENT *ev)
+{
+    bool got = false;
+
+    pthread_mutex_lock(&lock);
+    if (eventCount) {
+        *ev = events[eventHead];
+        eventHead = (eventHead + 1) % EVENT_QUEUE;
+        eventCount--;
+        got = true;
+    }
+    pthread_mutex_unlock(&lock);
+    return got;
+}
+
+/** ENDPOINTS ******************************************************/
+
+static void *epInThread(void *arg)
+{
+    IN_ENDPOINT *ep = arg;
+    uint8_t num = (uint8_t)(ep - epIn);
+
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        uint8_t data[EP_MAX_PACKET];
+        uint8_t len;
+        volatile BDT_ENTRY *bd;
+        int handle;
+        int n;
+
+        while (!ep->pending) pthread_cond_wait(&wake, &lock);
+        memcpy(data, ep->data, ep->len);
+        len = ep->len;
+        bd = ep->current;
+        handle = ep->handle;
+        pthread_mutex_unlock(&lock);
+
+        // fails once the endpoint is disabled; the packet is dropped
+        // like a BD that the firmware's stack resets
+        n = handle >= 0 ? Raw_EpWrite(fd, handle, data, len) : -1;
+        if (n >= 0 && UsbRaw_OnSent != NULL) UsbRaw_OnSent(num);
+
+        pthread_mutex_lock(&lock);
+        ep->pending = false;
+        bd->STAT.UOWN = 0;
+        if (n >= 0) {
+            // TRNIF: the firmware sees it on its next USBDeviceTasks()
+            RAW_EVENT done = { .type = EVENT_IN_SENT, .length = 1, .data = { num } };
+            queueEvent(&done);
+        }
+    }
+    return NULL;
+}
+
+static void *epOutThread(void *arg)
+{
+    OUT_ENDPOINT *ep = arg;
+    uint8_t num = (uint8_t)(ep - epOut);
+
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        uint8_t data[EP_MAX_PACKET];
+        volatile BDT_ENTRY *bd;
+        int handle;
+        int n;
+
+        while (!ep->armed) pthread_cond_wait(&wake, &lock);
+        bd = ep->current;
+        handle = ep->handle;
+        pthread_mutex_unlock(&lock);
+
+        n = handle >= 0 ? Raw_EpRead(fd, handle, data, sizeof(data)) : -1;
+
+        pthread_mutex_lock(&lock);
+        if (n < 0) {
+            // disabled: wait for the firmware to arm the endpoint again
+            if (ep->current == bd) ep->armed = false;
+            continue;
+        }
+        if (!ep->armed || ep->current != bd) continue;     // disarmed meanwhile
+        if (n > ep->len) n = ep->len;
+        memcpy(ep->dst, data, (size_t)n);
+        bd->CNT = (uint8_t)n;
+        bd->STAT.UOWN = 0;
+        ep->armed = false;
+        RAW_EVENT done = { .type = EVENT_OUT_DONE, .length = 1, .data = { num } };
+        queueEvent(&done);
+    }
+    return NULL;
+}
+
+static void disableEndpoints(void)
+{
+    pthread_mutex_lock(&lock);
+    for (unsigned i = 1; i <= USB_MAX_EP_NUMBER; i++) {
+        if (epIn[i].handle >= 0) Raw_EpDisable(fd, epIn[i].handle);
+        epIn[i].handle = -1;
+        if (epOut[i].handle >= 0) Raw_EpDisable(fd, epOut[i].handle);
+        epOut[i].handle = -1;
+        epOut[i].armed = false;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+/* endpoint descriptor for address in the active configuration */
+static const uint8_t *findEndpoint(uint8_t address)
+{
+    const uint8_t *cfg;
+    uint16_t total;
+
+    if (USBActiveConfiguration == 0 || USBActiveConfiguration > USB_MAX_NUM_CONFIG_DSC) {
+        return NULL;
+    }
+    cfg = USB_CD_Ptr[USBActiveConfiguration - 1];
+    total = (uint16_t)(cfg[2] | cfg[3] << 8);
+    for (uint16_t i = 0; i + 1 < total && cfg[i] != 0; i += cfg[i]) {
+        if (cfg[i + 1] == USB_DESCRIPTOR_ENDPOINT && cfg[i + 2] == address) return &cfg[i];
+    }
+    return NULL;
+}
+
+/* raw-gadget handle for the endpoint at address, or -1 */
+static int enableRaw(uint8_t address)
+{
+    const uint8_t *desc = findEndpoint(address);
+    int handle;
+
+    if (desc == NULL) {
+        fprintf(stderr, "raw-gadget: no descriptor for endpoint %u %s\n",
+                address & 0x7F, (address & 0x80) ? "IN" : "OUT");
+        return -1;
+    }
+    handle = Raw_EpEnable(fd, desc);
+    if (handle < 0) perror("raw-gadget ep enable");
+    return handle;
+}
+
+void USBEnableEndpoint(uint8_t ep, uint8_t options)
+{
+    int handle;
+
+    if (ep == 0 || ep > USB_MAX_EP_NUMBER) return;
+
+    if (options & USB_IN_ENABLED) {
+        handle = enableRaw((uint8_t)(ep | 0x80));
+        if (handle >= 0) {
+            pthread_mutex_lock(&lock);
+            epIn[ep].handle = handle;
+            epIn[ep].bd[0].STAT.Val = 0;
+            epIn[ep].bd[1].STAT.Val = 0;
+            epIn[ep].ppbi = 0;
+            if (!epIn[ep].started) {
+                epIn[ep].started = pthread_create(&epIn[ep].thread, NULL, epInThread, &epIn[ep]) == 0;
+            }
+            pthread_mutex_unlock(&lock);
+        }
+    }
+
+    if (options & USB_OUT_ENABLED) {
+        handle = enableRaw(ep);
+        if (handle >= 0) {
+            pthread_mutex_lock(&lock);
+            epOut[ep].handle = handle;
+            epOut[ep].bd[0].STAT.Val = 0;
+            epOut[ep].bd[1].STAT.Val = 0;
+            epOut[ep].ppbi = 0;
+            epOut[ep].armed = false;
+            if (!epOut[ep].started) {
+                epOut[ep].started = pthread_create(&epOut[ep].thread, NULL, epOutThread, &epOut[ep]) == 0;
+            }
+            pthread_mutex_unlock(&lock);
+        }
+    }
+}
+
+/* hand the firmware's buffer to the endpoint's reader thread */
+static USB_HANDLE armOut(uint8_t ep, uint8_t *data, uint8_t len)
+{
+    OUT_ENDPOINT *p = &epOut[ep];
+    volatile BDT_ENTRY *bd;
+
+    pthread_mutex_lock(&lock);
+    if (p->armed || p->handle < 0) {
+        pthread_mutex_unlock(&lock);
+        return 0;
+    }
+    bd = &p->bd[p->ppbi];
+    p->ppbi ^= 1;
+    p->dst = data;
+    p->len = len;
+    p->current = bd;
+    p->armed = true;
+    bd->CNT = len;
+    bd->STAT.UOWN = 1;
+    pthread_cond_broadcast(&wake);
+    pthread_mutex_unlock(&lock);
+    return (USB_HANDLE)bd;
+}
+
+USB_HANDLE USBTransferOnePacket(uint8_t ep, uint8_t dir, uint8_t *data, uint8_t len)
+{
+    IN_ENDPOINT *p;
+    volatile BDT_ENTRY *bd;
+
+    if (ep == 0 || ep > USB_MAX_EP_NUMBER) return 0;
+    if (len > EP_MAX_PACKET) len = EP_MAX_PACKET;
+    if (dir == OUT_FROM_HOST) return armOut(ep, data, len);
+    p = &epIn[ep];
+
+    pthread_mutex_lock(&lock);
+    if (p->pending || p->handle < 0) {
+        pthread_mutex_unlock(&lock);
+        return 0;
+    }
+    bd = &p->bd[p->ppbi];
+    p->ppbi ^= 1;
+    memcpy(p->data, data, len);
+    p->len = len;
+    p->current = bd;
+    p->pending = true;
+    bd->CNT = len;
+    bd->STAT.UOWN = 1;
+    if (UsbRaw_OnSubmit != NULL) UsbRaw_OnSubmit(ep, data, len);
+    pthread_cond_broadcast(&wake);
+    pthread_mutex_unlock(&lock);
+    return (USB_HANDLE)bd;
+}
+
+void USBStallEndpoint(uint8_t ep, uint8_t dir)
+{
+    (void)ep;
+    (void)dir;
+}
+
+void USBCancelIO(uint8_t endpoint)
+{
+    (void)endpoint;
+}
+
+/** CONTROL TRANSFERS **********************************************/
+
+static void USBStdGetDscHandler(void)
+{
+    if (SetupPkt.bmRequestType != 0x80) return;
+
+    inPipes[0].info.Val = USB_EP0_ROM | USB_EP0_BUSY | USB_EP0_INCLUDE_ZERO;
+    switch (SetupPkt.bDescriptorType) {
+        case USB_DESCRIPTOR_DEVICE:
+            inPipes[0].pSrc.bRom = (const uint8_t *)&device_dsc;
+            inPipes[0].wCount.Val = sizeof(device_dsc);
+            break;
+        case USB_DESCRIPTOR_CONFIGURATION:
+            if (SetupPkt.bDscIndex < USB_MAX_NUM_CONFIG_DSC) {
+                inPipes[0].pSrc.bRom = USB_CD_Ptr[SetupPkt.bDscIndex];
+                inPipes[0].wCount.byte.LB = inPipes[0].pSrc.bRom[2];
+                inPipes[0].wCount.byte.HB = inPipes[0].pSrc.bRom[3];
+            } else {
+                inPipes[0].info.Val = 0;
+            }
+            break;
+        case USB_DESCRIPTOR_STRING:
+            if (SetupPkt.bDscIndex < USB_NUM_STRING_DESCRIPTORS) {
+                inPipes[0].pSrc.bRom = USB_SD_Ptr[SetupPkt.bDscIndex];
+                inPipes[0].wCount.Val = *inPipes[0].pSrc.bRom;
+            } else {
+                inPipes[0].info.Val = 0;
+            }
+            break;
+        default:
+            inPipes[0].info.Val = 0;
+            break;
+    }
+}
+
+static void USBStdSetCfgHandler(void)
+{
+    inPipes[0].info.bits.busy = 1;
+
+    disableEndpoints();
+    memset((void *)&USBAlternateInterface, 0x00, USB_MAX_NUM_INT);
+
+    USBActiveConfiguration = SetupPkt.bConfigurationValue;
+    if (USBActiveConfiguration == 0) {
+        USBDeviceState = ADDRESS_STATE;
+    } else if (USBActiveConfiguration <= USB_MAX_NUM_CONFIG_DSC) {
+        const uint8_t *cfg = USB_CD_Ptr[USBActiveConfiguration - 1];
+
+        // the application enables its endpoints from here
+        USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_CONFIGURED, (void *)&USBActiveConfiguration, 1);
+        Raw_VbusDraw(fd, cfg[8]);
+        Raw_Configure(fd);
+        USBDeviceState = CONFIGURED_STATE;
+    } else {
+        inPipes[0].info.bits.busy = 0;
+    }
+}
+
+static void USBStdGetStatusHandler(void)
+{
+    CtrlTrfData[0] = 0;
+    CtrlTrfData[1] = 0;
+
+    switch (SetupPkt.Recipient) {
+        case USB_SETUP_RECIPIENT_DEVICE_BITFIELD:
+            inPipes[0].info.bits.busy = 1;
+            if (self_power == 1) CtrlTrfData[0] |= 0x01;
+            if (RemoteWakeup == true) CtrlTrfData[0] |= 0x02;
+            break;
+        case USB_SETUP_RECIPIENT_INTERFACE_BITFIELD:
+        case USB_SETUP_RECIPIENT_ENDPOINT_BITFIELD:
+            inPipes[0].info.bits.busy = 1;      // halts are not tracked
+            break;
+    }
+
+    if (inPipes[0].info.bits.busy == 1) {
+        inPipes[0].pSrc.bRam = (uint8_t *)&CtrlTrfData;
+        inPipes[0].info.bits.ctrl_trf_mem = USB_EP0_RAM;
+        inPipes[0].wCount.Val = 2;
+    }
+}
+
+static void USBStdFeatureReqHandler(void)
+{
+    if (SetupPkt.bFeature == USB_FEATURE_DEVICE_REMOTE_WAKEUP
+            && SetupPkt.Recipient == USB_SETUP_RECIPIENT_DEVICE_BITFIELD) {
+        inPipes[0].info.bits.busy = 1;
+        RemoteWakeup = SetupPkt.bRequest == USB_REQUEST_SET_FEATURE;
+    } else if (SetupPkt.bFeature == USB_FEATURE_ENDPOINT_HALT
+            && SetupPkt.Recipient == USB_SETUP_RECIPIENT_ENDPOINT_BITFIELD) {
+        // the UDC keeps the data toggles; a halt is acknowledged only
+        inPipes[0].info.bits.busy = 1;
+    }
+}
+
+static void USBCheckStdRequest(void)
+{
+    if (SetupPkt.RequestType != USB_SETUP_TYPE_STANDARD_BITFIELD) return;
+
+    switch (SetupPkt.bRequest) {
+        case USB_REQUEST_GET_DESCRIPTOR:
+            USBStdGetDscHandler();
+            break;
+        case USB_REQUEST_SET_CONFIGURATION:
+            USBStdSetCfgHandler();
+            break;
+        case USB_REQUEST_GET_CONFIGURATION:
+            inPipes[0].pSrc.bRam = (uint8_t *)&USBActiveConfiguration;
+            inPipes[0].info.bits.ctrl_trf_mem = USB_EP0_RAM;
+            inPipes[0].wCount.Val = 1;
+            inPipes[0].info.bits.busy = 1;
+            break;
+        case USB_REQUEST_GET_STATUS:
+            USBStdGetStatusHandler();
+            break;
+        case USB_REQUEST_CLEAR_FEATURE:
+        case USB_REQUEST_SET_FEATURE:
+            USBStdFeatureReqHandler();
+            break;
+        case USB_REQUEST_GET_INTERFACE:
+            if (SetupPkt.bIntfID < USB_MAX_NUM_INT) {
+                inPipes[0].pSrc.bRam = (uint8_t *)&USBAlternateInterface + SetupPkt.bIntfID;
+                inPipes[0].info.bits.ctrl_trf_mem = USB_EP0_RAM;
+                inPipes[0].wCount.Val = 1;
+                inPipes[0].info.bits.busy = 1;
+            }
+            break;
+        case USB_REQUEST_SET_INTERFACE:
+            if (SetupPkt.bIntfID < USB_MAX_NUM_INT) {
+                inPipes[0].info.bits.busy = 1;
+                USBAlternateInterface[SetupPkt.bIntfID] = SetupPkt.bAltID;
+            }
+            break;
+        case USB_REQUEST_SET_DESCRIPTOR:
+            USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_SET_DESCRIPTOR, 0, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+/* run the data and status stages the handlers asked for, or STALL */
+static void USBCtrlEPServiceComplete(void)
+{
+    uint8_t buf[256];
+
+    if (inPipes[0].info.bits.busy) {
+        if (SetupPkt.DataDir == USB_SETUP_DEVICE_TO_HOST_BITFIELD) {
+            uint16_t len = inPipes[0].wCount.Val;
+            bool zlp;
+
+            if (len > SetupPkt.wLength) len = SetupPkt.wLength;
+            if (len > sizeof(buf)) len = sizeof(buf);
+            memcpy(buf, inPipes[0].info.bits.ctrl_trf_mem == USB_EP0_RAM
+                    ? (const uint8_t *)inPipes[0].pSrc.bRam : inPipes[0].pSrc.bRom, len);
+            zlp = inPipes[0].info.bits.includeZero && len < SetupPkt.wLength
+                    && len % USB_EP0_BUFF_SIZE == 0;
+            if (Raw_Ep0Write(fd, buf, len, zlp) < 0) perror("raw-gadget ep0 write");
+        } else if (Raw_Ep0Read(fd, NULL, 0) < 0) {
+            perror("raw-gadget ep0 status");
+        }
+    } else if (outPipes[0].info.bits.busy) {
+        int n = Raw_Ep0Read(fd, buf, SetupPkt.wLength < sizeof(buf) ? SetupPkt.wLength : sizeof(buf));
+
+        if (n < 0) {
+            perror("raw-gadget ep0 read");
+        } else {
+            if ((unsigned)n > outPipes[0].wCount.Val) n = outPipes[0].wCount.Val;
+            memcpy(outPipes[0].pDst.bRam, buf, (size_t)n);
+            if (outPipes[0].pFunc != NULL) outPipes[0].pFunc();
+        }
+        outPipes[0].info.bits.busy = 0;
+    } else {
+        Raw_Ep0Stall(fd);
+    }
+    inPipes[0].info.Val = 0;
+    inPipes[0].wCount.Val = 0;      // all of it is out (ConfigArena_Busy())
+}
+
+static void USBCtrlTrfSetupHandler(void)
+{
+    inPipes[0].info.Val = 0;
+    inPipes[0].wCount.Val = 0;
+    outPipes[0].info.Val = 0;
+    outPipes[0].wCount.Val = 0;
+    USBDeferStatusStagePacket = false;
+    USBDeferINDataStagePackets = false;
+    USBDeferOUTDataStagePackets = false;
+
+    // SET_ADDRESS never gets here, so the first request marks the address
+    if (USBDeviceState == DEFAULT_STATE) USBDeviceState = ADDRESS_STATE;
+
+    USBCheckStdRequest();
+    USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_EP0_REQUEST, 0, 0);
+    USBCtrlEPServiceComplete();
+}
+
+static void USBBusReset(void)
+{
+    disableEndpoints();
+    USBActiveConfiguration = 0;
+    memset((void *)&USBAlternateInterface, 0x00, USB_MAX_NUM_INT);
+    RemoteWakeup = false;
+    USBBusIsSuspended = false;
+    USBSuspendControl = 0;
+    USBDeviceState = DEFAULT_STATE;
+}
+
+/** API ************************************************************/
+
+bool UsbRaw_Open(const char *driver, const char *device)
+{
+    for (unsigned i = 0; i <= USB_MAX_EP_NUMBER; i++) {
+        epIn[i].handle = -1;
+        epOut[i].handle = -1;
+    }
+    fd = Raw_Open(driver, device);
+    if (fd < 0) {
+        perror("/dev/raw-gadget");
+        return false;
+    }
+    return true;
+}
+
+void USBDeviceInit(void)
+{
+    static pthread_t thread;
+
+    USBDeviceState = DETACHED_STATE;
+    USBActiveConfiguration = 0;
+    USBBusIsSuspended = false;
+    if (fd < 0) return;
+    if (!Raw_Run(fd)) {
+        perror("raw-gadget run");
+        return;
+    }
+    USBDeviceState = ATTACHED_STATE;
+    pthread_create(&thread, NULL, eventThread, NULL);
+}
+
+void USBDeviceTasks(void)
+{
+    RAW_EVENT ev;
+    USTAT_FIELDS ustat;
+
+    if (!nextEvent(&ev)) return;
+
+    switch (ev.type) {
+        case RAW_EVENT_CONNECT:
+        case RAW_EVENT_RESET:
+            USBBusReset();
+            break;
+        case RAW_EVENT_DISCONNECT:
+            disableEndpoints();
+            USBDeviceState = ATTACHED_STATE;
+            break;
+        case RAW_EVENT_SUSPEND:
+            USBSuspendControl = 1;
+            USBBusIsSuspended = true;
+            USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_SUSPEND, 0, 0);
+            break;
+        case RAW_EVENT_RESUME:
+            USBSuspendControl = 0;
+            USBBusIsSuspended = false;
+            USBTicksSinceSuspendEnd = 0;
+            USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_RESUME, 0, 0);
+            break;
+        case RAW_EVENT_CONTROL:
+            memcpy((void *)&SetupPkt, ev.data, sizeof(SetupPkt));
+            USBCtrlTrfSetupHandler();
+            break;
+        case EVENT_IN_SENT:
+            ustat.Val = 0;
+            ustat.endpoint_number = ev.data[0];
+            ustat.direction = IN_TO_HOST;
+            USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_TRANSFER, (void *)&ustat, 0);
+            break;
+        case EVENT_OUT_DONE:
+            ustat.Val = 0;
+            ustat.endpoint_number = ev.data[0];
+            ustat.direction = OUT_FROM_HOST;
+            USER_USB_CALLBACK_EVENT_HANDLER((USB_EVENT)EVENT_TRANSFER, (void *)&ustat, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+void USBCtrlEPAllowStatusStage(void)
+{
+    USBDeferStatusStagePacket = false;
+}
+
+void USBCtrlEPAllowDataStage(void)
+{
+    USBDeferINDataStagePackets = false;
+    USBDeferOUTDataStagePackets = false;
+}
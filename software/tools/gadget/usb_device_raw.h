@@ -0,0 +1,44 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   usb_device_raw.h
+ * usb_device.c replacement that puts the firmware's device stack on a
+ * raw-gadget UDC. The application, HID and descriptor layers are used
+ * unchanged: they only see the API of usb_device.h.
+ */
+
+#ifndef USB_DEVICE_RAW_H
+#define USB_DEVICE_RAW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Bind to the UDC. Call before USBDeviceInit(); the host sees the
+ * device once USBDeviceInit() has run.
+ */
+bool UsbRaw_Open(const char *driver, const char *device);
+
+/**
+ * Optional hooks. OnSubmit runs on the firmware thread when a packet is
+ * handed to an IN endpoint, OnSent on the endpoint's thread once the
+ * host has taken it.
+ */
+extern void (*UsbRaw_OnSubmit)(uint8_t ep, const uint8_t *data, uint8_t len);
+extern void (*UsbRaw_OnSent)(uint8_t ep);
+
+#endif /* USB_DEVICE_RAW_H */
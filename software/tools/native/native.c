@@ -0,0 +1,181 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NATIVE_SFR_DEFINE
+#include "xc.h"
+#include "native.h"
+
+/* with NATIVE_SFR_DEFINE, xc.h above defines every register it declares */
+
+static pthread_mutex_t pinLock = PTHREAD_MUTEX_INITIALIZER;
+static bool virtualTime;
+static uint64_t virtualNs;
+static void (*onAdvance)(uint64_t nowUs);
+static double timer0Counts;
+static double timer1Counts;
+
+uint64_t Native_NowUs(void)
+{
+    struct timespec ts;
+
+    if (virtualTime) return virtualNs / 1000u;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void Native_DelayUs(unsigned long us)
+{
+    if (virtualTime) {
+        Native_Advance((uint64_t)us * 1000u);
+    } else {
+        usleep(us);
+    }
+}
+
+/* the part restarts, here into a bootloader that is not there */
+void Native_Reset(void)
+{
+    fprintf(stderr, "native: RESET instruction, stopping\n");
+    exit(0);
+}
+
+void Native_SetPins(unsigned port, uint8_t mask, uint8_t level)
+{
+    volatile uint8_t *reg = port == 0 ? &PORTA : port == 1 ? &PORTB : &PORTC;
+
+    pthread_mutex_lock(&pinLock);
+    *reg = (uint8_t)((*reg & ~mask) | (level & mask));
+    pthread_mutex_unlock(&pinLock);
+}
+
+/*
+ * Timer0 on the instruction clock with the OPTION_REG prescaler; TMR0IF
+ * is set on overflow like the hardware does.
+ */
+static void timer0Advance(double us)
+{
+    unsigned prescale = OPTION_REGbits.PSA ? 1u : 2u << OPTION_REGbits.PS;
+
+    timer0Counts += us * (NATIVE_FCY_HZ / 1e6) / prescale;
+    while (timer0Counts >= 1.0) {
+        unsigned step = timer0Counts > 256.0 ? 256u : (unsigned)timer0Counts;
+        unsigned next = TMR0bits.TMR0 + step;
+
+        timer0Counts -= step;
+        if (next > 0xFF) INTCONbits.TMR0IF = 1;
+        TMR0bits.TMR0 = (uint8_t)next;
+    }
+}
+
+/*
+ * Timer1 on the instruction clock with its prescaler, as telemetry.c
+ * runs it; TMR1IF is set on overflow. Other clock sources stand still.
+ */
+static void timer1Advance(double us)
+{
+    unsigned long next, step;
+
+    if (!T1CONbits.TMR1ON || T1CONbits.TMR1CS != 0) return;
+    timer1Counts += us * (NATIVE_FCY_HZ / 1e6) / (1u << T1CONbits.T1CKPS);
+    step = (unsigned long)timer1Counts;
+    timer1Counts -= step;
+    next = ((unsigned long)TMR1H << 8 | TMR1L) + step;
+    if (next > 0xFFFF) PIR1bits.TMR1IF = 1;
+    TMR1H = (uint8_t)(next >> 8);
+    TMR1L = (uint8_t)next;
+}
+
+/* the frame number the SIE would count, one SOF per millisecond */
+static void frameAdvance(void)
+{
+    uint16_t frame = (uint16_t)((Native_NowUs() / 1000u) & 0x07FF);
+
+    UFRML = (uint8_t)frame;
+    UFRMH = (uint8_t)(frame >> 8);
+}
+
+/* 100 us steps are plenty for the 4 ms ticks the firmware counts */
+static void *timerThread(void *arg)
+{
+    uint64_t last = Native_NowUs();
+
+    (void)arg;
+    for (;;) {
+        uint64_t now;
+
+        usleep(100);
+        now = Native_NowUs();
+        timer0Advance((double)(now - last));
+        timer1Advance((double)(now - last));
+        frameAdvance();
+        last = now;
+    }
+    return NULL;
+}
+
+static void resetRegisters(void)
+{
+    PORTA = PORTB = PORTC = 0xFF;
+    TRISA = TRISB = TRISC = 0xFF;
+    ANSELA = ANSELB = ANSELC = 0xFF;
+    OPTION_REG = 0xFF;
+    OSCSTAT = 0x40;                     // PLLRDY: the PLL is always locked here
+}
+
+void Native_StartVirtual(void (*advance)(uint64_t nowUs))
+{
+    resetRegisters();
+    virtualTime = true;
+    virtualNs = 0;
+    onAdvance = advance;
+}
+
+void Native_Advance(uint64_t ns)
+{
+    static bool inside;
+
+    virtualNs += ns;
+    timer0Advance((double)ns / 1000.0);
+    timer1Advance((double)ns / 1000.0);
+    frameAdvance();
+    // the callback may set pins, which must not count as firmware accesses
+    if (onAdvance != NULL && !inside) {
+        inside = true;
+        onAdvance(virtualNs / 1000u);
+        inside = false;
+    }
+}
+
+void Native_Access(void)
+{
+    Native_Advance(NATIVE_ACCESS_NS);
+}
+
+void Native_Start(void)
+{
+    static pthread_t timer;
+
+    resetRegisters();
+    pthread_create(&timer, NULL, timerThread, NULL);
+}
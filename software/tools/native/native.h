@@ -0,0 +1,72 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   native.h
+ * Runtime for firmware sources built on the development PC: the SFR
+ * variables of xc.h, free-running Timer0 and Timer1 and pin levels set
+ * from outside the firmware's own thread.
+ *
+ * Builds with -DNATIVE_VIRTUAL_TIME run on a virtual clock instead:
+ * it only moves when the firmware touches a port, INTCON or TMR0 (see
+ * xc.h) or when the caller advances it, so runs are reproducible and
+ * busy-waits on Timer0 finish without a second thread.
+ */
+
+#ifndef NATIVE_H
+#define NATIVE_H
+
+#include <stdint.h>
+
+#define NATIVE_FCY_HZ   12000000UL      // 48 MHz / 4, as set up by SYSTEM_Initialize
+#define NATIVE_ACCESS_NS 250            // virtual cost of one SFR access: ~3 instructions
+
+/**
+ * Bring the registers to their power-on values (ports read 1: all
+ * buttons released) and start the thread that runs the timers.
+ */
+void Native_Start(void);
+
+/**
+ * Use the virtual clock, starting at 0. advance (may be NULL) is called
+ * after every step with the new time; pin changes made from it are not
+ * charged to the firmware.
+ */
+void Native_StartVirtual(void (*advance)(uint64_t nowUs));
+
+/**
+ * Move the virtual clock forward by ns, running the timers along.
+ */
+void Native_Advance(uint64_t ns);
+
+/**
+ * Change the pins in mask of port (0 = PORTA .. 2 = PORTC) to level.
+ */
+void Native_SetPins(unsigned port, uint8_t mask, uint8_t level);
+
+/**
+ * Blank the program memory and load the High-Endurance Flash rows
+ * (0x1F80-0x1FFF, 16-bit little endian words) from path if it exists.
+ * Erases and row writes there are saved back. path may be NULL.
+ */
+void Native_NvmOpen(const char *path);
+
+/**
+ * Monotonic time in microseconds; the virtual clock once started.
+ */
+uint64_t Native_NowUs(void);
+
+#endif /* NATIVE_H */
@@ -0,0 +1,135 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * Flash API of mcc_generated_files/nvm for native builds. Program memory
+ * is an array of blank words; the High-Endurance Flash rows can be kept
+ * in a file so a mapping written over USB survives a restart.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xc.h"
+#include "native.h"
+#include "mcc_generated_files/nvm/nvm.h"
+
+#define HEF_START   0x1F80u
+#define HEF_WORDS   0x0080u
+
+static flash_data_t flash[PROGMEM_SIZE];
+static const char *hefPath;
+static uint16_t unlockKey;
+static nvm_status_t status = NVM_OK;
+
+static void saveHef(void)
+{
+    FILE *fp;
+
+    if (hefPath == NULL) return;
+    fp = fopen(hefPath, "wb");
+    if (fp == NULL) {
+        perror(hefPath);
+        return;
+    }
+    for (unsigned i = 0; i < HEF_WORDS; i++) {
+        uint16_t w = flash[HEF_START + i];
+        fputc(w & 0xFF, fp);
+        fputc(w >> 8, fp);
+    }
+    fclose(fp);
+}
+
+void Native_NvmOpen(const char *path)
+{
+    FILE *fp;
+
+    for (unsigned i = 0; i < PROGMEM_SIZE; i++) flash[i] = 0x3FFF;
+    hefPath = path;
+    if (path == NULL || (fp = fopen(path, "rb")) == NULL) return;
+    for (unsigned i = 0; i < HEF_WORDS; i++) {
+        int lo = fgetc(fp), hi = fgetc(fp);
+        if (lo == EOF || hi == EOF) break;
+        flash[HEF_START + i] = (flash_data_t)((hi << 8 | lo) & 0x3FFF);
+    }
+    fclose(fp);
+}
+
+void NVM_Initialize(void)
+{
+    status = NVM_OK;
+}
+
+bool NVM_IsBusy(void)
+{
+    return false;       // writes complete immediately; the CPU stalls on silicon
+}
+
+nvm_status_t NVM_StatusGet(void)
+{
+    return status;
+}
+
+void NVM_StatusClear(void)
+{
+    status = NVM_OK;
+}
+
+void NVM_UnlockKeySet(uint16_t key)
+{
+    unlockKey = key;
+}
+
+void NVM_UnlockKeyClear(void)
+{
+    unlockKey = 0;
+}
+
+flash_data_t FLASH_Read(flash_address_t address)
+{
+    return flash[address & (PROGMEM_SIZE - 1)];
+}
+
+nvm_status_t FLASH_RowWrite(flash_address_t address, flash_data_t *dataBuffer)
+{
+    flash_address_t row = FLASH_PageAddressGet(address);
+
+    if (unlockKey != UNLOCK_KEY) return status = NVM_ERROR;
+    // programming can only clear bits, as on the part
+    for (unsigned i = 0; i < PROGMEM_PAGE_SIZE; i++) flash[row + i] &= dataBuffer[i] & 0x3FFF;
+    if (row >= HEF_START) saveHef();
+    return NVM_OK;
+}
+
+nvm_status_t FLASH_PageErase(flash_address_t address)
+{
+    flash_address_t row = FLASH_PageAddressGet(address);
+
+    if (unlockKey != UNLOCK_KEY) return status = NVM_ERROR;
+    for (unsigned i = 0; i < PROGMEM_PAGE_SIZE; i++) flash[row + i] = 0x3FFF;
+    if (row >= HEF_START) saveHef();
+    return NVM_OK;
+}
+
+flash_address_t FLASH_PageAddressGet(flash_address_t address)
+{
+    return (flash_address_t)(address & ((PROGMEM_SIZE - 1) ^ (PROGMEM_PAGE_SIZE - 1)));
+}
+
+uint16_t FLASH_PageOffsetGet(flash_address_t address)
+{
+    return (uint16_t)(address & (PROGMEM_PAGE_SIZE - 1));
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   xc.h
+ * Stand-in for the XC8 device header when firmware sources are built
+ * for the development PC (tools/gadget, tools/replay).
+ *
+ * Only the PIC16F1459 registers the firmware touches are provided. Each
+ * one is a plain variable; bit views alias the same byte as with XC8,
+ * so PORTA and PORTAbits.RA5 agree. Build with
+ *
+ *     -D__XC8 -D_PIC14E -D__XC8_VERSION=2400 -I tools/native
+ *
+ * so the MLA headers pick their PIC16F1 branch. Nothing here runs by
+ * itself: native.c moves Timer0 and Timer1 along and nvm.c backs the
+ * flash API.
+ */
+
+#ifndef NATIVE_XC_H
+#define NATIVE_XC_H
+
+#include <stdint.h>
+
+#ifdef NATIVE_SFR_DEFINE
+#define NATIVE_SFR(type, name)  volatile type name
+#else
+#define NATIVE_SFR(type, name)  extern volatile type name
+#endif
+
+/* XC8 keywords and builtins */
+#define __at(addr)
+#define __section(name)
+#define __interrupt(...)
+#define __near
+#define NOP()
+#define CLRWDT()
+#define SLEEP()
+void Native_Reset(void);
+#define RESET()             Native_Reset()
+#define di()                (INTCONbits.GIE = 0)
+#define ei()                (INTCONbits.GIE = 1)
+
+#define _XTAL_FREQ          48000000UL
+void Native_DelayUs(unsigned long us);
+#define __delay_us(x)       Native_DelayUs(x)
+#define __delay_ms(x)       Native_DelayUs((x) * 1000UL)
+
+/* a byte register with a bit view under <name>bits */
+#define NATIVE_BITS(name, fields) \
+    typedef union { struct { fields }; uint8_t Val; } name##bits_t; \
+    NATIVE_SFR(name##bits_t, name##bits)
+
+NATIVE_BITS(PORTA, unsigned RA0:1; unsigned RA1:1; unsigned RA2:1; unsigned RA3:1;
+                   unsigned RA4:1; unsigned RA5:1; unsigned :2;);
+NATIVE_BITS(PORTB, unsigned :4; unsigned RB4:1; unsigned RB5:1; unsigned RB6:1; unsigned RB7:1;);
+NATIVE_BITS(PORTC, unsigned RC0:1; unsigned RC1:1; unsigned RC2:1; unsigned RC3:1;
+                   unsigned RC4:1; unsigned RC5:1; unsigned RC6:1; unsigned RC7:1;);
+NATIVE_BITS(WPUA, unsigned :3; unsigned WPUA3:1; unsigned WPUA4:1; unsigned WPUA5:1; unsigned :2;);
+NATIVE_BITS(INTCON, unsigned IOCIF:1; unsigned INTF:1; unsigned TMR0IF:1; unsigned IOCIE:1;
+                    unsigned INTE:1; unsigned TMR0IE:1; unsigned PEIE:1; unsigned GIE:1;);
+NATIVE_BITS(OPTION_REG, unsigned PS:3; unsigned PSA:1; unsigned TMR0SE:1; unsigned TMR0CS:1;
+                        unsigned INTEDG:1; unsigned nWPUEN:1;);
+NATIVE_BITS(TMR0, unsigned TMR0:8;);
+NATIVE_BITS(PIR1, unsigned TMR1IF:1; unsigned TMR2IF:1; unsigned :1; unsigned SSP1IF:1;
+                  unsigned TXIF:1; unsigned RCIF:1; unsigned ADIF:1; unsigned TMR1GIF:1;);
+NATIVE_BITS(PIE1, unsigned TMR1IE:1; unsigned TMR2IE:1; unsigned :1; unsigned SSP1IE:1;
+                  unsigned TXIE:1; unsigned RCIE:1; unsigned ADIE:1; unsigned TMR1GIE:1;);
+NATIVE_BITS(PIR2, unsigned :1; unsigned ACTIF:1; unsigned USBIF:1; unsigned BCL1IF:1;
+                  unsigned :1; unsigned C1IF:1; unsigned C2IF:1; unsigned OSFIF:1;);
+NATIVE_BITS(PIE2, unsigned :1; unsigned ACTIE:1; unsigned USBIE:1; unsigned BCL1IE:1;
+                  unsigned :1; unsigned C1IE:1; unsigned C2IE:1; unsigned OSFIE:1;);
+NATIVE_BITS(T1CON, unsigned TMR1ON:1; unsigned :1; unsigned nT1SYNC:1; unsigned T1OSCEN:1;
+                   unsigned T1CKPS:2; unsigned TMR1CS:2;);
+NATIVE_BITS(PMCON1, unsigned RD:1; unsigned WR:1; unsigned WREN:1; unsigned WRERR:1;
+                    unsigned FREE:1; unsigned LWLO:1; unsigned CFGS:1; unsigned :1;);
+NATIVE_BITS(UCON, unsigned :1; unsigned SUSPND:1; unsigned RESUME:1; unsigned USBEN:1;
+                  unsigned PKTDIS:1; unsigned SE0:1; unsigned PPBRST:1; unsigned :1;);
+NATIVE_BITS(UIR, unsigned URSTIF:1; unsigned UERRIF:1; unsigned ACTVIF:1; unsigned TRNIF:1;
+                 unsigned IDLEIF:1; unsigned STALLIF:1; unsigned SOFIF:1; unsigned :1;);
+NATIVE_BITS(UIE, unsigned URSTIE:1; unsigned UERRIE:1; unsigned ACTVIE:1; unsigned TRNIE:1;
+                 unsigned IDLEIE:1; unsigned STALLIE:1; unsigned SOFIE:1; unsigned :1;);
+NATIVE_BITS(UCFG, unsigned PPB:2; unsigned FSEN:1; unsigned :1; unsigned UPUEN:1; unsigned :2;
+                  unsigned UTEYE:1;);
+#define NATIVE_UEP(n) NATIVE_BITS(UEP##n, unsigned EPSTALL:1; unsigned EPINEN:1; unsigned EPOUTEN:1; \
+                                          unsigned EPCONDIS:1; unsigned EPHSHK:1; unsigned :3;)
+NATIVE_UEP(0); NATIVE_UEP(1); NATIVE_UEP(2); NATIVE_UEP(3);
+NATIVE_UEP(4); NATIVE_UEP(5); NATIVE_UEP(6); NATIVE_UEP(7);
+NATIVE_BITS(OSCSTAT, unsigned HFIOFS:1; unsigned LFIOFR:1; unsigned :2; unsigned HFIOFR:1;
+            unsigned OSTS:1; unsigned PLLRDY:1; unsigned SOSCR:1;);
+NATIVE_BITS(ACTCON, unsigned :1; unsigned ACTORS:1; unsigned :1; unsigned ACTLOCK:1;
+            unsigned ACTSRC:1; unsigned :1; unsigned ACTUD:1; unsigned ACTEN:1;);
+
+/* byte views; TMR0 has none because TMR0bits.TMR0 would expand it */
+#define PORTA       (PORTAbits.Val)
+#define PORTB       (PORTBbits.Val)
+#define PORTC       (PORTCbits.Val)
+#define WPUA        (WPUAbits.Val)
+#define INTCON      (INTCONbits.Val)
+#define OPTION_REG  (OPTION_REGbits.Val)
+#define PIR1        (PIR1bits.Val)
+#define PIE1        (PIE1bits.Val)
+#define PIR2        (PIR2bits.Val)
+#define PIE2        (PIE2bits.Val)
+#define T1CON       (T1CONbits.Val)
+#define PMCON1      (PMCON1bits.Val)
+#define UCON        (UCONbits.Val)
+#define UIR         (UIRbits.Val)
+#define UIE         (UIEbits.Val)
+#define UCFG        (UCFGbits.Val)
+#define UEP0        (UEP0bits.Val)
+#define UEP1        (UEP1bits.Val)
+#define UEP2        (UEP2bits.Val)
+#define UEP3        (UEP3bits.Val)
+#define UEP4        (UEP4bits.Val)
+#define UEP5        (UEP5bits.Val)
+#define UEP6        (UEP6bits.Val)
+#define UEP7        (UEP7bits.Val)
+#define OSCSTAT     (OSCSTATbits.Val)
+#define ACTCON      (ACTCONbits.Val)
+
+NATIVE_SFR(uint8_t, LATA);
+NATIVE_SFR(uint8_t, LATB);
+NATIVE_SFR(uint8_t, LATC);
+NATIVE_SFR(uint8_t, TRISA);
+NATIVE_SFR(uint8_t, TRISB);
+NATIVE_SFR(uint8_t, TRISC);
+NATIVE_SFR(uint8_t, ANSELA);
+NATIVE_SFR(uint8_t, ANSELB);
+NATIVE_SFR(uint8_t, ANSELC);
+NATIVE_SFR(uint8_t, WPUB);
+NATIVE_SFR(uint8_t, IOCAP);
+NATIVE_SFR(uint8_t, IOCAN);
+NATIVE_SFR(uint8_t, IOCAF);
+NATIVE_SFR(uint8_t, IOCBP);
+NATIVE_SFR(uint8_t, IOCBN);
+NATIVE_SFR(uint8_t, IOCBF);
+NATIVE_SFR(uint8_t, TMR1L);
+NATIVE_SFR(uint8_t, TMR1H);
+NATIVE_SFR(uint8_t, OSCCON);
+NATIVE_SFR(uint8_t, WDTCON);
+NATIVE_SFR(uint8_t, PMADRL);
+NATIVE_SFR(uint8_t, PMADRH);
+NATIVE_SFR(uint8_t, PMDATL);
+NATIVE_SFR(uint8_t, PMDATH);
+NATIVE_SFR(uint8_t, PMCON2);
+NATIVE_SFR(uint8_t, USTAT);
+NATIVE_SFR(uint8_t, UADDR);
+NATIVE_SFR(uint8_t, UEIR);
+NATIVE_SFR(uint8_t, UEIE);
+NATIVE_SFR(uint8_t, UFRML);
+NATIVE_SFR(uint8_t, UFRMH);
+
+/*
+ * On the virtual clock every firmware access to the pins, INTCON or
+ * TMR0 costs time, which is what lets a loop polling TMR0IF end. The
+ * macros refer to themselves, so the variable is what they expand to.
+ */
+#if defined(NATIVE_VIRTUAL_TIME) && !defined(NATIVE_SFR_DEFINE)
+void Native_Access(void);
+#define PORTAbits   (*(Native_Access(), &PORTAbits))
+#define PORTBbits   (*(Native_Access(), &PORTBbits))
+#define PORTCbits   (*(Native_Access(), &PORTCbits))
+#define INTCONbits  (*(Native_Access(), &INTCONbits))
+#define TMR0bits    (*(Native_Access(), &TMR0bits))
+#endif
+
+#endif /* NATIVE_XC_H */
@@ -0,0 +1,4 @@
+# The mapping Mapping_Load() falls back to. One usage (1-14) per button.
+#       A  B  C  X  Y  Z  L  R  START
+normal   1  2  3  4  5  6  7  8  9
+special  1  2  3 13 14 12 10 11  9
@@ -0,0 +1,347 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   padcfg.c
+ * padcfg: writes a button mapping profile to every pad at once, one
+ * thread per pad. Each pad is read first, written only when its mapping
+ * differs, and read back. Pads that answer CMD_INFO are configured
+ * through the commands on interface 1's interrupt endpoints
+ * (common/padcmd.h); the others, and every pad with --feature, through
+ * the mapping Feature report on EP0 (common/mapreport.h), whose read
+ * back has to match the report the firmware is expected to build, CRC
+ * included. Without --profile the current mappings are only read and
+ * printed.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "usb.h"
+
+#include "hidraw.h"
+#include "mapreport.h"
+#include "padcmd.h"
+
+#define MAX_PADS            128
+#define INFO_TIMEOUT_MS     100     // a pad without the command endpoint
+#define CMD_TIMEOUT_MS      200
+#define WRITE_TIMEOUT_MS    1000    // two flash rows before the answer
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+
+typedef struct
+{
+    const char *profilePath;
+    const char *jsonPath;
+    bool        force;
+    bool        feature;
+    const char *nodes[MAX_PADS];
+    int         nodeCount;
+} OPTIONS;
+
+typedef struct
+{
+    char        name[HIDRAW_PATH_MAX];
+    char        node[HIDRAW_PATH_MAX];
+    pthread_t   tid;
+    bool        ok;
+    bool        written;
+    bool        commands;       // through padcmd.h rather than the Feature report
+    const char *error;
+    MAP_PROFILE before;
+    MAP_PROFILE after;
+    uint64_t    readUs;         // first read
+    uint64_t    writeUs;        // the write, the flash rows included
+    uint64_t    verifyUs;       // read after the write
+    uint64_t    totalUs;        // open to close
+} JOB;
+
+static OPTIONS opt;
+static MAP_PROFILE profile;
+static JOB jobs[MAX_PADS];
+static int jobCount;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: padcfg [options] [HIDRAW ...]\n"
+        "  HIDRAW            interface 1 node of a pad (default: every pad\n"
+        "                    found by VID:PID)\n"
+        "  --profile FILE    write this mapping (see README); without it the\n"
+        "                    mappings are only read and printed\n"
+        "  --force           write even when a pad already has the mapping\n"
+        "  --feature         use the Feature report on EP0 even on pads that\n"
+        "                    take commands on their interrupt endpoints\n"
+        "  --json FILE       per-pad results and timing as JSON\n");
+    exit(2);
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strncmp(a, "--", 2) != 0) {
+            if (o->nodeCount == MAX_PADS) usage();
+            o->nodes[o->nodeCount++] = a;
+            continue;
+        }
+        if (strcmp(a, "--force") == 0) {
+            o->force = true;
+            continue;
+        }
+        if (strcmp(a, "--feature") == 0) {
+            o->feature = true;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--profile") == 0) {
+            o->profilePath = v;
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else {
+            usage();
+        }
+    }
+}
+
+static uint64_t nowUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void fromAnswer(const uint8_t *answer, MAP_PROFILE *prof)
+{
+    memcpy(prof->normal, &answer[CMD_DATA_OFFSET], MAPREPORT_BUTTONS);
+    memcpy(prof->special, &answer[CMD_DATA_OFFSET + MAPREPORT_BUTTONS], MAPREPORT_BUTTONS);
+}
+
+/* CMD_GET_MAPPING into prof */
+static bool getByCommand(int fd, MAP_PROFILE *prof)
+{
+    uint8_t answer[CMD_REPORT_SIZE];
+
+    if (!PadCmd_Exchange(fd, CMD_GET_MAPPING, NULL, 0, answer, CMD_TIMEOUT_MS)) return false;
+    if (answer[3] != CMD_STATUS_OK) return false;
+    fromAnswer(answer, prof);
+    return true;
+}
+
+static void byCommands(JOB *j, int fd)
+{
+    uint8_t data[2 * MAPREPORT_BUTTONS], answer[CMD_REPORT_SIZE];
+    uint64_t t = nowUs();
+
+    if (!getByCommand(fd, &j->before)) {
+        j->error = "reading the mapping failed";
+        return;
+    }
+    j->readUs = nowUs() - t;
+    j->after = j->before;
+    if (opt.profilePath == NULL || (!opt.force && memcmp(&j->before, &profile, sizeof(profile)) == 0)) {
+        j->ok = true;
+        return;
+    }
+
+    memcpy(data, profile.normal, MAPREPORT_BUTTONS);
+    memcpy(&data[MAPREPORT_BUTTONS], profile.special, MAPREPORT_BUTTONS);
+    t = nowUs();
+    if (!PadCmd_Exchange(fd, CMD_SET_MAPPING, data, sizeof(data), answer, WRITE_TIMEOUT_MS)
+            || answer[3] != CMD_STATUS_OK) {
+        j->error = "writing the mapping failed";
+        return;
+    }
+    j->writeUs = nowUs() - t;
+    j->written = true;
+
+    t = nowUs();
+    if (!getByCommand(fd, &j->after)) {
+        j->error = "reading back failed";
+        return;
+    }
+    j->verifyUs = nowUs() - t;
+    if (memcmp(&j->after, &profile, sizeof(profile)) != 0) {
+        j->error = "read back differs";
+        return;
+    }
+    j->ok = true;
+}
+
+static void byFeatureReport(JOB *j, int fd)
+{
+    uint8_t before[MAPREPORT_SIZE], after[MAPREPORT_SIZE], want[MAPREPORT_SIZE];
+    uint64_t t = nowUs();
+
+    if (!MapReport_Get(fd, before)) {
+        j->error = "reading the mapping failed";
+        return;
+    }
+    j->readUs = nowUs() - t;
+    MapReport_ToProfile(before, &j->before);
+    j->after = j->before;
+    if (opt.profilePath == NULL || (!opt.force && memcmp(&j->before, &profile, sizeof(profile)) == 0)) {
+        j->ok = true;
+        return;
+    }
+
+    MapReport_Build(want, &profile, before);
+    t = nowUs();
+    if (!MapReport_Set(fd, want)) {
+        j->error = "writing the mapping failed";
+        return;
+    }
+    j->writeUs = nowUs() - t;
+    j->written = true;
+
+    t = nowUs();
+    if (!MapReport_Get(fd, after)) {
+        j->error = "reading back failed";
+        return;
+    }
+    j->verifyUs = nowUs() - t;
+    MapReport_ToProfile(after, &j->after);
+    if (memcmp(after, want, sizeof(want)) != 0) {
+        j->error = "read back differs";
+        return;
+    }
+    j->ok = true;
+}
+
+static void *jobThread(void *arg)
+{
+    JOB *j = arg;
+    uint64_t start = nowUs();
+    uint8_t answer[CMD_REPORT_SIZE];
+    int fd = open(j->node, O_RDWR | O_CLOEXEC);
+
+    if (fd < 0) {
+        j->error = strerror(errno);
+    } else {
+        j->commands = !opt.feature
+                && PadCmd_Exchange(fd, CMD_INFO, NULL, 0, answer, INFO_TIMEOUT_MS)
+                && answer[3] == CMD_STATUS_OK;
+        if (j->commands) {
+            byCommands(j, fd);
+        } else {
+            byFeatureReport(j, fd);
+        }
+        close(fd);
+    }
+    j->totalUs = nowUs() - start;
+    return NULL;
+}
+
+static void writeJson(FILE *fp, uint64_t runUs)
+{
+    fprintf(fp, "{\n  \"tool\": \"padcfg\",\n");
+    fprintf(fp, "  \"run_time_us\": %llu,\n", (unsigned long long)runUs);
+    fprintf(fp, "  \"pads\": [");
+    for (int i = 0; i < jobCount; i++) {
+        const JOB *j = &jobs[i];
+
+        fprintf(fp, "%s\n    { \"name\": \"%s\", \"node\": \"%s\", \"ok\": %s, \"written\": %s, \"transport\": \"%s\", ",
+                i ? "," : "", j->name, j->node, j->ok ? "true" : "false", j->written ? "true" : "false",
+                j->commands ? "commands" : "feature");
+        if (j->error) fprintf(fp, "\"error\": \"%s\", ", j->error);
+        fprintf(fp, "\"read_us\": %llu, \"write_us\": %llu, \"verify_us\": %llu, \"total_us\": %llu }",
+                (unsigned long long)j->readUs, (unsigned long long)j->writeUs,
+                (unsigned long long)j->verifyUs, (unsigned long long)j->totalUs);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t start;
+    int failed = 0;
+
+    parseArgs(argc, argv, &opt);
+    if (opt.profilePath && !MapReport_LoadProfile(opt.profilePath, &profile)) return 1;
+
+    if (opt.nodeCount) {
+        for (jobCount = 0; jobCount < opt.nodeCount; jobCount++) {
+            snprintf(jobs[jobCount].node, sizeof(jobs[jobCount].node), "%s", opt.nodes[jobCount]);
+            snprintf(jobs[jobCount].name, sizeof(jobs[jobCount].name), "%s", opt.nodes[jobCount]);
+        }
+    } else {
+        static HIDRAW_PAD pads[MAX_PADS];
+        int n = Hidraw_FindPads(device_dsc.idVendor, device_dsc.idProduct, pads, MAX_PADS);
+
+        for (int i = 0; i < n; i++) {
+            if (pads[i].node[1][0] == '\0') continue;
+            memcpy(jobs[jobCount].name, pads[i].name, sizeof(jobs[jobCount].name));
+            memcpy(jobs[jobCount].node, pads[i].node[1], sizeof(jobs[jobCount].node));
+            jobCount++;
+        }
+    }
+    if (jobCount == 0) {
+        fprintf(stderr, "padcfg: no pads found (%04x:%04x)\n", device_dsc.idVendor, device_dsc.idProduct);
+        return 1;
+    }
+
+    start = nowUs();
+    for (int i = 0; i < jobCount; i++) {
+        if (pthread_create(&jobs[i].tid, NULL, jobThread, &jobs[i]) != 0) {
+            perror("pthread_create");
+            return 1;
+        }
+    }
+    for (int i = 0; i < jobCount; i++) {
+        pthread_join(jobs[i].tid, NULL);
+    }
+
+    for (int i = 0; i < jobCount; i++) {
+        const JOB *j = &jobs[i];
+
+        if (!j->ok) failed++;
+        if (opt.profilePath == NULL && j->ok) {
+            printf("# %s (%s)\n", j->name, j->node);
+            MapReport_WriteProfile(stdout, &j->before);
+        } else {
+            fprintf(stderr, "%-40s %s %s %6.1f ms\n", j->name,
+                    j->ok ? "ok  " : "FAIL", j->ok ? (j->written ? "written  " : "unchanged")
+                                                    : j->error, j->totalUs / 1000.0);
+        }
+    }
+    fprintf(stderr, "padcfg: %d pads, %d failed, %.1f ms\n", jobCount, failed, (nowUs() - start) / 1000.0);
+
+    if (opt.jsonPath) {
+        FILE *fp = fopen(opt.jsonPath, "w");
+
+        if (fp == NULL) {
+            perror(opt.jsonPath);
+            return 1;
+        }
+        writeJson(fp, nowUs() - start);
+        fclose(fp);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,445 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   padflash.c
+ * padflash: updates the application of every pad through the USB
+ * bootloader (project_SS_bootloader.X), one thread per pad. A pad
+ * running the application is asked to restart into the bootloader and
+ * found again under the same USB path.
+ *
+ * Only rows whose CRC on the pad differs from the image are written
+ * (BOOT_CMD_ROW_CRCS); --full writes them all. Row 0xC00, which holds
+ * the application's vectors, is blanked first and written last, after
+ * the CRC of the rest matched, so an update cut short leaves a pad that
+ * stays in the bootloader rather than one that starts half an image.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "usb.h"
+
+#include "hidraw.h"
+#include "ihex.h"
+#include "bootpacket.h"
+
+#define MAX_PADS        128
+#define COMMAND_MS      1000    // a row write is an erase and a write, ~4 ms
+#define RESCAN_MS       100
+#define APP_ROWS        ((BOOT_APP_END - BOOT_APP_START) / BOOT_ROW_WORDS)
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+
+typedef struct
+{
+    const char *hexPath;
+    const char *diffPath;
+    const char *jsonPath;
+    const char *pads[MAX_PADS];
+    int         padCount;
+    int         timeoutMs;
+    bool        full;
+    bool        noStart;
+} OPTIONS;
+
+typedef struct
+{
+    HIDRAW_PAD  pad;
+    pthread_t   tid;
+    const char *error;
+    int         protocol;
+    int         rowsWritten;
+    int         rowsSkipped;
+    uint64_t    enterMs;        // restart request until the bootloader showed up
+    uint64_t    flashMs;        // first to last command
+    uint64_t    startMs;        // RESET until the application showed up
+    uint64_t    totalMs;
+} JOB;
+
+static OPTIONS opt;
+static IHEX_IMAGE image;
+static uint16_t imageCrc[APP_ROWS];
+static JOB jobs[MAX_PADS];
+static int jobCount;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: padflash [options] HEX\n"
+        "  HEX               application image, linked with code offset 0xC04\n"
+        "  --pad NAME        only this pad (USB path as printed), repeatable;\n"
+        "                    default: every pad found by VID:PID\n"
+        "  --full            write every row, not only the ones that differ\n"
+        "  --timeout S       wait this long for a pad to re-enumerate (5)\n"
+        "  --no-start        stay in the bootloader after writing\n"
+        "  --json FILE       per-pad results and timing as JSON\n"
+        "  --diff OLD        no pads: count the rows an update from OLD writes\n");
+    exit(2);
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->timeoutMs = 5000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strncmp(a, "--", 2) != 0) {
+            if (o->hexPath != NULL) usage();
+            o->hexPath = a;
+            continue;
+        }
+        if (strcmp(a, "--full") == 0) {
+            o->full = true;
+            continue;
+        }
+        if (strcmp(a, "--no-start") == 0) {
+            o->noStart = true;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--pad") == 0) {
+            if (o->padCount == MAX_PADS) usage();
+            o->pads[o->padCount++] = v;
+        } else if (strcmp(a, "--timeout") == 0) {
+            o->timeoutMs = (int)(atof(v) * 1000);
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else if (strcmp(a, "--diff") == 0) {
+            o->diffPath = v;
+        } else {
+            usage();
+        }
+    }
+    if (o->hexPath == NULL) usage();
+}
+
+static uint64_t nowMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* the application has to start above the bootloader; what lies in the
+ * mapping rows or the configuration words is left as it is */
+static bool checkImage(const char *path, const IHEX_IMAGE *img)
+{
+    bool kept = false;
+
+    for (unsigned a = 0; a < IHEX_PROGMEM_WORDS; a++) {
+        if (!img->used[a] || a >= BOOT_APP_RESET) continue;
+        fprintf(stderr, "padflash: %s: word 0x%04X is in the bootloader; "
+                "link the application with code offset 0x%X\n", path, a, BOOT_APP_RESET);
+        return false;
+    }
+    for (unsigned a = BOOT_APP_END; a < IHEX_PROGMEM_WORDS; a++) {
+        kept |= img->used[a];
+    }
+    for (unsigned i = 0; i < IHEX_CONFIG_WORDS; i++) {
+        kept |= img->config_used[i];
+    }
+    if (kept) {
+        fprintf(stderr, "padflash: mapping rows and configuration words in %s are not written\n", path);
+    }
+    return true;
+}
+
+static const uint16_t *imageRow(const IHEX_IMAGE *img, int row)
+{
+    return &img->progmem[BOOT_APP_START + row * BOOT_ROW_WORDS];
+}
+
+static bool wanted(const char *name)
+{
+    if (opt.padCount == 0) return true;
+    for (int i = 0; i < opt.padCount; i++) {
+        if (strcmp(opt.pads[i], name) == 0) return true;
+    }
+    return false;
+}
+
+/* wait for the pad at this USB path to show up in the bootloader (inBoot)
+ * or in the application */
+static bool findPad(const char *name, bool inBoot, HIDRAW_PAD *pad)
+{
+    HIDRAW_PAD *pads = malloc(MAX_PADS * sizeof(*pads));
+    uint64_t end = nowMs() + (uint64_t)opt.timeoutMs;
+    bool found = false;
+
+    if (pads == NULL) return false;
+    do {
+        int n = Hidraw_FindPads(device_dsc.idVendor, device_dsc.idProduct, pads, MAX_PADS);
+
+        for (int i = 0; i < n && !found; i++) {
+            if (strcmp(pads[i].name, name) != 0 || pads[i].node[0][0] == '\0') continue;
+            if ((pads[i].node[1][0] == '\0') == inBoot) {
+                *pad = pads[i];
+                found = true;
+            }
+        }
+        if (!found) usleep(RESCAN_MS * 1000);
+    } while (!found && nowMs() < end);
+    free(pads);
+    return found;
+}
+
+static const char *command(int fd, uint8_t cmd, uint16_t address, uint16_t count,
+                           const uint8_t *data, uint8_t *answer)
+{
+    if (!BootPacket_Command(fd, cmd, address, count, data, answer, COMMAND_MS)) {
+        return "no answer from the bootloader";
+    }
+    switch (answer[1]) {
+        case BOOT_STATUS_OK:        return NULL;
+        case BOOT_STATUS_RANGE:     return "address refused by the bootloader";
+        case BOOT_STATUS_VERIFY:    return "flash read back differs";
+        default:                    return "command refused by the bootloader";
+    }
+}
+
+static const char *writeRow(int fd, uint16_t address, const uint16_t *words)
+{
+    uint8_t data[BOOT_PACKET_SIZE - BOOT_DATA_OFFSET] = { 0 };
+    uint8_t answer[BOOT_PACKET_SIZE];
+
+    BootPacket_PackRow(words, data);
+    return command(fd, BOOT_CMD_WRITE_ROW, address, BOOT_ROW_WORDS, data, answer);
+}
+
+static const char *checkCrc(int fd, uint16_t address, uint16_t count)
+{
+    uint8_t answer[BOOT_PACKET_SIZE];
+    const char *err = command(fd, BOOT_CMD_CRC, address, count, NULL, answer);
+    uint16_t crc;
+
+    if (err) return err;
+    crc = (uint16_t)(answer[BOOT_DATA_OFFSET] | answer[BOOT_DATA_OFFSET + 1] << 8);
+    return crc == BootPacket_Crc16(&image.progmem[address], count) ? NULL : "CRC differs";
+}
+
+/* mark the rows whose CRC on the pad differs from the image */
+static const char *findChanges(int fd, bool *changed)
+{
+    uint8_t answer[BOOT_PACKET_SIZE];
+
+    for (int row = 0; row < APP_ROWS; row += BOOT_ROW_CRCS) {
+        int n = APP_ROWS - row < BOOT_ROW_CRCS ? APP_ROWS - row : BOOT_ROW_CRCS;
+        const uint8_t *crc = &answer[BOOT_DATA_OFFSET];
+        const char *err = command(fd, BOOT_CMD_ROW_CRCS, (uint16_t)(BOOT_APP_START + row * BOOT_ROW_WORDS),
+                                  (uint16_t)n, NULL, answer);
+
+        if (err) return err;
+        for (int i = 0; i < n; i++) {
+            changed[row + i] = (uint16_t)(crc[2 * i] | crc[2 * i + 1] << 8) != imageCrc[row + i];
+        }
+    }
+    return NULL;
+}
+
+static const char *flash(JOB *j, int fd)
+{
+    static const uint16_t blank[BOOT_ROW_WORDS] = {
+        [0 ... BOOT_ROW_WORDS - 1] = IHEX_BLANK
+    };
+    uint8_t answer[BOOT_PACKET_SIZE];
+    const uint8_t *q = &answer[BOOT_DATA_OFFSET];
+    const uint16_t first = BOOT_APP_START + BOOT_ROW_WORDS;
+    bool changed[APP_ROWS];
+    bool any = false;
+    const char *err;
+
+    if ((err = command(fd, BOOT_CMD_QUERY, 0, 0, NULL, answer)) != NULL) return err;
+    j->protocol = q[0];
+    if (q[0] < 1 || q[0] > BOOT_PROTOCOL_VER || q[1] != BOOT_ROW_WORDS
+        || (q[2] | q[3] << 8) != BOOT_APP_START || (q[4] | q[5] << 8) != BOOT_APP_END) {
+        return "bootloader speaks another protocol version";
+    }
+
+    if (opt.full || j->protocol < 2) {
+        memset(changed, true, sizeof(changed));
+    } else if ((err = findChanges(fd, changed)) != NULL) {
+        return err;
+    }
+    for (int row = 0; row < APP_ROWS; row++) {
+        any |= changed[row];
+    }
+
+    if (any) {
+        if ((err = writeRow(fd, BOOT_APP_START, blank)) != NULL) return err;
+        for (int row = 1; row < APP_ROWS; row++) {
+            if (!changed[row]) continue;
+            if ((err = writeRow(fd, (uint16_t)(BOOT_APP_START + row * BOOT_ROW_WORDS), imageRow(&image, row))) != NULL) {
+                return err;
+            }
+            j->rowsWritten++;
+        }
+        if ((err = checkCrc(fd, first, BOOT_APP_END - first)) != NULL) return err;
+
+        if ((err = writeRow(fd, BOOT_APP_START, imageRow(&image, 0))) != NULL) return err;
+        if ((err = checkCrc(fd, BOOT_APP_START, BOOT_ROW_WORDS)) != NULL) return err;
+        j->rowsWritten++;
+    }
+    j->rowsSkipped = APP_ROWS - j->rowsWritten;
+
+    if (!opt.noStart) return command(fd, BOOT_CMD_RESET, 0, 0, NULL, answer);
+    return NULL;
+}
+
+static const char *update(JOB *j)
+{
+    HIDRAW_PAD pad = j->pad;
+    const char *err;
+    uint64_t t;
+    int fd;
+
+    if (pad.node[1][0] != '\0') {
+        fd = open(pad.node[1], O_RDWR | O_CLOEXEC);
+        if (fd < 0) return strerror(errno);
+        t = nowMs();
+        if (!BootPacket_Request(fd)) {
+            close(fd);
+            return "restart request refused";
+        }
+        close(fd);
+        if (!findPad(j->pad.name, true, &pad)) return "did not come back in the bootloader";
+        j->enterMs = nowMs() - t;
+    }
+
+    fd = open(pad.node[0], O_RDWR | O_CLOEXEC);
+    if (fd < 0) return strerror(errno);
+    t = nowMs();
+    err = flash(j, fd);
+    j->flashMs = nowMs() - t;
+    close(fd);
+    if (err || opt.noStart) return err;
+
+    t = nowMs();
+    if (!findPad(j->pad.name, false, &pad)) return "application did not come back";
+    j->startMs = nowMs() - t;
+    return NULL;
+}
+
+static void *jobThread(void *arg)
+{
+    JOB *j = arg;
+    uint64_t start = nowMs();
+
+    j->error = update(j);
+    j->totalMs = nowMs() - start;
+    return NULL;
+}
+
+/* what an update from the old image to this one sends, without pads */
+static int diff(void)
+{
+    static IHEX_IMAGE old;
+    int rows = 0;
+
+    if (!Ihex_Load(opt.diffPath, &old) || !checkImage(opt.diffPath, &old)) return 1;
+    for (int row = 0; row < APP_ROWS; row++) {
+        if (memcmp(imageRow(&old, row), imageRow(&image, row), BOOT_ROW_WORDS * sizeof(uint16_t)) != 0) rows++;
+    }
+    printf("%s -> %s: %d of %d rows differ\n", opt.diffPath, opt.hexPath, rows, APP_ROWS);
+    return 0;
+}
+
+static void writeJson(FILE *fp, uint64_t runMs)
+{
+    fprintf(fp, "{\n  \"tool\": \"padflash\",\n");
+    fprintf(fp, "  \"image\": \"%s\",\n", opt.hexPath);
+    fprintf(fp, "  \"run_time_ms\": %llu,\n", (unsigned long long)runMs);
+    fprintf(fp, "  \"pads\": [");
+    for (int i = 0; i < jobCount; i++) {
+        const JOB *j = &jobs[i];
+
+        fprintf(fp, "%s\n    { \"name\": \"%s\", \"ok\": %s, ", i ? "," : "", j->pad.name, j->error ? "false" : "true");
+        if (j->error) fprintf(fp, "\"error\": \"%s\", ", j->error);
+        fprintf(fp, "\"protocol\": %d, \"rows_written\": %d, \"rows_skipped\": %d, ",
+                j->protocol, j->rowsWritten, j->rowsSkipped);
+        fprintf(fp, "\"enter_ms\": %llu, \"flash_ms\": %llu, \"start_ms\": %llu, \"total_ms\": %llu }",
+                (unsigned long long)j->enterMs, (unsigned long long)j->flashMs,
+                (unsigned long long)j->startMs, (unsigned long long)j->totalMs);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    static HIDRAW_PAD pads[MAX_PADS];
+    uint64_t start;
+    int n, failed = 0;
+
+    parseArgs(argc, argv, &opt);
+    if (!Ihex_Load(opt.hexPath, &image) || !checkImage(opt.hexPath, &image)) return 1;
+    if (opt.diffPath) return diff();
+    for (int row = 0; row < APP_ROWS; row++) {
+        imageCrc[row] = BootPacket_Crc16(imageRow(&image, row), BOOT_ROW_WORDS);
+    }
+
+    n = Hidraw_FindPads(device_dsc.idVendor, device_dsc.idProduct, pads, MAX_PADS);
+    for (int i = 0; i < n; i++) {
+        if (wanted(pads[i].name)) jobs[jobCount++].pad = pads[i];
+    }
+    if (jobCount == 0) {
+        fprintf(stderr, "padflash: no pads found (%04x:%04x)\n", device_dsc.idVendor, device_dsc.idProduct);
+        return 1;
+    }
+
+    start = nowMs();
+    for (int i = 0; i < jobCount; i++) {
+        if (pthread_create(&jobs[i].tid, NULL, jobThread, &jobs[i]) != 0) {
+            perror("pthread_create");
+            return 1;
+        }
+    }
+    for (int i = 0; i < jobCount; i++) {
+        pthread_join(jobs[i].tid, NULL);
+    }
+
+    for (int i = 0; i < jobCount; i++) {
+        const JOB *j = &jobs[i];
+
+        if (j->error) failed++;
+        fprintf(stderr, "%-40s %s %3d rows %6.1f s\n", j->pad.name, j->error ? j->error : "ok  ",
+                j->rowsWritten, j->totalMs / 1000.0);
+    }
+    fprintf(stderr, "padflash: %d pads, %d failed, %.1f s\n", jobCount, failed, (nowMs() - start) / 1000.0);
+
+    if (opt.jsonPath) {
+        FILE *fp = fopen(opt.jsonPath, "w");
+
+        if (fp == NULL) {
+            perror(opt.jsonPath);
+            return 1;
+        }
+        writeJson(fp, nowMs() - start);
+        fclose(fp);
+    }
+    return failed ? 1 : 0;
+}
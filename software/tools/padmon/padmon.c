@@ -0,0 +1,528 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   padmon.c
+ * padmon: watches the input reports of any number of pads on hidraw,
+ * one thread per pad, and writes per-pad statistics as JSON when it
+ * stops. Each report is timestamped (CLOCK_MONOTONIC) as read() returns.
+ *
+ * Interface 0 gives the report interval and the frames missed against
+ * bInterval. When interface 1 delivers the extended report (report 4,
+ * ext_report.h) its sequence numbers count the samples the host never
+ * read, its sample times give the interval as the pad saw it, and the
+ * button changes are logged with the pad's time; otherwise they are
+ * decoded from interface 0.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "usb.h"
+#include "app_device_joystick.h"
+#include "ext_report.h"
+
+#include "hidraw.h"
+#include "samples.h"
+#include "stimulus.h"
+#include "uhidpad.h"
+
+#define MAX_PADS            64
+#define POLL_MS             100
+#define DEFAULT_INTERVAL_US 1000
+#define HIST_FRAMES         8       // last bucket is "8 frames or more"
+#define UHID_WAIT_MS        2000
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+
+typedef struct
+{
+    const char *jsonPath;
+    const char *eventsPath;
+    double      runUs;          // 0 = until SIGINT
+    double      statusUs;       // 0 = no status lines
+    unsigned    intervalUs;     // 0 = bInterval from sysfs
+    int         uhidPads;
+    unsigned    uhidDropPermille;
+    const char *nodes[MAX_PADS];
+    int         nodeCount;
+} OPTIONS;
+
+typedef struct
+{
+    HIDRAW_PAD  pad;
+    int         fd[2];
+    unsigned    frameUs;
+    pthread_t   tid;
+
+    // interface 0
+    uint64_t    reports;
+    uint64_t    lastUs;
+    SAMPLES     interval;
+    uint64_t    hist[HIST_FRAMES + 1];
+    uint64_t    missedFrames;
+    uint64_t    shortReads;
+    uint8_t     last[sizeof(INPUT_CONTROLS)];
+    uint64_t    changes;
+
+    // interface 1, report 4
+    uint64_t    extReports;
+    uint64_t    extLastUs;
+    uint8_t     lastSeq;
+    uint16_t    lastSampleUs;
+    uint64_t    seqGaps;
+    uint64_t    seqSkipped;
+    uint64_t    seqRepeats;
+    SAMPLES     deviceInterval;
+    SAMPLES     transportJitter;
+    uint8_t     extLast[sizeof(INPUT_CONTROLS)];
+} MONITOR;
+
+static OPTIONS opt;
+static MONITOR mon[MAX_PADS];
+static int monCount;
+static volatile sig_atomic_t stop;
+static FILE *events;
+static pthread_mutex_t eventsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *const buttonNames[14] = {
+    "a", "b", "c", "x", "y", "z", "L1", "R1",
+    "start", "L2", "R2", "home", "right_stick", "left_stick"
+};
+static const char *const axisNames[4] = { "X", "Y", "Z", "Rz" };
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: padmon [options] [NODE0[,NODE1] ...]\n"
+        "  NODE0[,NODE1]     hidraw nodes of one pad, interface 0 and optionally\n"
+        "                    interface 1 (default: every pad found by VID:PID)\n"
+        "  --time TIME       stop after TIME (default: at SIGINT)\n"
+        "  --interval TIME   expected report interval (default: bInterval from\n"
+        "                    sysfs, else 1ms)\n"
+        "  --events FILE     log every button change as CSV\n"
+        "  --status TIME     write a line per pad to stderr every TIME\n"
+        "  --json FILE       write the statistics here (default: stdout)\n"
+        "  --uhid N          create N stand-in pads on /dev/uhid and watch them\n"
+        "  --drop PERMILLE   frames per thousand the stand-in pads leave out\n");
+    exit(2);
+}
+
+static double parseTime(const char *name, const char *v)
+{
+    double us;
+
+    if (!Stim_ParseTime(v, &us) || us <= 0) {
+        fprintf(stderr, "padmon: %s needs a time such as 10s\n", name);
+        exit(2);
+    }
+    return us;
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strncmp(a, "--", 2) != 0) {
+            if (o->nodeCount == MAX_PADS) usage();
+            o->nodes[o->nodeCount++] = a;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--time") == 0) {
+            o->runUs = parseTime(a, v);
+        } else if (strcmp(a, "--interval") == 0) {
+            o->intervalUs = (unsigned)parseTime(a, v);
+        } else if (strcmp(a, "--status") == 0) {
+            o->statusUs = parseTime(a, v);
+        } else if (strcmp(a, "--events") == 0) {
+            o->eventsPath = v;
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else if (strcmp(a, "--uhid") == 0) {
+            o->uhidPads = atoi(v);
+            if (o->uhidPads <= 0 || o->uhidPads > MAX_PADS) usage();
+        } else if (strcmp(a, "--drop") == 0) {
+            o->uhidDropPermille = (unsigned)atoi(v);
+        } else {
+            usage();
+        }
+    }
+}
+
+static uint64_t nowUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* one CSV line: pad,host_us,device_us,seq,changes ("+a -b hat=2 X=128") */
+static void logChange(const MONITOR *m, uint64_t hostUs, const uint8_t *prev, const uint8_t *cur,
+                      bool ext, uint16_t deviceUs, uint8_t seq)
+{
+    INPUT_CONTROLS p, c;
+    const char *sep = "";
+
+    if (events == NULL) return;
+    memcpy(p.val, prev, sizeof(p.val));
+    memcpy(c.val, cur, sizeof(c.val));
+
+    pthread_mutex_lock(&eventsLock);
+    fprintf(events, "%s,%llu,", m->pad.name, (unsigned long long)hostUs);
+    if (ext) {
+        fprintf(events, "%u,%u,", deviceUs, seq);
+    } else {
+        fprintf(events, ",,");
+    }
+    for (int b = 0; b < 14; b++) {
+        bool was = (p.val[b / 8] >> (b % 8)) & 1;
+        bool is = (c.val[b / 8] >> (b % 8)) & 1;
+
+        if (was != is) {
+            fprintf(events, "%s%c%s", sep, is ? '+' : '-', buttonNames[b]);
+            sep = " ";
+        }
+    }
+    if (p.members.hat_switch.hat_switch != c.members.hat_switch.hat_switch) {
+        fprintf(events, "%shat=%u", sep, c.members.hat_switch.hat_switch);
+        sep = " ";
+    }
+    for (int a = 0; a < 4; a++) {
+        if (p.val[3 + a] != c.val[3 + a]) {
+            fprintf(events, "%s%s=%u", sep, axisNames[a], c.val[3 + a]);
+            sep = " ";
+        }
+    }
+    fputc('\n', events);
+    pthread_mutex_unlock(&eventsLock);
+}
+
+static void onReport(MONITOR *m, const uint8_t *buf, ssize_t len, uint64_t t)
+{
+    if (len != (ssize_t)sizeof(INPUT_CONTROLS)) {
+        m->shortReads++;
+        return;
+    }
+    if (m->reports > 0) {
+        uint64_t d = t - m->lastUs;
+        uint64_t frames = (d + m->frameUs / 2) / m->frameUs;
+
+        Sample_Add(&m->interval, (uint32_t)(d > UINT32_MAX ? UINT32_MAX : d));
+        m->hist[frames > HIST_FRAMES ? HIST_FRAMES : frames]++;
+        // a report that came half a frame or more late stood for missed polls
+        if (2 * d >= 3 * (uint64_t)m->frameUs) m->missedFrames += frames - 1;
+        if (m->extReports == 0 && memcmp(buf, m->last, sizeof(m->last)) != 0) {
+            m->changes++;
+            logChange(m, t, m->last, buf, false, 0, 0);
+        }
+    }
+    memcpy(m->last, buf, sizeof(m->last));
+    m->lastUs = t;
+    m->reports++;
+}
+
+static void onExtReport(MONITOR *m, const uint8_t *buf, ssize_t len, uint64_t t)
+{
+    uint8_t seq;
+    uint16_t sampleUs;
+
+    if (len != EXT_REPORT_SIZE || buf[0] != EXT_REPORT_ID) return;
+    seq = buf[1];
+    sampleUs = (uint16_t)(buf[2] | buf[3] << 8);
+
+    if (m->extReports > 0) {
+        uint8_t step = (uint8_t)(seq - m->lastSeq);
+        uint64_t hostUs = t - m->extLastUs;
+        uint16_t deviceUs = (uint16_t)(sampleUs - m->lastSampleUs);
+
+        if (step == 0) {
+            m->seqRepeats++;
+        } else if (step > 1) {
+            m->seqGaps++;
+            m->seqSkipped += step - 1u;
+        }
+        // the sample clock wraps at 65.5 ms
+        if (hostUs < 60000) {
+            Sample_Add(&m->deviceInterval, deviceUs);
+            Sample_Add(&m->transportJitter, (uint32_t)(hostUs > deviceUs ? hostUs - deviceUs : deviceUs - hostUs));
+        }
+    } else {
+        // the first one starts the log from interface 0's idea of the state
+        memcpy(m->extLast, m->reports > 0 ? m->last : &buf[4], sizeof(m->extLast));
+    }
+    if (memcmp(&buf[4], m->extLast, sizeof(m->extLast)) != 0) {
+        m->changes++;
+        logChange(m, t, m->extLast, &buf[4], true, sampleUs, seq);
+    }
+    memcpy(m->extLast, &buf[4], sizeof(m->extLast));
+    m->lastSeq = seq;
+    m->lastSampleUs = sampleUs;
+    m->extLastUs = t;
+    m->extReports++;
+}
+
+static void *padThread(void *arg)
+{
+    MONITOR *m = arg;
+    struct pollfd pfd[2];
+    nfds_t n = 0;
+
+    for (int i = 0; i < 2; i++) {
+        if (m->fd[i] < 0) continue;
+        pfd[n].fd = m->fd[i];
+        pfd[n].events = POLLIN;
+        n++;
+    }
+    while (!stop) {
+        int r = poll(pfd, n, POLL_MS);
+
+        if (r < 0 && errno != EINTR) break;
+        for (nfds_t i = 0; r > 0 && i < n; i++) {
+            uint8_t buf[64];
+            ssize_t len;
+            uint64_t t;
+
+            if (pfd[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                fprintf(stderr, "padmon: %s: device gone\n", m->pad.name);
+                return NULL;
+            }
+            if (!(pfd[i].revents & POLLIN)) continue;
+            len = read(pfd[i].fd, buf, sizeof(buf));
+            t = nowUs();
+            if (len <= 0) continue;
+            if (pfd[i].fd == m->fd[0]) {
+                onReport(m, buf, len, t);
+            } else {
+                onExtReport(m, buf, len, t);
+            }
+        }
+    }
+    return NULL;
+}
+
+static bool openPad(MONITOR *m)
+{
+    for (int i = 0; i < 2; i++) {
+        m->fd[i] = -1;
+        if (m->pad.node[i][0] == '\0') continue;
+        m->fd[i] = open(m->pad.node[i], O_RDONLY | O_CLOEXEC);
+        if (m->fd[i] < 0) {
+            perror(m->pad.node[i]);
+            return false;
+        }
+    }
+    if (m->fd[0] < 0) {
+        fprintf(stderr, "padmon: %s has no interface 0 node\n", m->pad.name);
+        return false;
+    }
+    m->frameUs = opt.intervalUs ? opt.intervalUs
+               : m->pad.intervalUs ? m->pad.intervalUs : DEFAULT_INTERVAL_US;
+    return true;
+}
+
+/* explicit nodes are their own pad names */
+static int padsFromArgs(HIDRAW_PAD *pads)
+{
+    for (int i = 0; i < opt.nodeCount; i++) {
+        const char *comma = strchr(opt.nodes[i], ',');
+        int len0 = comma ? (int)(comma - opt.nodes[i]) : (int)strlen(opt.nodes[i]);
+
+        memset(&pads[i], 0, sizeof(pads[i]));
+        snprintf(pads[i].node[0], sizeof(pads[i].node[0]), "%.*s", len0, opt.nodes[i]);
+        if (comma) snprintf(pads[i].node[1], sizeof(pads[i].node[1]), "%s", comma + 1);
+        snprintf(pads[i].name, sizeof(pads[i].name), "%s", pads[i].node[0]);
+    }
+    return opt.nodeCount;
+}
+
+/* uhid devices get their hidraw nodes once hid-generic has bound them */
+static int findPads(HIDRAW_PAD *pads)
+{
+    uint64_t until = nowUs() + (opt.uhidPads ? UHID_WAIT_MS * 1000u : 0);
+    int n;
+
+    for (;;) {
+        int complete = 0;
+
+        n = Hidraw_FindPads(device_dsc.idVendor, device_dsc.idProduct, pads, MAX_PADS);
+        for (int i = 0; i < n; i++) {
+            if (pads[i].node[0][0] && pads[i].node[1][0]) complete++;
+        }
+        if (complete >= opt.uhidPads || nowUs() >= until) break;
+        usleep(10000);
+    }
+    return n;
+}
+
+static void writeStatus(FILE *fp, uint64_t elapsedUs)
+{
+    for (int i = 0; i < monCount; i++) {
+        const MONITOR *m = &mon[i];
+
+        fprintf(fp, "%8.1fs %s: %llu reports, %llu missed frames, %llu changes",
+                elapsedUs / 1e6, m->pad.name, (unsigned long long)m->reports,
+                (unsigned long long)m->missedFrames, (unsigned long long)m->changes);
+        if (m->extReports) {
+            fprintf(fp, ", %llu samples skipped", (unsigned long long)m->seqSkipped);
+        }
+        fputc('\n', fp);
+    }
+}
+
+static void writeJson(FILE *fp, uint64_t runUs)
+{
+    fprintf(fp, "{\n  \"tool\": \"padmon\",\n");
+    fprintf(fp, "  \"run_time_us\": %llu,\n", (unsigned long long)runUs);
+    fprintf(fp, "  \"pads\": [");
+    for (int i = 0; i < monCount; i++) {
+        const MONITOR *m = &mon[i];
+
+        fprintf(fp, "%s\n    {\n", i ? "," : "");
+        fprintf(fp, "      \"name\": \"%s\",\n", m->pad.name);
+        fprintf(fp, "      \"nodes\": [\"%s\", \"%s\"],\n", m->pad.node[0], m->pad.node[1]);
+        fprintf(fp, "      \"frame_us\": %u,\n", m->frameUs);
+        fprintf(fp, "      \"reports\": %llu,\n", (unsigned long long)m->reports);
+        fprintf(fp, "      \"bad_length\": %llu,\n", (unsigned long long)m->shortReads);
+        fprintf(fp, "      \"interval_us\": { ");
+        Sample_WriteJson(fp, &m->interval);
+        fprintf(fp, " },\n      \"interval_frames\": [");
+        for (int f = 0; f <= HIST_FRAMES; f++) {
+            fprintf(fp, "%s%llu", f ? ", " : "", (unsigned long long)m->hist[f]);
+        }
+        fprintf(fp, "],\n");
+        fprintf(fp, "      \"missed_frames\": %llu,\n", (unsigned long long)m->missedFrames);
+        fprintf(fp, "      \"changes\": %llu", (unsigned long long)m->changes);
+        if (m->extReports) {
+            fprintf(fp, ",\n      \"ext\": {\n");
+            fprintf(fp, "        \"reports\": %llu,\n", (unsigned long long)m->extReports);
+            fprintf(fp, "        \"seq_gaps\": %llu,\n", (unsigned long long)m->seqGaps);
+            fprintf(fp, "        \"seq_skipped\": %llu,\n", (unsigned long long)m->seqSkipped);
+            fprintf(fp, "        \"seq_repeats\": %llu,\n", (unsigned long long)m->seqRepeats);
+            fprintf(fp, "        \"device_interval_us\": { ");
+            Sample_WriteJson(fp, &m->deviceInterval);
+            fprintf(fp, " },\n        \"transport_jitter_us\": { ");
+            Sample_WriteJson(fp, &m->transportJitter);
+            fprintf(fp, " }\n      }");
+        }
+        fprintf(fp, "\n    }");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+int main(int argc, char **argv)
+{
+    HIDRAW_PAD pads[MAX_PADS];
+    struct sigaction sa;
+    uint64_t start, nextStatus;
+    FILE *out = stdout;
+    int n;
+
+    parseArgs(argc, argv, &opt);
+    if (opt.uhidPads && !UhidPad_Start(opt.uhidPads, opt.intervalUs ? opt.intervalUs : DEFAULT_INTERVAL_US,
+                                       opt.uhidDropPermille)) {
+        return 1;
+    }
+    n = opt.nodeCount ? padsFromArgs(pads) : findPads(pads);
+    if (n == 0) {
+        fprintf(stderr, "padmon: no pads found (%04x:%04x)\n", device_dsc.idVendor, device_dsc.idProduct);
+        if (opt.uhidPads) UhidPad_Stop();
+        return 1;
+    }
+
+    if (opt.eventsPath) {
+        events = fopen(opt.eventsPath, "w");
+        if (events == NULL) {
+            perror(opt.eventsPath);
+            return 1;
+        }
+        fprintf(events, "pad,host_us,device_us,seq,changes\n");
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    for (monCount = 0; monCount < n; monCount++) {
+        MONITOR *m = &mon[monCount];
+
+        m->pad = pads[monCount];
+        if (!openPad(m)) return 1;
+    }
+    start = nowUs();
+    nextStatus = start + (uint64_t)opt.statusUs;
+    for (int i = 0; i < monCount; i++) {
+        if (pthread_create(&mon[i].tid, NULL, padThread, &mon[i]) != 0) return 1;
+    }
+
+    while (!stop) {
+        uint64_t now = nowUs();
+
+        if (opt.runUs > 0 && now - start >= opt.runUs) break;
+        if (opt.statusUs > 0 && now >= nextStatus) {
+            writeStatus(stderr, now - start);
+            nextStatus += (uint64_t)opt.statusUs;
+        }
+        usleep(POLL_MS * 1000);
+    }
+    stop = 1;
+    for (int i = 0; i < monCount; i++) {
+        pthread_join(mon[i].tid, NULL);
+    }
+    if (opt.uhidPads) UhidPad_Stop();
+    if (events) fclose(events);
+
+    if (opt.jsonPath) {
+        out = fopen(opt.jsonPath, "w");
+        if (out == NULL) {
+            perror(opt.jsonPath);
+            return 1;
+        }
+    }
+    writeJson(out, nowUs() - start);
+    if (out != stdout) fclose(out);
+
+    for (int i = 0; i < monCount; i++) {
+        close(mon[i].fd[0]);
+        if (mon[i].fd[1] >= 0) close(mon[i].fd[1]);
+        Sample_Free(&mon[i].interval);
+        Sample_Free(&mon[i].deviceInterval);
+        Sample_Free(&mon[i].transportJitter);
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <linux/uhid.h>
+#include <linux/input.h>
+
+#include "usb.h"
+#include "usb_config.h"
+#include "app_device_joystick.h"
+#include "ext_report.h"
+
+#include "uhidpad.h"
+
+extern const USB_DEVICE_DESCRIPTOR device_dsc;
+extern const struct{uint8_t report[HID_RPT01_SIZE];}hid_rpt01;
+extern const struct{uint8_t report[HID_MAP_RPT_DESC_SIZE];}hid_map_rpt;
+
+typedef struct
+{
+    int      fd[2];             // interface 0 and 1
+    uint8_t  seq;
+    uint32_t frame;
+} UHID_PAD;
+
+static UHID_PAD *pads;
+static int padCount;
+static unsigned period;
+static unsigned drop;
+static pthread_t tid;
+static volatile bool running;
+
+static bool send(int fd, const struct uhid_event *ev)
+{
+    if (write(fd, ev, sizeof(*ev)) != (ssize_t)sizeof(*ev)) {
+        perror("uhid");
+        return false;
+    }
+    return true;
+}
+
+static int create(int pad, int intf, const void *desc, uint16_t size)
+{
+    struct uhid_event ev;
+    int fd = open("/dev/uhid", O_RDWR | O_CLOEXEC | O_NONBLOCK);
+
+    if (fd < 0) {
+        perror("/dev/uhid");
+        return -1;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.type = UHID_CREATE2;
+    snprintf((char *)ev.u.create2.name, sizeof(ev.u.create2.name), "padmon uhid pad %d", pad);
+    snprintf((char *)ev.u.create2.phys, sizeof(ev.u.create2.phys), "padmon-uhid-%d/input%d", pad, intf);
+    memcpy(ev.u.create2.rd_data, desc, size);
+    ev.u.create2.rd_size = size;
+    ev.u.create2.bus = BUS_USB;
+    ev.u.create2.vendor = device_dsc.idVendor;
+    ev.u.create2.product = device_dsc.idProduct;
+    ev.u.create2.version = device_dsc.bcdDevice;
+    if (!send(fd, &ev)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* the stand-in has no feature reports; refuse requests rather than let them time out */
+static void drain(int fd)
+{
+    struct uhid_event ev, reply;
+
+    while (read(fd, &ev, sizeof(ev)) > 0) {
+        memset(&reply, 0, sizeof(reply));
+        if (ev.type == UHID_GET_REPORT) {
+            reply.type = UHID_GET_REPORT_REPLY;
+            reply.u.get_report_reply.id = ev.u.get_report.id;
+            reply.u.get_report_reply.err = EIO;
+        } else if (ev.type == UHID_SET_REPORT) {
+            reply.type = UHID_SET_REPORT_REPLY;
+            reply.u.set_report_reply.id = ev.u.set_report.id;
+            reply.u.set_report_reply.err = EIO;
+        } else {
+            continue;
+        }
+        send(fd, &reply);
+    }
+}
+
+static void sendFrame(UHID_PAD *p, uint16_t sampleUs)
+{
+    struct uhid_event ev;
+    INPUT_CONTROLS in;
+    unsigned button = (p->frame / 64) % 14;
+
+    // a button held for 64 frames, then the next one; the hat turns every 512
+    memset(&in, 0, sizeof(in));
+    in.val[button / 8] = (uint8_t)(1u << (button % 8));
+    in.members.hat_switch.hat_switch = (p->frame / 512) % 9;
+    in.members.analog_stick.X = 0x80;
+    in.members.analog_stick.Y = 0x80;
+    in.members.analog_stick.Z = 0x80;
+    in.members.analog_stick.Rz = 0x80;
+    p->frame++;
+    p->seq++;
+    if ((unsigned)(rand() % 1000) < drop) return;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = UHID_INPUT2;
+    memcpy(ev.u.input2.data, in.val, sizeof(in.val));
+    ev.u.input2.size = sizeof(in.val);
+    send(p->fd[0], &ev);
+
+    ev.u.input2.data[0] = EXT_REPORT_ID;
+    ev.u.input2.data[1] = p->seq;
+    ev.u.input2.data[2] = (uint8_t)sampleUs;
+    ev.u.input2.data[3] = (uint8_t)(sampleUs >> 8);
+    memcpy(&ev.u.input2.data[4], in.val, sizeof(in.val));
+    ev.u.input2.size = EXT_REPORT_SIZE;
+    send(p->fd[1], &ev);
+}
+
+static void *padThread(void *arg)
+{
+    struct timespec next;
+    uint64_t us = 0;
+
+    (void)arg;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (running) {
+        for (int i = 0; i < padCount; i++) {
+            drain(pads[i].fd[0]);
+            drain(pads[i].fd[1]);
+            sendFrame(&pads[i], (uint16_t)us);
+        }
+        us += period;
+        next.tv_nsec += (long)period * 1000;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+bool UhidPad_Start(int count, unsigned periodUs, unsigned dropPermille)
+{
+    pads = calloc((size_t)count, sizeof(*pads));
+    if (pads == NULL) return false;
+    period = periodUs;
+    drop = dropPermille;
+    for (padCount = 0; padCount < count; padCount++) {
+        UHID_PAD *p = &pads[padCount];
+
+        p->fd[0] = create(padCount, 0, &hid_rpt01, HID_RPT01_SIZE);
+        p->fd[1] = p->fd[0] < 0 ? -1 : create(padCount, 1, &hid_map_rpt, HID_MAP_RPT_DESC_SIZE);
+        if (p->fd[1] < 0) {
+            if (p->fd[0] >= 0) close(p->fd[0]);
+            UhidPad_Stop();
+            return false;
+        }
+    }
+    running = true;
+    if (pthread_create(&tid, NULL, padThread, NULL) != 0) {
+        running = false;
+        UhidPad_Stop();
+        return false;
+    }
+    return true;
+}
+
+void UhidPad_Stop(void)
+{
+    if (running) {
+        running = false;
+        pthread_join(tid, NULL);
+    }
+    // closing the fd destroys the device
+    for (int i = 0; i < padCount; i++) {
+        close(pads[i].fd[0]);
+        close(pads[i].fd[1]);
+    }
+    free(pads);
+    pads = NULL;
+    padCount = 0;
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   uhidpad.h
+ * Stand-in pads on /dev/uhid for padmon runs without hardware. Each pad
+ * is two uhid devices with the firmware's own report descriptors
+ * (hid_rpt01 and hid_map_rpt) and VID:PID, named like usbhid names the
+ * interfaces of a real one, so Hidraw_FindPads() picks them up as pads.
+ *
+ * Every period a pad sends the gamepad report and the extended report
+ * (report 4) with a walking button. A dropped frame sends neither but
+ * still advances the sequence number, as a sample the host never took.
+ */
+
+#ifndef UHIDPAD_H
+#define UHIDPAD_H
+
+#include <stdbool.h>
+
+/**
+ * Create count pads and start sending.
+ * @param periodUs  time between reports
+ * @param dropPermille  frames per thousand left out at random
+ */
+bool UhidPad_Start(int count, unsigned periodUs, unsigned dropPermille);
+
+void UhidPad_Stop(void);
+
+#endif /* UHIDPAD_H */
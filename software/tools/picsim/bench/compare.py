@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compare two picsim bench-results directories.
+
+Every *.json present in both directories is compared function by function
+(mean, p99 and max cycles) and for the main-loop iteration; USB runs also
+compare attach-to-configured cycles and iterations and the control
+transfer cycles, and replay runs their input latency in frames and us.
+Exits with 1 when any figure grew by more than the tolerance.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+FIELDS = ("mean", "p99", "max", "cycles", "iterations")
+
+
+def entries(result):
+    out = {}
+    loop = result.get("main_loop")
+    if loop and loop.get("count"):
+        out["main_loop(%s)" % loop["anchor"]] = loop
+    for fn in result.get("functions", []):
+        if fn.get("count"):
+            out[fn["name"]] = fn
+    usb = result.get("usb")
+    if usb:
+        if usb.get("configured"):
+            out["usb attach->configured"] = usb["configured"]
+        if usb.get("control_cycles", {}).get("count"):
+            out["usb control transfer"] = usb["control_cycles"]
+    for key in ("latency_frames", "latency_us"):
+        if result.get(key, {}).get("count"):
+            out[key] = result[key]
+    if "longest_gap_frames" in result:
+        out["longest_gap_frames"] = {"max": result["longest_gap_frames"]}
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--tolerance", type=float, default=2.0, help="percent")
+    args = ap.parse_args()
+
+    worse = False
+    for name in sorted(os.listdir(args.current)):
+        base_path = os.path.join(args.baseline, name)
+        if not name.endswith(".json") or not os.path.exists(base_path):
+            continue
+        with open(base_path) as f:
+            base = entries(json.load(f))
+        with open(os.path.join(args.current, name)) as f:
+            cur = entries(json.load(f))
+        for key in sorted(set(base) & set(cur)):
+            for field in FIELDS:
+                if field not in base[key] or field not in cur[key]:
+                    continue
+                b, c = base[key][field], cur[key][field]
+                delta = (c - b) * 100.0 / b if b else 0.0
+                flag = ""
+                if delta > args.tolerance:
+                    flag = "  <-- regression"
+                    worse = True
+                print("%-10s %-32s %-5s %10.1f -> %10.1f  %+6.1f%%%s"
+                      % (name, key, field, b, c, delta, flag))
+    return 1 if worse else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Check where a build put the data the report path reads every frame.
+
+Reads the XC8 .sym file and fails (exit 1) when a symbol of HOT has left
+its place (project_SS_gamepad.X/ram_map.h): common RAM for the __near
+ones, bank 1 next to joystick_input for the others. Addresses may be
+given banked (bank << 7 | offset) or linear (0x2000 + 80 x bank).
+"""
+
+import argparse
+import sys
+
+COMMON = "common"
+HOT = {
+    "flags": COMMON,
+    "lastTransmission": COMMON,
+    "joystick_input": 1,
+    "mappingMask": 1,
+}
+
+
+def place(addr):
+    """common, a bank number, or None for SFRs and unknown addresses"""
+    if addr >= 0x2000:
+        off = addr - 0x2000
+        return off // 80 if off < 32 * 80 else None
+    low = addr & 0x7F
+    if low >= 0x70:
+        return COMMON
+    if 0x20 <= low < 0x70:
+        return addr >> 7
+    return None
+
+
+def load(path):
+    syms = {}
+    with open(path) as f:
+        for line in f:
+            cols = line.split()
+            if len(cols) < 2 or "CODE" in cols[2:]:
+                continue
+            try:
+                addr = int(cols[1], 16)
+            except ValueError:
+                continue
+            syms[cols[0][1:] if cols[0].startswith("_") else cols[0]] = addr
+    return syms
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("sym")
+    args = ap.parse_args()
+
+    syms = load(args.sym)
+    bad = False
+    for name, want in HOT.items():
+        if name not in syms:
+            print("%-18s missing from %s" % (name, args.sym))
+            bad = True
+            continue
+        got = place(syms[name])
+        ok = got == want
+        print("%-18s 0x%04X  %-8s %s" % (name, syms[name],
+              got if got == COMMON else "bank %s" % got, "ok" if ok else "WANT %s" % (
+                  want if want == COMMON else "bank %d" % want)))
+        bad |= not ok
+    return 1 if bad else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
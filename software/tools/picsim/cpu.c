@@ -0,0 +1,669 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cpu.h"
+
+#define W(cpu)          ((cpu)->core[R_WREG])
+#define STATUS(cpu)     ((cpu)->core[R_STATUS])
+#define BSR(cpu)        ((cpu)->core[R_BSR])
+#define PCLATH(cpu)     ((cpu)->core[R_PCLATH])
+#define INTCON(cpu)     ((cpu)->core[R_INTCON])
+
+/* per-instruction side information */
+static unsigned extraCycles;
+static bool pcWritten;
+
+void Cpu_Halt(PICSIM_CPU *cpu, const char *reason)
+{
+    if (!cpu->halted) {
+        cpu->halted = true;
+        snprintf(cpu->haltReason, sizeof(cpu->haltReason), "%s at pc=0x%04X", reason, cpu->pc);
+    }
+}
+
+void Cpu_Reset(PICSIM_CPU *cpu)
+{
+    memset(cpu->ram, 0, sizeof(cpu->ram));
+    memset(cpu->core, 0, sizeof(cpu->core));
+    memset(cpu->stack, 0, sizeof(cpu->stack));
+    STATUS(cpu) = STATUS_nTO | STATUS_nPD;
+    cpu->pc = cpu->resetVector;
+    cpu->sp = 0;
+    cpu->spMax = 0;
+    cpu->sleeping = false;
+    cpu->halted = false;
+    cpu->haltReason[0] = '\0';
+}
+
+/*** stack ********************************************************************/
+
+static void push(PICSIM_CPU *cpu, uint16_t addr)
+{
+    if (cpu->sp >= STACK_LEVELS) {
+        // STVREN=1 would reset the part; stop so the report shows it
+        Cpu_Halt(cpu, "hardware stack overflow");
+        return;
+    }
+    cpu->stack[cpu->sp++] = addr & 0x7FFF;
+    if (cpu->sp > cpu->spMax) cpu->spMax = cpu->sp;
+}
+
+static uint16_t pop(PICSIM_CPU *cpu)
+{
+    if (cpu->sp == 0) {
+        Cpu_Halt(cpu, "hardware stack underflow");
+        return cpu->pc;
+    }
+    return cpu->stack[--cpu->sp];
+}
+
+/*** data memory **************************************************************/
+
+static uint16_t fsr(PICSIM_CPU *cpu, int n)
+{
+    return (uint16_t)(cpu->core[R_FSR0L + 2 * n] | cpu->core[R_FSR0H + 2 * n] << 8);
+}
+
+static void setFsr(PICSIM_CPU *cpu, int n, uint16_t v)
+{
+    cpu->core[R_FSR0L + 2 * n] = (uint8_t)v;
+    cpu->core[R_FSR0H + 2 * n] = (uint8_t)(v >> 8);
+}
+
+static uint8_t readCore(PICSIM_CPU *cpu, uint8_t off)
+{
+    switch (off) {
+        case R_INDF0:   return Cpu_ReadLinear(cpu, fsr(cpu, 0));
+        case R_INDF1:   return Cpu_ReadLinear(cpu, fsr(cpu, 1));
+        case R_PCL:     return (uint8_t)cpu->pc;
+        default:        return cpu->core[off];
+    }
+}
+
+static void writeCore(PICSIM_CPU *cpu, uint8_t off, uint8_t v)
+{
+    switch (off) {
+        case R_INDF0:   Cpu_WriteLinear(cpu, fsr(cpu, 0), v); break;
+        case R_INDF1:   Cpu_WriteLinear(cpu, fsr(cpu, 1), v); break;
+        case R_PCL:
+            cpu->pc = (uint16_t)(PCLATH(cpu) << 8 | v);
+            pcWritten = true;
+            break;
+        case R_STATUS:
+            STATUS(cpu) = (uint8_t)((STATUS(cpu) & (STATUS_nTO | STATUS_nPD)) | (v & 0x07));
+            break;
+        case R_BSR:     BSR(cpu) = v & 0x1F; break;
+        case R_PCLATH:  PCLATH(cpu) = v & 0x7F; break;
+        case R_INTCON:  INTCON(cpu) = (uint8_t)((INTCON(cpu) & INTCON_IOCIF) | (v & ~INTCON_IOCIF)); break;
+        default:        cpu->core[off] = v; break;
+    }
+}
+
+uint8_t Cpu_ReadData(PICSIM_CPU *cpu, uint16_t addr)
+{
+    uint8_t off;
+
+    addr &= 0x0FFF;
+    off = addr & 0x7F;
+    if (off < CORE_REGS) return readCore(cpu, off);
+    if (off >= 0x70) return cpu->ram[off];          // common RAM
+    if (off < 0x20) {
+        return cpu->bus.read ? cpu->bus.read(cpu->bus.ctx, addr) : cpu->ram[addr];
+    }
+    switch (addr) {
+        case R_STKPTR:  return (uint8_t)((cpu->sp - 1) & 0x1F);
+        case R_TOSL:    return cpu->sp ? (uint8_t)cpu->stack[cpu->sp - 1] : 0;
+        case R_TOSH:    return cpu->sp ? (uint8_t)(cpu->stack[cpu->sp - 1] >> 8) : 0;
+        default:        return cpu->ram[addr];
+    }
+}
+
+void Cpu_WriteData(PICSIM_CPU *cpu, uint16_t addr, uint8_t value)
+{
+    uint8_t off;
+
+    addr &= 0x0FFF;
+    off = addr & 0x7F;
+    if (off < CORE_REGS) {
+        writeCore(cpu, off, value);
+    } else if (off >= 0x70) {
+        cpu->ram[off] = value;
+    } else if (off < 0x20) {
+        if (cpu->bus.write) {
+            cpu->bus.write(cpu->bus.ctx, addr, value);
+        } else {
+            cpu->ram[addr] = value;
+        }
+    } else if (addr == R_STKPTR) {
+        cpu->sp = (uint8_t)(((value & 0x1F) + 1) & 0x1F);
+        if (cpu->sp > STACK_LEVELS) cpu->sp = 0;
+    } else if (addr == R_TOSL && cpu->sp) {
+        cpu->stack[cpu->sp - 1] = (uint16_t)((cpu->stack[cpu->sp - 1] & 0x7F00) | value);
+    } else if (addr == R_TOSH && cpu->sp) {
+        cpu->stack[cpu->sp - 1] = (uint16_t)((cpu->stack[cpu->sp - 1] & 0x00FF) | (value & 0x7F) << 8);
+    } else {
+        cpu->ram[addr] = value;
+    }
+}
+
+static uint16_t linearToData(uint16_t fsrAddr)
+{
+    uint16_t l = (uint16_t)(fsrAddr - LINEAR_BASE);
+    return (uint16_t)((l / 80) * 128 + 0x20 + l % 80);
+}
+
+uint8_t Cpu_ReadLinear(PICSIM_CPU *cpu, uint16_t a)
+{
+    if (a < DATA_SPACE) {
+        if ((a & 0x7F) <= R_INDF1) return 0;        // INDF through FSR reads 0
+        return Cpu_ReadData(cpu, a);
+    }
+    if (a >= LINEAR_BASE && a < LINEAR_BASE + LINEAR_SIZE) {
+        return cpu->ram[linearToData(a)];
+    }
+    if (a >= FLASH_FSR_BASE) {
+        extraCycles++;                              // program memory read via FSR
+        return (uint8_t)cpu->flash[(a - FLASH_FSR_BASE) & (CPU_FLASH_WORDS - 1)];
+    }
+    return 0;
+}
+
+void Cpu_WriteLinear(PICSIM_CPU *cpu, uint16_t a, uint8_t value)
+{
+    if (a < DATA_SPACE) {
+        if ((a & 0x7F) <= R_INDF1) return;
+        Cpu_WriteData(cpu, a, value);
+    } else if (a >= LINEAR_BASE && a < LINEAR_BASE + LINEAR_SIZE) {
+        cpu->ram[linearToData(a)] = value;
+    }
+    // program memory is read-only through FSR
+}
+
+/* direct (7-bit) file register access through BSR */
+static uint8_t readF(PICSIM_CPU *cpu, uint8_t f)
+{
+    if (f < CORE_REGS) return readCore(cpu, f);
+    return Cpu_ReadData(cpu, (uint16_t)(BSR(cpu) << 7 | f));
+}
+
+static void writeF(PICSIM_CPU *cpu, uint8_t f, uint8_t v)
+{
+    if (f < CORE_REGS) {
+        writeCore(cpu, f, v);
+    } else {
+        Cpu_WriteData(cpu, (uint16_t)(BSR(cpu) << 7 | f), v);
+    }
+}
+
+/*** flags ********************************************************************/
+
+static void setFlag(PICSIM_CPU *cpu, uint8_t mask, bool on)
+{
+    if (on) {
+        STATUS(cpu) |= mask;
+    } else {
+        STATUS(cpu) &= (uint8_t)~mask;
+    }
+}
+
+static void setZ(PICSIM_CPU *cpu, uint8_t r)
+{
+    setFlag(cpu, STATUS_Z, r == 0);
+}
+
+/* a + b + cin with C, DC and Z */
+static uint8_t addc(PICSIM_CPU *cpu, uint8_t a, uint8_t b, unsigned cin)
+{
+    unsigned r = (unsigned)a + b + cin;
+    setFlag(cpu, STATUS_C, r > 0xFF);
+    setFlag(cpu, STATUS_DC, ((a & 0x0F) + (b & 0x0F) + cin) > 0x0F);
+    setZ(cpu, (uint8_t)r);
+    return (uint8_t)r;
+}
+
+/*** interrupts ***************************************************************/
+
+static bool wakeSource(PICSIM_CPU *cpu)
+{
+    uint8_t i = INTCON(cpu);
+
+    if ((i & INTCON_TMR0IE) && (i & INTCON_TMR0IF)) return true;
+    if ((i & INTCON_INTE) && (i & INTCON_INTF)) return true;
+    if ((i & INTCON_IOCIE) && (i & INTCON_IOCIF)) return true;
+    if (i & INTCON_PEIE) {
+        if (cpu->ram[R_PIR1] & cpu->ram[R_PIE1]) return true;
+        if (cpu->ram[R_PIR2] & cpu->ram[R_PIE2]) return true;
+    }
+    return false;
+}
+
+static unsigned takeInterrupt(PICSIM_CPU *cpu)
+{
+    uint16_t from = cpu->pc;
+
+    push(cpu, cpu->pc);
+    cpu->ram[R_STATUS_SHAD] = STATUS(cpu) & 0x07;
+    cpu->ram[R_WREG_SHAD] = W(cpu);
+    cpu->ram[R_BSR_SHAD] = BSR(cpu);
+    cpu->ram[R_PCLATH_SHAD] = PCLATH(cpu);
+    cpu->ram[R_FSR0L_SHAD] = cpu->core[R_FSR0L];
+    cpu->ram[R_FSR0H_SHAD] = cpu->core[R_FSR0H];
+    cpu->ram[R_FSR1L_SHAD] = cpu->core[R_FSR1L];
+    cpu->ram[R_FSR1H_SHAD] = cpu->core[R_FSR1H];
+    INTCON(cpu) &= (uint8_t)~INTCON_GIE;
+    cpu->pc = cpu->intVector;
+    if (cpu->hooks.interrupt) cpu->hooks.interrupt(cpu->hooks.ctx, from);
+    return 3u + cpu->intExtraCycles;
+}
+
+/*** execution ****************************************************************/
+
+void Cpu_Call(PICSIM_CPU *cpu, uint16_t target)
+{
+    push(cpu, CPU_SENTINEL_PC);
+    if (cpu->hooks.call) cpu->hooks.call(cpu->hooks.ctx, target, CPU_SENTINEL_PC);
+    cpu->pc = target;
+}
+
+static void doCall(PICSIM_CPU *cpu, uint16_t target)
+{
+    uint16_t from = (uint16_t)(cpu->pc - 1);
+    push(cpu, cpu->pc);
+    cpu->pc = target & 0x7FFF;
+    cpu->calls++;
+    if ((from ^ cpu->pc) & 0x7800) cpu->farCalls++;
+    if (cpu->hooks.call) cpu->hooks.call(cpu->hooks.ctx, cpu->pc, from);
+}
+
+static void doReturn(PICSIM_CPU *cpu)
+{
+    cpu->pc = pop(cpu);
+    if (cpu->hooks.ret) cpu->hooks.ret(cpu->hooks.ctx, cpu->pc);
+}
+
+/* MOVIW/MOVWI with pre/post increment/decrement (mm field) */
+static void indexedMove(PICSIM_CPU *cpu, int n, unsigned mm, bool toW)
+{
+    uint16_t a = fsr(cpu, n);
+
+    if (mm == 0) a++;
+    if (mm == 1) a--;
+    setFsr(cpu, n, a);
+    if (toW) {
+        W(cpu) = Cpu_ReadLinear(cpu, a);
+        setZ(cpu, W(cpu));
+    } else {
+        Cpu_WriteLinear(cpu, a, W(cpu));
+    }
+    if (mm == 2) setFsr(cpu, n, (uint16_t)(a + 1));
+    if (mm == 3) setFsr(cpu, n, (uint16_t)(a - 1));
+}
+
+static int8_t sext6(uint16_t k)
+{
+    return (int8_t)((k & 0x20) ? (k & 0x3F) - 0x40 : (k & 0x3F));
+}
+
+static unsigned execMisc(PICSIM_CPU *cpu, uint16_t op)
+{
+    if (op == 0x0000) return 1;                                     // NOP
+    if (op == 0x0001) {                                             // RESET
+        Cpu_Reset(cpu);
+        return 1;
+    }
+    if (op == 0x0008) { doReturn(cpu); return 2; }                  // RETURN
+    if (op == 0x0009) {                                             // RETFIE
+        doReturn(cpu);
+        STATUS(cpu) = (uint8_t)((STATUS(cpu) & 0x18) | (cpu->ram[R_STATUS_SHAD] & 0x07));
+        W(cpu) = cpu->ram[R_WREG_SHAD];
+        BSR(cpu) = cpu->ram[R_BSR_SHAD] & 0x1F;
+        PCLATH(cpu) = cpu->ram[R_PCLATH_SHAD] & 0x7F;
+        cpu->core[R_FSR0L] = cpu->ram[R_FSR0L_SHAD];
+        cpu->core[R_FSR0H] = cpu->ram[R_FSR0H_SHAD];
+        cpu->core[R_FSR1L] = cpu->ram[R_FSR1L_SHAD];
+        cpu->core[R_FSR1H] = cpu->ram[R_FSR1H_SHAD];
+        INTCON(cpu) |= INTCON_GIE;
+        return 2;
+    }
+    if (op == 0x000A) {                                             // CALLW
+        doCall(cpu, (uint16_t)(PCLATH(cpu) << 8 | W(cpu)));
+        return 2;
+    }
+    if (op == 0x000B) {                                             // BRW
+        cpu->pc = (uint16_t)((cpu->pc + W(cpu)) & 0x7FFF);
+        return 2;
+    }
+    if (op >= 0x0010 && op <= 0x001F) {                             // MOVIW/MOVWI
+        indexedMove(cpu, (op >> 2) & 1, op & 3, op < 0x0018);
+        return 1;
+    }
+    if (op >= 0x0020 && op <= 0x003F) {                             // MOVLB
+        BSR(cpu) = op & 0x1F;
+        cpu->movlbs++;
+        return 1;
+    }
+    if (op == 0x0062) {                                             // OPTION
+        Cpu_WriteData(cpu, R_OPTION, W(cpu));
+        return 1;
+    }
+    if (op == 0x0063) {                                             // SLEEP
+        STATUS(cpu) = (uint8_t)((STATUS(cpu) & ~STATUS_nPD) | STATUS_nTO);
+        if (!wakeSource(cpu)) cpu->sleeping = true;
+        return 1;
+    }
+    if (op == 0x0064) {                                             // CLRWDT
+        STATUS(cpu) |= STATUS_nTO | STATUS_nPD;
+        return 1;
+    }
+    if (op >= 0x0065 && op <= 0x0067) {                             // TRIS
+        Cpu_WriteData(cpu, (uint16_t)(R_TRISA + (op - 0x0065)), W(cpu));
+        return 1;
+    }
+    Cpu_Halt(cpu, "illegal opcode");
+    return 1;
+}
+
+/* byte-oriented file register operations, op<11:8> selects */
+static unsigned execByte(PICSIM_CPU *cpu, uint16_t op)
+{
+    uint8_t f = op & 0x7F;
+    bool toF = (op & 0x80) != 0;
+    uint8_t v, r = 0;
+    unsigned cycles = 1;
+    bool skip = false;
+
+    switch ((op >> 8) & 0x0F) {
+        case 0x0:
+            if (toF) {                                              // MOVWF
+                writeF(cpu, f, W(cpu));
+                return pcWritten ? 2 : 1;
+            }
+            return execMisc(cpu, op);
+        case 0x1:                                                   // CLRF/CLRW
+            if (toF) {
+                writeF(cpu, f, 0);
+            } else {
+                W(cpu) = 0;
+            }
+            STATUS(cpu) |= STATUS_Z;
+            return pcWritten ? 2 : 1;
+        case 0x2:                                                   // SUBWF
+            r = addc(cpu, readF(cpu, f), (uint8_t)~W(cpu), 1);
+            break;
+        case 0x3:                                                   // DECF
+            r = (uint8_t)(readF(cpu, f) - 1);
+            setZ(cpu, r);
+            break;
+        case 0x4:                                                   // IORWF
+            r = readF(cpu, f) | W(cpu);
+            setZ(cpu, r);
+            break;
+        case 0x5:                                                   // ANDWF
+            r = readF(cpu, f) & W(cpu);
+            setZ(cpu, r);
+            break;
+        case 0x6:                                                   // XORWF
+            r = readF(cpu, f) ^ W(cpu);
+            setZ(cpu, r);
+            break;
+        case 0x7:                                                   // ADDWF
+            r = addc(cpu, readF(cpu, f), W(cpu), 0);
+            break;
+        case 0x8:                                                   // MOVF
+            r = readF(cpu, f);
+            setZ(cpu, r);
+            break;
+        case 0x9:                                                   // COMF
+            r = (uint8_t)~readF(cpu, f);
+            setZ(cpu, r);
+            break;
+        case 0xA:                                                   // INCF
+            r = (uint8_t)(readF(cpu, f) + 1);
+            setZ(cpu, r);
+            break;
+        case 0xB:                                                   // DECFSZ
+            r = (uint8_t)(readF(cpu, f) - 1);
+            skip = (r == 0);
+            break;
+        case 0xC:                                                   // RRF
+            v = readF(cpu, f);
+            r = (uint8_t)(v >> 1 | (STATUS(cpu) & STATUS_C) << 7);
+            setFlag(cpu, STATUS_C, v & 1);
+            break;
+        case 0xD:                                                   // RLF
+            v = readF(cpu, f);
+            r = (uint8_t)(v << 1 | (STATUS(cpu) & STATUS_C));
+            setFlag(cpu, STATUS_C, v & 0x80);
+            break;
+        case 0xE:                                                   // SWAPF
+            v = readF(cpu, f);
+            r = (uint8_t)(v << 4 | v >> 4);
+            break;
+        case 0xF:                                                   // INCFSZ
+            r = (uint8_t)(readF(cpu, f) + 1);
+            skip = (r == 0);
+            break;
+    }
+
+    if (toF) {
+        // flags computed above win over a STATUS destination
+        uint8_t flags = STATUS(cpu) & 0x07;
+        writeF(cpu, f, r);
+        if (f == R_STATUS) STATUS(cpu) = (uint8_t)((STATUS(cpu) & ~0x07) | flags);
+    } else {
+        W(cpu) = r;
+    }
+    if (pcWritten) cycles = 2;
+    if (skip) {
+        cpu->pc = (cpu->pc + 1) & 0x7FFF;
+        cycles = 2;
+    }
+    return cycles;
+}
+
+static unsigned execBit(PICSIM_CPU *cpu, uint16_t op)
+{
+    uint8_t f = op & 0x7F;
+    uint8_t mask = (uint8_t)(1u << ((op >> 7) & 7));
+    uint8_t v;
+
+    switch ((op >> 10) & 3) {
+        case 0:                                                     // BCF
+            writeF(cpu, f, readF(cpu, f) & (uint8_t)~mask);
+            return pcWritten ? 2 : 1;
+        case 1:                                                     // BSF
+            writeF(cpu, f, readF(cpu, f) | mask);
+            return pcWritten ? 2 : 1;
+        case 2:                                                     // BTFSC
+            v = readF(cpu, f);
+            if (!(v & mask)) {
+                cpu->pc = (cpu->pc + 1) & 0x7FFF;
+                return 2;
+            }
+            return 1;
+        default:                                                    // BTFSS
+            v = readF(cpu, f);
+            if (v & mask) {
+                cpu->pc = (cpu->pc + 1) & 0x7FFF;
+                return 2;
+            }
+            return 1;
+    }
+}
+
+static unsigned execLiteral(PICSIM_CPU *cpu, uint16_t op)
+{
+    uint8_t k = (uint8_t)op;
+    uint8_t v;
+    int n;
+
+    switch ((op >> 8) & 0x3F) {
+        case 0x30:                                                  // MOVLW
+            W(cpu) = k;
+            return 1;
+        case 0x31:
+            if (op & 0x80) {                                        // MOVLP
+                PCLATH(cpu) = k & 0x7F;
+                cpu->movlps++;
+            } else {                                                // ADDFSR
+                n = (op >> 6) & 1;
+                setFsr(cpu, n, (uint16_t)(fsr(cpu, n) + sext6(op)));
+            }
+            return 1;
+        case 0x32:
+        case 0x33: {                                                // BRA
+            int16_t rel = (int16_t)((op & 0x100) ? (int)(op & 0x1FF) - 0x200 : (int)(op & 0x1FF));
+            cpu->pc = (uint16_t)((cpu->pc + rel) & 0x7FFF);
+            return 2;
+        }
+        case 0x34:                                                  // RETLW
+            W(cpu) = k;
+            doReturn(cpu);
+            return 2;
+        case 0x35:                                                  // LSLF
+        case 0x36:                                                  // LSRF
+        case 0x37: {                                                // ASRF
+            uint8_t f = op & 0x7F, r;
+            v = readF(cpu, f);
+            if (((op >> 8) & 0x3F) == 0x35) {
+                r = (uint8_t)(v << 1);
+                setFlag(cpu, STATUS_C, v & 0x80);
+            } else if (((op >> 8) & 0x3F) == 0x36) {
+                r = v >> 1;
+                setFlag(cpu, STATUS_C, v & 1);
+            } else {
+                r = (uint8_t)((v >> 1) | (v & 0x80));
+                setFlag(cpu, STATUS_C, v & 1);
+            }
+            setZ(cpu, r);
+            if (op & 0x80) {
+                uint8_t flags = STATUS(cpu) & 0x07;
+                writeF(cpu, f, r);
+                if (f == R_STATUS) STATUS(cpu) = (uint8_t)((STATUS(cpu) & ~0x07) | flags);
+            } else {
+                W(cpu) = r;
+            }
+            return pcWritten ? 2 : 1;
+        }
+        case 0x38:                                                  // IORLW
+            W(cpu) |= k;
+            setZ(cpu, W(cpu));
+            return 1;
+        case 0x39:                                                  // ANDLW
+            W(cpu) &= k;
+            setZ(cpu, W(cpu));
+            return 1;
+        case 0x3A:                                                  // XORLW
+            W(cpu) ^= k;
+            setZ(cpu, W(cpu));
+            return 1;
+        case 0x3B:                                                  // SUBWFB
+        case 0x3D: {                                                // ADDWFC
+            uint8_t f = op & 0x7F, r;
+            unsigned c = STATUS(cpu) & STATUS_C;
+            v = readF(cpu, f);
+            if (((op >> 8) & 0x3F) == 0x3B) {
+                r = addc(cpu, v, (uint8_t)~W(cpu), c);
+            } else {
+                r = addc(cpu, v, W(cpu), c);
+            }
+            if (op & 0x80) {
+                uint8_t flags = STATUS(cpu) & 0x07;
+                writeF(cpu, f, r);
+                if (f == R_STATUS) STATUS(cpu) = (uint8_t)((STATUS(cpu) & ~0x07) | flags);
+            } else {
+                W(cpu) = r;
+            }
+            return pcWritten ? 2 : 1;
+        }
+        case 0x3C:                                                  // SUBLW
+            W(cpu) = addc(cpu, k, (uint8_t)~W(cpu), 1);
+            return 1;
+        case 0x3E:                                                  // ADDLW
+            W(cpu) = addc(cpu, W(cpu), k, 0);
+            return 1;
+        case 0x3F:                                                  // MOVIW/MOVWI k[FSRn]
+            n = (op >> 6) & 1;
+            if (op & 0x80) {
+                Cpu_WriteLinear(cpu, (uint16_t)(fsr(cpu, n) + sext6(op)), W(cpu));
+            } else {
+                W(cpu) = Cpu_ReadLinear(cpu, (uint16_t)(fsr(cpu, n) + sext6(op)));
+                setZ(cpu, W(cpu));
+            }
+            return 1;
+        default:
+            Cpu_Halt(cpu, "illegal opcode");
+            return 1;
+    }
+}
+
+unsigned Cpu_Step(PICSIM_CPU *cpu)
+{
+    uint16_t op;
+    unsigned cycles;
+
+    if (cpu->halted || cpu->pc == CPU_SENTINEL_PC) return 0;
+
+    if (cpu->sleeping) {
+        if (!wakeSource(cpu)) {
+            cpu->cycles++;
+            if (cpu->bus.tick) cpu->bus.tick(cpu->bus.ctx, 1);
+            return 1;
+        }
+        cpu->sleeping = false;
+    }
+
+    if ((INTCON(cpu) & INTCON_GIE) && wakeSource(cpu)) {
+        cycles = takeInterrupt(cpu);
+        cpu->cycles += cycles;
+        if (cpu->bus.tick) cpu->bus.tick(cpu->bus.ctx, cycles);
+        return cycles;
+    }
+
+    extraCycles = 0;
+    pcWritten = false;
+    op = cpu->flash[cpu->pc & (CPU_FLASH_WORDS - 1)] & 0x3FFF;
+    cpu->pc = (cpu->pc + 1) & 0x7FFF;
+
+    switch (op >> 12) {
+        case 0:
+            cycles = execByte(cpu, op);
+            break;
+        case 1:
+            cycles = execBit(cpu, op);
+            break;
+        case 2:
+            if (op & 0x0800) {                                      // GOTO
+                cpu->pc = (uint16_t)((PCLATH(cpu) & 0x78) << 8 | (op & 0x07FF));
+            } else {                                                // CALL
+                doCall(cpu, (uint16_t)((PCLATH(cpu) & 0x78) << 8 | (op & 0x07FF)));
+            }
+            cycles = 2;
+            break;
+        default:
+            cycles = execLiteral(cpu, op);
+            break;
+    }
+
+    cycles += extraCycles;
+    cpu->cycles += cycles;
+    cpu->instructions++;
+    if (cpu->bus.tick) cpu->bus.tick(cpu->bus.ctx, cycles);
+    return cycles;
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   cpu.h
+ * Enhanced mid-range (PIC16F1) instruction set core.
+ *
+ * One Cpu_Step() executes one instruction and charges the same number
+ * of instruction cycles (Tcy) as the silicon: 1 for most instructions,
+ * 2 for CALL/GOTO/BRA/BRW/CALLW/RETURN/RETLW/RETFIE, writes to PCL and
+ * taken skips, plus 1 for INDFn reads that land in program memory.
+ * Peripherals are reached through the PICSIM_BUS hooks so the core
+ * knows nothing about timers or the USB module.
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pic16f1459.h"
+
+#define CPU_FLASH_WORDS     0x2000u
+#define CPU_SENTINEL_PC     0x7FFFu     // return address used by Cpu_Call()
+
+typedef struct PICSIM_CPU PICSIM_CPU;
+
+typedef struct
+{
+    void    *ctx;
+    /* SFR window access (offset 0x0C-0x1F of any bank) */
+    uint8_t (*read)(void *ctx, uint16_t addr);
+    void    (*write)(void *ctx, uint16_t addr, uint8_t value);
+    /* called after every instruction with the cycles it took */
+    void    (*tick)(void *ctx, unsigned cycles);
+} PICSIM_BUS;
+
+typedef struct
+{
+    void    *ctx;
+    void    (*call)(void *ctx, uint16_t target, uint16_t from);
+    void    (*ret)(void *ctx, uint16_t to);
+    void    (*interrupt)(void *ctx, uint16_t from);
+} PICSIM_HOOKS;
+
+struct PICSIM_CPU
+{
+    uint16_t flash[CPU_FLASH_WORDS];
+    uint16_t config[16];            // 0x8000.. user ID, device ID, config
+    uint8_t  ram[DATA_SPACE];       // banked data memory incl. SFR windows
+    uint8_t  core[CORE_REGS];       // INDF0..INTCON, shared by all banks
+
+    uint16_t pc;
+    uint16_t stack[STACK_LEVELS];
+    uint8_t  sp;                    // levels in use
+    uint8_t  spMax;                 // high-water mark since reset
+
+    uint64_t cycles;                // instruction cycles since power-on
+    uint64_t instructions;
+    uint64_t calls;                 // CALL and CALLW
+    uint64_t farCalls;              // of those, to another 2K-word page
+    uint64_t movlps;                // page selects
+    uint64_t movlbs;                // bank selects
+
+    uint16_t resetVector;
+    uint16_t intVector;
+    uint8_t  intExtraCycles;        // cost of a vector forwarder, if any
+
+    bool     sleeping;
+    bool     halted;
+    char     haltReason[96];
+
+    PICSIM_BUS   bus;
+    PICSIM_HOOKS hooks;
+};
+
+/**
+ * Power-on reset. Flash contents are kept.
+ */
+void Cpu_Reset(PICSIM_CPU *cpu);
+
+/**
+ * Execute one instruction, or one idle cycle while asleep.
+ * Pending interrupts are taken before the fetch.
+ * @return cycles consumed
+ */
+unsigned Cpu_Step(PICSIM_CPU *cpu);
+
+/**
+ * Push CPU_SENTINEL_PC and jump to a function. The caller steps the
+ * core until pc == CPU_SENTINEL_PC to know it has returned.
+ */
+void Cpu_Call(PICSIM_CPU *cpu, uint16_t target);
+
+/**
+ * Data memory access by 12-bit traditional address, SFR hooks included.
+ */
+uint8_t Cpu_ReadData(PICSIM_CPU *cpu, uint16_t addr);
+void    Cpu_WriteData(PICSIM_CPU *cpu, uint16_t addr, uint8_t value);
+
+/**
+ * Data access through a 16-bit FSR address (linear and flash windows).
+ */
+uint8_t Cpu_ReadLinear(PICSIM_CPU *cpu, uint16_t fsr);
+void    Cpu_WriteLinear(PICSIM_CPU *cpu, uint16_t fsr, uint8_t value);
+
+/**
+ * Stop the core; Cpu_Step() becomes a no-op.
+ */
+void Cpu_Halt(PICSIM_CPU *cpu, const char *reason);
+
+#endif /* CPU_H */
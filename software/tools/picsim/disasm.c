@@ -0,0 +1,137 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+
+#include "disasm.h"
+
+static const char *const byteOps[16] = {
+    "movwf", "clrf", "subwf", "decf", "iorwf", "andwf", "xorwf", "addwf",
+    "movf", "comf", "incf", "decfsz", "rrf", "rlf", "swapf", "incfsz"
+};
+
+static const char *const bitOps[4] = { "bcf", "bsf", "btfsc", "btfss" };
+
+static const char *const idxOps[4] = { "++FSR%d", "--FSR%d", "FSR%d++", "FSR%d--" };
+
+static int sext(int v, int bits)
+{
+    int m = 1 << (bits - 1);
+    return (v & m) ? v - (m << 1) : v;
+}
+
+int Disasm_Target(uint16_t op, uint16_t pc, uint8_t pclath)
+{
+    op &= 0x3FFF;
+    if ((op & 0x3000) == 0x2000) {                  // CALL/GOTO
+        return ((pclath & 0x78) << 8) | (op & 0x07FF);
+    }
+    if ((op & 0x3E00) == 0x3200) {                  // BRA
+        return (pc + 1 + sext(op & 0x1FF, 9)) & 0x7FFF;
+    }
+    return -1;
+}
+
+static void formatMisc(uint16_t op, char *buf, size_t len)
+{
+    char tmp[16];
+
+    switch (op) {
+        case 0x0000: snprintf(buf, len, "nop"); return;
+        case 0x0001: snprintf(buf, len, "reset"); return;
+        case 0x0008: snprintf(buf, len, "return"); return;
+        case 0x0009: snprintf(buf, len, "retfie"); return;
+        case 0x000A: snprintf(buf, len, "callw"); return;
+        case 0x000B: snprintf(buf, len, "brw"); return;
+        case 0x0062: snprintf(buf, len, "option"); return;
+        case 0x0063: snprintf(buf, len, "sleep"); return;
+        case 0x0064: snprintf(buf, len, "clrwdt"); return;
+        default: break;
+    }
+    if (op >= 0x0010 && op <= 0x001F) {
+        snprintf(tmp, sizeof(tmp), idxOps[op & 3], (op >> 2) & 1);
+        snprintf(buf, len, "%s %s", op < 0x0018 ? "moviw" : "movwi", tmp);
+    } else if (op >= 0x0020 && op <= 0x003F) {
+        snprintf(buf, len, "movlb %u", op & 0x1F);
+    } else if (op >= 0x0065 && op <= 0x0067) {
+        snprintf(buf, len, "tris %u", op & 7);
+    } else {
+        snprintf(buf, len, "dw 0x%04X", op);
+    }
+}
+
+void Disasm_Format(uint16_t op, uint16_t pc, char *buf, size_t len)
+{
+    unsigned f = op & 0x7F;
+    const char *d = (op & 0x80) ? "f" : "w";
+
+    op &= 0x3FFF;
+    switch (op >> 12) {
+        case 0:
+            if ((op & 0x0F80) == 0x0000) {
+                formatMisc(op, buf, len);
+            } else if ((op & 0x0F80) == 0x0080) {
+                snprintf(buf, len, "movwf 0x%02X", f);
+            } else if ((op & 0x0F00) == 0x0100) {
+                if (op & 0x80) {
+                    snprintf(buf, len, "clrf 0x%02X", f);
+                } else {
+                    snprintf(buf, len, "clrw");
+                }
+            } else {
+                snprintf(buf, len, "%s 0x%02X,%s", byteOps[(op >> 8) & 0xF], f, d);
+            }
+            return;
+        case 1:
+            snprintf(buf, len, "%s 0x%02X,%u", bitOps[(op >> 10) & 3], f, (op >> 7) & 7);
+            return;
+        case 2:
+            snprintf(buf, len, "%s 0x%03X", (op & 0x0800) ? "goto" : "call", op & 0x07FF);
+            return;
+        default:
+            break;
+    }
+
+    switch ((op >> 8) & 0x3F) {
+        case 0x30: snprintf(buf, len, "movlw 0x%02X", op & 0xFF); return;
+        case 0x31:
+            if (op & 0x80) {
+                snprintf(buf, len, "movlp 0x%02X", op & 0x7F);
+            } else {
+                snprintf(buf, len, "addfsr FSR%u,%d", (op >> 6) & 1, sext(op & 0x3F, 6));
+            }
+            return;
+        case 0x32:
+        case 0x33:
+            snprintf(buf, len, "bra 0x%04X", Disasm_Target(op, pc, 0));
+            return;
+        case 0x34: snprintf(buf, len, "retlw 0x%02X", op & 0xFF); return;
+        case 0x35: snprintf(buf, len, "lslf 0x%02X,%s", f, d); return;
+        case 0x36: snprintf(buf, len, "lsrf 0x%02X,%s", f, d); return;
+        case 0x37: snprintf(buf, len, "asrf 0x%02X,%s", f, d); return;
+        case 0x38: snprintf(buf, len, "iorlw 0x%02X", op & 0xFF); return;
+        case 0x39: snprintf(buf, len, "andlw 0x%02X", op & 0xFF); return;
+        case 0x3A: snprintf(buf, len, "xorlw 0x%02X", op & 0xFF); return;
+        case 0x3B: snprintf(buf, len, "subwfb 0x%02X,%s", f, d); return;
+        case 0x3C: snprintf(buf, len, "sublw 0x%02X", op & 0xFF); return;
+        case 0x3D: snprintf(buf, len, "addwfc 0x%02X,%s", f, d); return;
+        case 0x3E: snprintf(buf, len, "addlw 0x%02X", op & 0xFF); return;
+        default:
+            snprintf(buf, len, "%s %d[FSR%u]", (op & 0x80) ? "movwi" : "moviw",
+                     sext(op & 0x3F, 6), (op >> 6) & 1);
+            return;
+    }
+}
@@ -0,0 +1,44 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   disasm.h
+ * One-line disassembler for enhanced mid-range opcodes, used by the
+ * trace output and by "picsim --disasm".
+ */
+
+#ifndef DISASM_H
+#define DISASM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Format one instruction.
+ * @param op  14-bit opcode
+ * @param pc  address of the instruction (for relative branches)
+ * @param buf output buffer
+ * @param len size of buf
+ */
+void Disasm_Format(uint16_t op, uint16_t pc, char *buf, size_t len);
+
+/**
+ * Static call/goto target of an instruction, assuming the PCLATH<6:3>
+ * bits in pclath. Returns -1 when the instruction has no fixed target.
+ */
+int Disasm_Target(uint16_t op, uint16_t pc, uint8_t pclath);
+
+#endif /* DISASM_H */
@@ -0,0 +1,584 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   main.c
+ * picsim: runs the production hex of project_SS_gamepad.X on an
+ * instruction-level PIC16F1459 model and reports instruction cycles
+ * per main-loop iteration and per call of selected functions as JSON.
+ *
+ * Function addresses come from the XC8 .sym file next to the hex
+ * (or --func NAME=ADDR). Without them only the totals are reported.
+ *
+ * With --usb (or --host) the USB module is backed by the SIE model and
+ * a scripted host enumerates the device; the "usb" member of the
+ * output then has attach-to-configured time, cycles and main-loop
+ * iterations, and the same for every control transfer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ihex.h"
+#include "cpu.h"
+#include "periph.h"
+#include "disasm.h"
+#include "stack.h"
+#include "symtab.h"
+#include "stimulus.h"
+#include "profile.h"
+#include "usbsie.h"
+#include "usbhost.h"
+
+#define DEFAULT_RUN_US      100000.0
+#define FORWARDER_CYCLES    3       // "movlp; goto" in a bootloader's vector
+#define CONFIGURED_STATE    0x20    // USB_DEVICE_STATE in usb_device.h
+
+static const char *const defaultFuncs[] = {
+    "USBDeviceTasks", "APP_DeviceJoystickTasks", "App_DeviceGamepadAct"
+};
+
+typedef struct
+{
+    const char *hexPath;
+    const char *symPath;
+    const char *stimPath;
+    const char *jsonPath;
+    const char *hostPath;
+    const char *reportPath;
+    const char *loopName;
+    const char *callName;
+    uint8_t     args[16];           // bytes stored to ?_<callName> before each call
+    unsigned    nargs;
+    uint16_t    dumpAddr;           // linear (FSR) address for --dump
+    unsigned    dumpLen;
+    const char *profNames[PROFILE_MAX_FUNCS];
+    unsigned    nprof;
+    const char *defs[64];
+    bool        defData[64];        // --data rather than --func
+    unsigned    ndefs;
+    double      runUs;
+    double      skipUs;
+    long        offset;             // -1 = auto
+    unsigned long trace;
+    unsigned    stackLevels;        // --stack: hardware stack to check against
+    bool        disasm;
+    bool        pages;
+    bool        usb;
+} OPTIONS;
+
+static IHEX_IMAGE image;
+static PICSIM_CPU cpu;
+static PICSIM_PERIPH per;
+static SYMTAB syms;
+static STIMULUS stim;
+static PROFILE prof;
+static USB_SIE sie;
+static USB_HOST host;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: picsim [options] firmware.hex\n"
+        "  --sym FILE        XC8 symbol file (default: <hex basename>.sym if present)\n"
+        "  --func NAME=ADDR  define a function address (hex word address)\n"
+        "  --data NAME=ADDR  define a data address (hex, as the .sym has it),\n"
+        "                    e.g. ?_App_DeviceGamepadAct for --arg\n"
+        "  --profile NAME    time calls of NAME (repeatable; default:\n"
+        "                    USBDeviceTasks APP_DeviceJoystickTasks App_DeviceGamepadAct)\n"
+        "  --loop NAME       main-loop anchor (default: USBDeviceTasks)\n"
+        "  --call NAME       once the main loop is reached, call NAME back to back\n"
+        "  --arg B0,B1,..    argument bytes for --call, stored at ?_NAME\n"
+        "  --stim FILE       pin stimulus script\n"
+        "  --usb             attach the SIE model and enumerate the device\n"
+        "  --host FILE       USB host script (implies --usb)\n"
+        "  --reports FILE    log every interrupt IN report as CSV\n"
+        "  --time T          simulated run time, e.g. 500ms (default: 100ms)\n"
+        "  --skip T          warm-up time excluded from the statistics\n"
+        "  --offset ADDR     reset address; interrupt vector is ADDR+4\n"
+        "                    (default: 0, or the lowest code word if 0 is blank)\n"
+        "  --dump ADDR:LEN   include LEN bytes at FSR address ADDR in the output\n"
+        "  --json FILE       write results here (default: stdout)\n"
+        "  --trace N         print the first N instructions to stderr\n"
+        "  --disasm          print a listing and exit\n"
+        "  --pages           print every call site that crosses a 2K-word page\n"
+        "                    (MOVLP before the CALL) and exit\n"
+        "  --stack LEVELS    worst-case call depth from the reset and interrupt\n"
+        "                    vectors; exit 1 if it needs more than LEVELS\n");
+    exit(2);
+}
+
+static double parseTimeArg(const char *opt, const char *v)
+{
+    double us;
+
+    if (v == NULL || !Stim_ParseTime(v, &us)) {
+        fprintf(stderr, "picsim: %s needs a time such as 250ms\n", opt);
+        exit(2);
+    }
+    return us;
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->runUs = DEFAULT_RUN_US;
+    o->offset = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "--disasm") == 0) {
+            o->disasm = true;
+            continue;
+        }
+        if (strcmp(a, "--pages") == 0) {
+            o->pages = true;
+            continue;
+        }
+        if (strcmp(a, "--usb") == 0) {
+            o->usb = true;
+            continue;
+        }
+        if (a[0] != '-') {
+            o->hexPath = a;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--sym") == 0) {
+            o->symPath = v;
+        } else if ((strcmp(a, "--func") == 0 || strcmp(a, "--data") == 0) && o->ndefs < 64) {
+            o->defData[o->ndefs] = strcmp(a, "--data") == 0;
+            o->defs[o->ndefs++] = v;
+        } else if (strcmp(a, "--profile") == 0 && o->nprof < PROFILE_MAX_FUNCS) {
+            o->profNames[o->nprof++] = v;
+        } else if (strcmp(a, "--loop") == 0) {
+            o->loopName = v;
+        } else if (strcmp(a, "--call") == 0) {
+            o->callName = v;
+        } else if (strcmp(a, "--arg") == 0) {
+            char *p = (char *)v;
+            while (*p && o->nargs < sizeof(o->args)) {
+                o->args[o->nargs++] = (uint8_t)strtoul(p, &p, 0);
+                if (*p == ',') p++;
+            }
+        } else if (strcmp(a, "--stim") == 0) {
+            o->stimPath = v;
+        } else if (strcmp(a, "--host") == 0) {
+            o->hostPath = v;
+            o->usb = true;
+        } else if (strcmp(a, "--reports") == 0) {
+            o->reportPath = v;
+        } else if (strcmp(a, "--time") == 0) {
+            o->runUs = parseTimeArg(a, v);
+        } else if (strcmp(a, "--skip") == 0) {
+            o->skipUs = parseTimeArg(a, v);
+        } else if (strcmp(a, "--offset") == 0) {
+            o->offset = strtol(v, NULL, 0);
+        } else if (strcmp(a, "--dump") == 0) {
+            char *p;
+            o->dumpAddr = (uint16_t)strtoul(v, &p, 0);
+            o->dumpLen = (*p == ':') ? (unsigned)strtoul(p + 1, NULL, 0) : 1;
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else if (strcmp(a, "--stack") == 0) {
+            o->stackLevels = (unsigned)strtoul(v, NULL, 0);
+            if (o->stackLevels == 0) usage();
+        } else if (strcmp(a, "--trace") == 0) {
+            o->trace = strtoul(v, NULL, 0);
+        } else {
+            usage();
+        }
+    }
+    if (o->hexPath == NULL) usage();
+    if (o->loopName == NULL) o->loopName = "USBDeviceTasks";
+}
+
+/* listing with symbol labels; MOVLP is followed to resolve CALL/GOTO */
+static void disassemble(void)
+{
+    uint8_t pclath = (uint8_t)(image.lowest >> 8);
+    char text[48];
+
+    for (unsigned a = 0; a < IHEX_PROGMEM_WORDS; a++) {
+        const SYMBOL *s;
+        uint16_t op = image.progmem[a];
+        int target;
+
+        if (!image.used[a]) continue;
+        for (unsigned i = 0; i < syms.count; i++) {
+            if (syms.syms[i].code && syms.syms[i].addr == a) printf("%s:\n", syms.syms[i].name);
+        }
+        Disasm_Format(op, (uint16_t)a, text, sizeof(text));
+        target = Disasm_Target(op, (uint16_t)a, pclath);
+        if ((op & 0x3F80) == 0x3180) pclath = op & 0x7F;
+        // XC8 re-selects the page after every call, so a function body
+        // (after a return) starts with PCLATH on its own page
+        if (op == 0x0008 || op == 0x0009 || (op & 0x3F00) == 0x3400) pclath = (uint8_t)(a >> 8);
+        printf("  %04X: %04X  %-24s", a, op, text);
+        if (target >= 0) {
+            s = Sym_At(&syms, (uint32_t)target);
+            printf("; 0x%04X", target);
+            if (s) printf(" %s%+d", s->name, target - (int)s->addr);
+        }
+        printf("\n");
+    }
+}
+
+static void printSite(const char *what, unsigned a)
+{
+    const SYMBOL *s = Sym_At(&syms, (uint32_t)a);
+
+    if (s) {
+        printf("%s%+d", s->name, (int)a - (int)s->addr);
+    } else {
+        printf("0x%04X", a);
+    }
+    printf(" (%s page %u)", what, a >> 11);
+}
+
+/* call sites by page, with PCLATH followed as in disassemble() */
+static void pageReport(void)
+{
+    uint8_t pclath = (uint8_t)(image.lowest >> 8);
+    unsigned sites = 0, far = 0;
+
+    for (unsigned a = 0; a < IHEX_PROGMEM_WORDS; a++) {
+        uint16_t op = image.progmem[a];
+        int target;
+
+        if (!image.used[a]) continue;
+        target = Disasm_Target(op, (uint16_t)a, pclath);
+        if ((op & 0x3F80) == 0x3180) pclath = op & 0x7F;
+        if (op == 0x0008 || op == 0x0009 || (op & 0x3F00) == 0x3400) pclath = (uint8_t)(a >> 8);
+        if ((op & 0x3800) != 0x2000 || target < 0) continue;       // CALL only
+
+        sites++;
+        if (((unsigned)target ^ a) & 0x7800) {
+            far++;
+            printSite("site", a);
+            printf(" -> ");
+            printSite("target", (unsigned)target);
+            printf("\n");
+        }
+    }
+    printf("%u call sites, %u to another page\n", sites, far);
+}
+
+static void printChain(const STACK_DEPTH *d)
+{
+    for (unsigned i = 0; i < d->pathLen; i++) {
+        const SYMBOL *s = Sym_At(&syms, d->path[i]);
+
+        printf("%s", i ? " -> " : "    ");
+        if (s && s->addr == d->path[i]) {
+            printf("%s", s->name);
+        } else {
+            printf("0x%04X", d->path[i]);
+        }
+    }
+    printf("\n");
+}
+
+/* the main program's deepest chain, plus the interrupt's on top of it */
+static int stackReport(uint16_t reset, unsigned levels)
+{
+    STACK_DEPTH d[2];
+    unsigned total;
+    int status = 0;
+
+    Stack_Analyze(&image, reset, &d[0]);
+    Stack_Analyze(&image, (uint16_t)(reset + 4), &d[1]);
+    total = d[0].depth + 1 + d[1].depth;
+
+    printf("main:      %u levels\n", d[0].depth);
+    printChain(&d[0]);
+    printf("interrupt: %u levels, 1 more for the vector\n", d[1].depth);
+    printChain(&d[1]);
+    for (unsigned i = 0; i < 2; i++) {
+        if (d[i].recursion >= 0) {
+            printf("recursion through 0x%04X; depth unknown\n", (unsigned)d[i].recursion);
+            status = 1;
+        }
+        if (d[i].indirect) {
+            printf("%u indirect calls or jumps not followed; the depth may be higher\n", d[i].indirect);
+        }
+    }
+    printf("worst case %u of %u levels\n", total, levels);
+    if (total > levels) {
+        printf("STACK OVERFLOW: %u levels over\n", total - levels);
+        status = 1;
+    }
+    return status;
+}
+
+static void traceStep(void)
+{
+    char text[48];
+    uint16_t op = cpu.flash[cpu.pc & (CPU_FLASH_WORDS - 1)];
+
+    Disasm_Format(op, cpu.pc, text, sizeof(text));
+    fprintf(stderr, "%10llu %04X %04X  %-24s W=%02X BSR=%02X\n",
+            (unsigned long long)cpu.cycles, cpu.pc, op, text,
+            cpu.core[R_WREG], cpu.core[R_BSR]);
+}
+
+static void applyStimulus(void)
+{
+    const STIM_EVENT *e;
+
+    while ((e = Stim_Next(&stim, per.timeUs)) != NULL) {
+        for (unsigned bit = 0; bit < 8; bit++) {
+            if (e->mask & (1u << bit)) Periph_SetPin(&per, e->port, bit, (e->level >> bit) & 1);
+        }
+    }
+}
+
+static void jsonString(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', fp);
+        fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+static void writeJson(FILE *fp, const OPTIONS *o)
+{
+    fprintf(fp, "{\n  \"tool\": \"picsim\",\n  \"hex\": ");
+    jsonString(fp, o->hexPath);
+    fprintf(fp, ",\n  \"mode\": \"%s\",\n", o->callName ? "call" : "run");
+    fprintf(fp, "  \"fosc_hz\": %u,\n", per.foscHz);
+    fprintf(fp, "  \"sim_time_us\": %.1f,\n", per.timeUs);
+    fprintf(fp, "  \"cycles\": %llu,\n", (unsigned long long)cpu.cycles);
+    fprintf(fp, "  \"instructions\": %llu,\n", (unsigned long long)cpu.instructions);
+    fprintf(fp, "  \"stack_max\": %u,\n", cpu.spMax);
+    fprintf(fp, "  \"paging\": { \"calls\": %llu, \"far_calls\": %llu, \"movlp\": %llu, \"movlb\": %llu },\n",
+            (unsigned long long)cpu.calls, (unsigned long long)cpu.farCalls,
+            (unsigned long long)cpu.movlps, (unsigned long long)cpu.movlbs);
+    fprintf(fp, "  \"interrupts\": %u,\n", prof.interrupts);
+    fprintf(fp, "  \"stimulus_events\": %u,\n", stim.applied);
+    fprintf(fp, "  \"nvm\": { \"erases\": %u, \"row_writes\": %u, \"stall_cycles\": %llu },\n",
+            per.erases, per.rowWrites, (unsigned long long)per.stallCycles);
+    fprintf(fp, "  \"halted\": ");
+    if (cpu.halted) {
+        jsonString(fp, cpu.haltReason);
+    } else {
+        fprintf(fp, "null");
+    }
+    if (o->dumpLen) {
+        fprintf(fp, ",\n  \"dump\": { \"address\": \"0x%04X\", \"bytes\": \"", o->dumpAddr);
+        for (unsigned i = 0; i < o->dumpLen; i++) {
+            fprintf(fp, "%s%02X", i ? " " : "", Cpu_ReadLinear(&cpu, (uint16_t)(o->dumpAddr + i)));
+        }
+        fprintf(fp, "\" }");
+    }
+    fprintf(fp, ",\n  \"main_loop\": ");
+    if (prof.anchor >= 0) {
+        fprintf(fp, "{ \"anchor\": ");
+        jsonString(fp, prof.funcs[prof.anchor].name);
+        fprintf(fp, ", ");
+        Sample_WriteJson(fp, &prof.loop);
+        fprintf(fp, " },\n");
+    } else {
+        fprintf(fp, "null,\n");
+    }
+    fprintf(fp, "  \"functions\": [");
+    for (unsigned i = 0; i < prof.nfuncs; i++) {
+        fprintf(fp, "%s\n    { \"name\": ", i ? "," : "");
+        jsonString(fp, prof.funcs[i].name);
+        fprintf(fp, ", \"address\": \"0x%04X\", ", prof.funcs[i].addr);
+        Sample_WriteJson(fp, &prof.funcs[i].samples);
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n  ]");
+    if (o->usb) {
+        fprintf(fp, ",\n  \"usb\": ");
+        Host_WriteJson(&host, fp);
+    }
+    fprintf(fp, "\n}\n");
+}
+
+static void loadSymbols(OPTIONS *o)
+{
+    static char guess[1024];
+
+    if (o->symPath == NULL) {
+        const char *dot = strrchr(o->hexPath, '.');
+        size_t n = dot ? (size_t)(dot - o->hexPath) : strlen(o->hexPath);
+        if (n + 5 < sizeof(guess)) {
+            memcpy(guess, o->hexPath, n);
+            strcpy(guess + n, ".sym");
+            if (Sym_Load(&syms, guess) >= 0) o->symPath = guess;
+        }
+    } else if (Sym_Load(&syms, o->symPath) < 0) {
+        perror(o->symPath);
+        exit(1);
+    }
+    for (unsigned i = 0; i < o->ndefs; i++) {
+        if (!Sym_Define(&syms, o->defs[i], !o->defData[i])) {
+            fprintf(stderr, "picsim: bad %s '%s' (expected NAME=ADDR)\n",
+                    o->defData[i] ? "--data" : "--func", o->defs[i]);
+            exit(2);
+        }
+    }
+}
+
+static void addProfiled(const char *name, bool quiet)
+{
+    const SYMBOL *s = Sym_Find(&syms, name);
+
+    if (s == NULL || !s->code) {
+        if (!quiet) fprintf(stderr, "picsim: no address for %s, not profiled\n", name);
+        return;
+    }
+    Profile_Add(&prof, name, (uint16_t)s->addr);
+}
+
+int main(int argc, char **argv)
+{
+    OPTIONS o;
+    FILE *out = stdout;
+    int callIndex = -1;
+    int callDepth = -1;             // stack depth to return to before --call starts
+    uint16_t callAddr = 0;
+    uint16_t argAddr = 0;
+    uint16_t stateAddr = 0;         // USBDeviceState, when known
+
+    parseArgs(argc, argv, &o);
+    if (!Ihex_Load(o.hexPath, &image)) return 1;
+    loadSymbols(&o);
+
+    if (o.disasm) {
+        disassemble();
+        return 0;
+    }
+    if (o.pages) {
+        pageReport();
+        return 0;
+    }
+    if (o.offset < 0) o.offset = image.used[0] ? 0 : image.lowest;
+    if (o.stackLevels) return stackReport((uint16_t)o.offset, o.stackLevels);
+
+    memcpy(cpu.flash, image.progmem, sizeof(cpu.flash));
+    memcpy(cpu.config, image.config, sizeof(cpu.config));
+    cpu.resetVector = (uint16_t)o.offset;
+    cpu.intVector = (uint16_t)(o.offset + 4);
+    // an application linked above a bootloader is entered through its vectors
+    cpu.intExtraCycles = o.offset ? FORWARDER_CYCLES : 0;
+
+    Cpu_Reset(&cpu);
+    Periph_Init(&per, &cpu);
+    Profile_Attach(&prof, &cpu);
+    prof.enabled = (o.skipUs <= 0);
+
+    if (o.stimPath && !Stim_Load(&stim, o.stimPath)) return 1;
+    if (o.usb) {
+        const SYMBOL *s = Sym_Find(&syms, "USBDeviceState");
+
+        if (!Host_Load(&host, o.hostPath)) return 1;
+        Sie_Init(&sie, &per);
+        Host_Attach(&host, &sie, &prof);
+        if (s != NULL) stateAddr = (uint16_t)s->addr;
+        if (o.reportPath) {
+            host.reportLog = fopen(o.reportPath, "w");
+            if (host.reportLog == NULL) {
+                perror(o.reportPath);
+                return 1;
+            }
+            fprintf(host.reportLog, "time_us,ep,frame,report\n");
+        }
+    }
+
+    if (o.nprof == 0) {
+        for (unsigned i = 0; i < sizeof(defaultFuncs) / sizeof(defaultFuncs[0]); i++) {
+            addProfiled(defaultFuncs[i], o.symPath == NULL && o.ndefs == 0);
+        }
+    }
+    for (unsigned i = 0; i < o.nprof; i++) addProfiled(o.profNames[i], false);
+    addProfiled(o.loopName, o.symPath == NULL && o.ndefs == 0);
+    for (unsigned i = 0; i < prof.nfuncs; i++) {
+        if (strcmp(prof.funcs[i].name, o.loopName) == 0) prof.anchor = (int)i;
+    }
+    if (o.callName) {
+        const SYMBOL *s = Sym_Find(&syms, o.callName);
+        if (s == NULL || !s->code || prof.anchor < 0) {
+            fprintf(stderr, "picsim: --call needs addresses for %s and %s\n", o.callName, o.loopName);
+            return 2;
+        }
+        callAddr = (uint16_t)s->addr;
+        if (o.nargs) {
+            // XC8 passes arguments in the callee's "?_name" block
+            char argName[SYM_NAME_MAX + 2];
+            snprintf(argName, sizeof(argName), "?_%s", o.callName);
+            s = Sym_Find(&syms, argName);
+            if (s == NULL) {
+                fprintf(stderr, "picsim: --arg needs the address of %s\n", argName);
+                return 2;
+            }
+            argAddr = (uint16_t)s->addr;
+        }
+        addProfiled(o.callName, false);
+        callIndex = 0;
+    }
+
+    // in --call mode the last call is allowed to finish
+    while (!cpu.halted && (per.timeUs < o.runUs || (callIndex > 0 && cpu.pc != CPU_SENTINEL_PC))) {
+        applyStimulus();
+        if (!prof.enabled && per.timeUs >= o.skipUs) prof.enabled = true;
+
+        if (callIndex >= 0) {
+            // wait for the first anchor call to finish, then keep main parked
+            if (callDepth < 0 && prof.anchorEntries) callDepth = (int)cpu.sp - 1;
+            if (callDepth >= 0 && per.timeUs < o.runUs
+                    && (cpu.pc == CPU_SENTINEL_PC || (callIndex == 0 && cpu.sp == callDepth))) {
+                for (unsigned i = 0; i < o.nargs; i++) Cpu_WriteData(&cpu, (uint16_t)(argAddr + i), o.args[i]);
+                Cpu_Call(&cpu, callAddr);
+                callIndex++;
+            }
+        }
+        if (stateAddr && !host.deviceConfigured && Cpu_ReadData(&cpu, stateAddr) == CONFIGURED_STATE) {
+            Host_DeviceConfigured(&host);
+        }
+        if (o.trace) {
+            traceStep();
+            o.trace--;
+        }
+        Cpu_Step(&cpu);
+    }
+
+    if (o.jsonPath) {
+        out = fopen(o.jsonPath, "w");
+        if (out == NULL) {
+            perror(o.jsonPath);
+            return 1;
+        }
+    }
+    writeJson(out, &o);
+    if (out != stdout) fclose(out);
+    if (cpu.halted) fprintf(stderr, "picsim: %s\n", cpu.haltReason);
+
+    if (host.reportLog) fclose(host.reportLog);
+    Host_Free(&host);
+    Profile_Free(&prof);
+    Stim_Free(&stim);
+    Sym_Free(&syms);
+    return cpu.halted ? 1 : 0;
+}
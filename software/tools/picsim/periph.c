@@ -0,0 +1,327 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "periph.h"
+
+#define NVM_ROW_TIME_US     2000.0  // row erase / row write, typical
+
+/* pins with interrupt-on-change: RA0-RA5, RB4-RB7 */
+static const uint8_t iocMask[PERIPH_PORTS] = { 0x3F, 0xF0, 0x00 };
+
+static void periphTick(void *ctx, unsigned cycles);
+
+static void updateFosc(PICSIM_PERIPH *per)
+{
+    static const uint32_t ircf[16] = {
+        31000, 31000, 31250, 31250, 62500, 125000, 250000, 500000,
+        125000, 250000, 500000, 1000000, 2000000, 4000000, 8000000, 16000000
+    };
+    uint8_t osccon = per->cpu->ram[R_OSCCON];
+    uint32_t f = ircf[(osccon >> 2) & 0x0F];
+
+    // 3x/4x PLL behind the 8/16 MHz HFINTOSC
+    if ((osccon & 0x80) && f >= 8000000) f *= (osccon & 0x40) ? 3 : 4;
+    per->foscHz = f;
+}
+
+double Periph_CyclesPerUs(const PICSIM_PERIPH *per)
+{
+    return per->foscHz / 4.0 / 1e6;
+}
+
+static void updateIocFlag(PICSIM_PERIPH *per)
+{
+    PICSIM_CPU *cpu = per->cpu;
+
+    if (cpu->ram[R_IOCAF] || cpu->ram[R_IOCBF]) {
+        cpu->core[R_INTCON] |= INTCON_IOCIF;
+    } else {
+        cpu->core[R_INTCON] &= (uint8_t)~INTCON_IOCIF;
+    }
+}
+
+static uint8_t pinLevels(PICSIM_PERIPH *per, unsigned port)
+{
+    PICSIM_CPU *cpu = per->cpu;
+    uint8_t tris = cpu->ram[R_TRISA + port];
+    uint8_t lat = cpu->ram[R_LATA + port];
+    uint8_t ansel = cpu->ram[R_ANSELA + port];
+
+    // analog-selected inputs read 0 in the digital path
+    return (uint8_t)(((per->pins[port] & tris) | (lat & ~tris)) & ~(ansel & tris));
+}
+
+static void sampleIoc(PICSIM_PERIPH *per)
+{
+    PICSIM_CPU *cpu = per->cpu;
+
+    for (unsigned port = 0; port < 2; port++) {
+        uint8_t now = pinLevels(per, port);
+        uint8_t rise = (uint8_t)(now & ~per->lastLevel[port] & iocMask[port]);
+        uint8_t fall = (uint8_t)(~now & per->lastLevel[port] & iocMask[port]);
+        uint16_t p = port ? R_IOCBP : R_IOCAP;
+
+        cpu->ram[p + 2] |= (uint8_t)((rise & cpu->ram[p]) | (fall & cpu->ram[p + 1]));
+        per->lastLevel[port] = now;
+    }
+    updateIocFlag(per);
+}
+
+void Periph_SetPin(PICSIM_PERIPH *per, unsigned port, unsigned bit, bool level)
+{
+    if (port >= PERIPH_PORTS || bit > 7) return;
+    if (level) {
+        per->pins[port] |= (uint8_t)(1u << bit);
+    } else {
+        per->pins[port] &= (uint8_t)~(1u << bit);
+    }
+    sampleIoc(per);
+}
+
+/*** flash controller *********************************************************/
+
+static void nvmStall(PICSIM_PERIPH *per)
+{
+    // the core stops fetching for the duration; peripherals keep running
+    unsigned cycles = (unsigned)(NVM_ROW_TIME_US * Periph_CyclesPerUs(per));
+
+    per->cpu->cycles += cycles;
+    per->stallCycles += cycles;
+    periphTick(per, cycles);
+}
+
+static void nvmCommand(PICSIM_PERIPH *per, uint8_t pmcon1)
+{
+    PICSIM_CPU *cpu = per->cpu;
+    uint16_t addr = (uint16_t)((cpu->ram[R_PMADRH] & 0x7F) << 8 | cpu->ram[R_PMADRL]);
+    uint16_t data = (uint16_t)((cpu->ram[R_PMDATH] & 0x3F) << 8 | cpu->ram[R_PMDATL]);
+    uint16_t row = addr & (uint16_t)~(FLASH_ROW_WORDS - 1) & (CPU_FLASH_WORDS - 1);
+
+    if (pmcon1 & PMCON1_RD) {
+        if (pmcon1 & PMCON1_CFGS) {
+            data = cpu->config[addr & 0x0F];
+        } else {
+            data = cpu->flash[addr & (CPU_FLASH_WORDS - 1)];
+        }
+        cpu->ram[R_PMDATL] = (uint8_t)data;
+        cpu->ram[R_PMDATH] = (uint8_t)(data >> 8);
+        return;
+    }
+
+    if (!(pmcon1 & PMCON1_WR)) return;
+
+    // WR is only honoured right after the 0x55/0xAA sequence with WREN set
+    if (!(pmcon1 & PMCON1_WREN)
+            || cpu->instructions - per->unlockAA > 1
+            || per->unlockAA - per->unlock55 > 2
+            || (pmcon1 & PMCON1_CFGS)) {
+        return;
+    }
+
+    if (pmcon1 & PMCON1_FREE) {
+        for (unsigned i = 0; i < FLASH_ROW_WORDS; i++) cpu->flash[row + i] = 0x3FFF;
+        per->erases++;
+        nvmStall(per);
+    } else {
+        per->latch[addr & (FLASH_ROW_WORDS - 1)] = data;
+        if (!(pmcon1 & PMCON1_LWLO)) {
+            for (unsigned i = 0; i < FLASH_ROW_WORDS; i++) {
+                cpu->flash[row + i] &= per->latch[i];
+                per->latch[i] = 0x3FFF;
+            }
+            per->rowWrites++;
+            nvmStall(per);
+        }
+    }
+}
+
+/*** SFR access ***************************************************************/
+
+static bool isUsbReg(uint16_t addr)
+{
+    return addr >= R_UCON && addr <= R_UEP0 + 7;
+}
+
+static uint8_t periphRead(void *ctx, uint16_t addr)
+{
+    PICSIM_PERIPH *per = ctx;
+    PICSIM_CPU *cpu = per->cpu;
+
+    switch (addr) {
+        case R_PORTA:
+        case R_PORTB:
+        case R_PORTC:
+            return pinLevels(per, addr - R_PORTA);
+        case R_OSCSTAT:
+            return 0x79;        // PLL ready, HFINTOSC ready and stable
+        default:
+            break;
+    }
+    if (isUsbReg(addr) && per->usbRead) return per->usbRead(per->usbCtx, addr);
+    return cpu->ram[addr];
+}
+
+static void periphWrite(void *ctx, uint16_t addr, uint8_t v)
+{
+    PICSIM_PERIPH *per = ctx;
+    PICSIM_CPU *cpu = per->cpu;
+
+    switch (addr) {
+        case R_PORTA:
+        case R_PORTB:
+        case R_PORTC:
+            cpu->ram[R_LATA + (addr - R_PORTA)] = v;
+            sampleIoc(per);
+            return;
+        case R_LATA:
+        case R_LATB:
+        case R_LATC:
+        case R_TRISA:
+        case R_TRISB:
+        case R_TRISC:
+        case R_ANSELA:
+        case R_ANSELB:
+        case R_ANSELC:
+            cpu->ram[addr] = v;
+            sampleIoc(per);
+            return;
+        case R_TMR0:
+            cpu->ram[addr] = v;
+            per->tmr0Prescale = 0;
+            return;
+        case R_OSCCON:
+            cpu->ram[addr] = v;
+            updateFosc(per);
+            return;
+        case R_OSCSTAT:
+            return;
+        case R_IOCAF:
+        case R_IOCBF:
+            cpu->ram[addr] = v;
+            updateIocFlag(per);
+            return;
+        case R_PMCON2:
+            if (v == 0x55) per->unlock55 = cpu->instructions;
+            if (v == 0xAA) per->unlockAA = cpu->instructions;
+            return;
+        case R_PMCON1:
+            cpu->ram[addr] = (uint8_t)(v | 0x80);
+            nvmCommand(per, v);
+            cpu->ram[addr] &= (uint8_t)~(PMCON1_RD | PMCON1_WR);
+            return;
+        default:
+            break;
+    }
+    if (isUsbReg(addr) && per->usbWrite) {
+        per->usbWrite(per->usbCtx, addr, v);
+        return;
+    }
+    cpu->ram[addr] = v;
+}
+
+/*** timers *******************************************************************/
+
+static void tickTimer0(PICSIM_PERIPH *per, unsigned cycles)
+{
+    PICSIM_CPU *cpu = per->cpu;
+    uint8_t option = cpu->ram[R_OPTION];
+    unsigned div, incs;
+
+    if (option & OPTION_TMR0CS) return;                 // T0CKI pin not modelled
+    div = (option & OPTION_PSA) ? 1u : 2u << (option & OPTION_PS);
+    per->tmr0Prescale += cycles;
+    incs = per->tmr0Prescale / div;
+    per->tmr0Prescale %= div;
+    if (incs == 0) return;
+    if ((unsigned)cpu->ram[R_TMR0] + incs > 0xFF) cpu->core[R_INTCON] |= INTCON_TMR0IF;
+    cpu->ram[R_TMR0] = (uint8_t)(cpu->ram[R_TMR0] + incs);
+}
+
+static void tickTimer1(PICSIM_PERIPH *per, unsigned cycles)
+{
+    PICSIM_CPU *cpu = per->cpu;
+    uint8_t t1con = cpu->ram[R_T1CON];
+    unsigned div, incs, count;
+
+    if (!(t1con & 0x01)) return;
+    if ((t1con & 0xC0) == 0x40) {
+        cycles *= 4;                                    // Fosc source
+    } else if (t1con & 0x80) {
+        return;                                         // external sources not modelled
+    }
+    div = 1u << ((t1con >> 4) & 3);
+    per->tmr1Prescale += cycles;
+    incs = per->tmr1Prescale / div;
+    per->tmr1Prescale %= div;
+    if (incs == 0) return;
+    count = (unsigned)(cpu->ram[R_TMR1H] << 8 | cpu->ram[R_TMR1L]) + incs;
+    if (count > 0xFFFF) cpu->ram[R_PIR1] |= PIR1_TMR1IF;
+    cpu->ram[R_TMR1L] = (uint8_t)count;
+    cpu->ram[R_TMR1H] = (uint8_t)(count >> 8);
+}
+
+static void periphTick(void *ctx, unsigned cycles)
+{
+    PICSIM_PERIPH *per = ctx;
+    double us = cycles / Periph_CyclesPerUs(per);
+
+    per->timeUs += us;
+    if (!per->cpu->sleeping) {
+        // both timers run from the instruction clock, which stops in Sleep
+        tickTimer0(per, cycles);
+        tickTimer1(per, cycles);
+    }
+    if (per->usbTick) per->usbTick(per->usbCtx, us);
+}
+
+void Periph_Init(PICSIM_PERIPH *per, PICSIM_CPU *cpu)
+{
+    void *usbCtx = per->usbCtx;
+    uint8_t (*usbRead)(void *, uint16_t) = per->usbRead;
+    void (*usbWrite)(void *, uint16_t, uint8_t) = per->usbWrite;
+    void (*usbTick)(void *, double) = per->usbTick;
+
+    memset(per, 0, sizeof(*per));
+    per->cpu = cpu;
+    per->usbCtx = usbCtx;
+    per->usbRead = usbRead;
+    per->usbWrite = usbWrite;
+    per->usbTick = usbTick;
+
+    for (unsigned i = 0; i < PERIPH_PORTS; i++) per->pins[i] = 0xFF;
+    for (unsigned i = 0; i < FLASH_ROW_WORDS; i++) per->latch[i] = 0x3FFF;
+
+    cpu->ram[R_TRISA] = 0xFF;
+    cpu->ram[R_TRISB] = 0xFF;
+    cpu->ram[R_TRISC] = 0xFF;
+    cpu->ram[R_ANSELA] = 0x10;
+    cpu->ram[R_ANSELB] = 0x30;
+    cpu->ram[R_ANSELC] = 0xCF;
+    cpu->ram[R_WPUA] = 0x3F;
+    cpu->ram[R_WPUB] = 0xF0;
+    cpu->ram[R_OPTION] = 0xFF;
+    cpu->ram[R_OSCCON] = 0x1C;      // 500 kHz until the firmware switches
+    cpu->ram[R_PMCON1] = 0x80;
+    updateFosc(per);
+    for (unsigned i = 0; i < 2; i++) per->lastLevel[i] = pinLevels(per, i);
+
+    cpu->bus.ctx = per;
+    cpu->bus.read = periphRead;
+    cpu->bus.write = periphWrite;
+    cpu->bus.tick = periphTick;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   periph.h
+ * On-chip peripherals used by the gamepad firmware: I/O ports with
+ * interrupt-on-change, Timer0, Timer1, the oscillator block and the
+ * flash self-read/self-write controller.
+ *
+ * Input pins read the level set with Periph_SetPin(); an undriven pin
+ * reads high, which is what the board's pull-ups give a released button.
+ * SFRs without a model behave as plain memory. The USB register block
+ * can be handed to another module through the usb hooks.
+ */
+
+#ifndef PERIPH_H
+#define PERIPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cpu.h"
+
+#define PERIPH_PORTS        3       // PORTA, PORTB, PORTC
+
+typedef struct
+{
+    PICSIM_CPU *cpu;
+
+    uint8_t  pins[PERIPH_PORTS];    // externally driven input levels
+    uint8_t  lastLevel[PERIPH_PORTS];
+
+    uint32_t foscHz;
+    double   timeUs;                // simulated time since power-on
+
+    unsigned tmr0Prescale;
+    unsigned tmr1Prescale;
+
+    /* flash controller */
+    uint16_t latch[FLASH_ROW_WORDS];
+    uint64_t unlock55;              // instruction count at PMCON2 = 0x55
+    uint64_t unlockAA;              // instruction count at PMCON2 = 0xAA
+    unsigned erases;
+    unsigned rowWrites;
+    uint64_t stallCycles;
+
+    /* optional USB register block (bank 29, 0xE8E-0xE9F) */
+    void    *usbCtx;
+    uint8_t (*usbRead)(void *ctx, uint16_t addr);
+    void    (*usbWrite)(void *ctx, uint16_t addr, uint8_t value);
+    void    (*usbTick)(void *ctx, double us);
+} PICSIM_PERIPH;
+
+/**
+ * Attach the peripherals to a core and apply power-on reset values.
+ */
+void Periph_Init(PICSIM_PERIPH *per, PICSIM_CPU *cpu);
+
+/**
+ * Drive an input pin from outside.
+ * @param port  0 = PORTA, 1 = PORTB, 2 = PORTC
+ * @param bit   pin number
+ * @param level 0 or 1
+ */
+void Periph_SetPin(PICSIM_PERIPH *per, unsigned port, unsigned bit, bool level);
+
+/**
+ * Instruction cycles per microsecond at the current oscillator setting.
+ */
+double Periph_CyclesPerUs(const PICSIM_PERIPH *per);
+
+#endif /* PERIPH_H */
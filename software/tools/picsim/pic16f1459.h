@@ -0,0 +1,163 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   pic16f1459.h
+ * Data memory map of the PIC16F1459 as seen by the simulator.
+ *
+ * Addresses are 12-bit "traditional" addresses (BSR << 7 | offset).
+ * Only the registers the firmware touches are modelled; everything
+ * else in the SFR window reads back what was written.
+ */
+
+#ifndef PIC16F1459_H
+#define PIC16F1459_H
+
+/* core registers, mirrored at offset 0x00-0x0B of every bank */
+#define R_INDF0     0x00
+#define R_INDF1     0x01
+#define R_PCL       0x02
+#define R_STATUS    0x03
+#define R_FSR0L     0x04
+#define R_FSR0H     0x05
+#define R_FSR1L     0x06
+#define R_FSR1H     0x07
+#define R_BSR       0x08
+#define R_WREG      0x09
+#define R_PCLATH    0x0A
+#define R_INTCON    0x0B
+#define CORE_REGS   0x0C
+
+#define STATUS_C    0x01
+#define STATUS_DC   0x02
+#define STATUS_Z    0x04
+#define STATUS_nPD  0x08
+#define STATUS_nTO  0x10
+
+#define INTCON_IOCIF    0x01
+#define INTCON_INTF     0x02
+#define INTCON_TMR0IF   0x04
+#define INTCON_IOCIE    0x08
+#define INTCON_INTE     0x10
+#define INTCON_TMR0IE   0x20
+#define INTCON_PEIE     0x40
+#define INTCON_GIE      0x80
+
+/* bank 0 */
+#define R_PORTA     0x00C
+#define R_PORTB     0x00D
+#define R_PORTC     0x00E
+#define R_PIR1      0x011
+#define R_PIR2      0x012
+#define R_TMR0      0x015
+#define R_TMR1L     0x016
+#define R_TMR1H     0x017
+#define R_T1CON     0x018
+#define R_T1GCON    0x019
+
+#define PIR1_TMR1IF 0x01
+#define PIR2_USBIF  0x04
+
+/* bank 1 */
+#define R_TRISA     0x08C
+#define R_TRISB     0x08D
+#define R_TRISC     0x08E
+#define R_PIE1      0x091
+#define R_PIE2      0x092
+#define R_OPTION    0x095
+#define R_PCON      0x096
+#define R_WDTCON    0x097
+#define R_OSCTUNE   0x098
+#define R_OSCCON    0x099
+#define R_OSCSTAT   0x09A
+
+#define OPTION_PS       0x07
+#define OPTION_PSA      0x08
+#define OPTION_TMR0CS   0x20
+#define OPTION_nWPUEN   0x80
+
+/* bank 2 */
+#define R_LATA      0x10C
+#define R_LATB      0x10D
+#define R_LATC      0x10E
+
+/* bank 3 */
+#define R_ANSELA    0x18C
+#define R_ANSELB    0x18D
+#define R_ANSELC    0x18E
+#define R_PMADRL    0x191
+#define R_PMADRH    0x192
+#define R_PMDATL    0x193
+#define R_PMDATH    0x194
+#define R_PMCON1    0x195
+#define R_PMCON2    0x196
+
+#define PMCON1_RD   0x01
+#define PMCON1_WR   0x02
+#define PMCON1_WREN 0x04
+#define PMCON1_WRERR 0x08
+#define PMCON1_FREE 0x10
+#define PMCON1_LWLO 0x20
+#define PMCON1_CFGS 0x40
+
+/* bank 4 */
+#define R_WPUA      0x20C
+#define R_WPUB      0x20D
+
+/* bank 7 */
+#define R_IOCAP     0x391
+#define R_IOCAN     0x392
+#define R_IOCAF     0x393
+#define R_IOCBP     0x394
+#define R_IOCBN     0x395
+#define R_IOCBF     0x396
+#define R_ACTCON    0x39B
+
+/* bank 29: USB */
+#define R_UCON      0xE8E
+#define R_USTAT     0xE8F
+#define R_UIR       0xE90
+#define R_UCFG      0xE91
+#define R_UIE       0xE92
+#define R_UEIR      0xE93
+#define R_UFRMH     0xE94
+#define R_UFRML     0xE95
+#define R_UADDR     0xE96
+#define R_UEIE      0xE97
+#define R_UEP0      0xE98
+
+/* bank 31: shadow registers and stack access */
+#define R_STATUS_SHAD   0xFE4
+#define R_WREG_SHAD     0xFE5
+#define R_BSR_SHAD      0xFE6
+#define R_PCLATH_SHAD   0xFE7
+#define R_FSR0L_SHAD    0xFE8
+#define R_FSR0H_SHAD    0xFE9
+#define R_FSR1L_SHAD    0xFEA
+#define R_FSR1H_SHAD    0xFEB
+#define R_STKPTR        0xFED
+#define R_TOSL          0xFEE
+#define R_TOSH          0xFEF
+
+/* memory sizes */
+#define DATA_SPACE      0x1000      // 32 banks x 128
+#define LINEAR_BASE     0x2000
+#define LINEAR_SIZE     0x03F0      // 1008 bytes of banked GPR
+#define FLASH_FSR_BASE  0x8000
+#define FLASH_ROW_WORDS 32
+#define STACK_LEVELS    16
+
+#endif /* PIC16F1459_H */
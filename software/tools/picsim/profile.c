@@ -0,0 +1,101 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+
+#define RETURN_CYCLES   2u
+
+static void onCall(void *ctx, uint16_t target, uint16_t from)
+{
+    PROFILE *prof = ctx;
+    (void)from;
+
+    if (prof->anchor >= 0 && target == prof->funcs[prof->anchor].addr) {
+        if (prof->anchorEntries && prof->enabled) {
+            Sample_Add(&prof->loop, (uint32_t)(prof->cpu->cycles - prof->lastAnchor));
+        }
+        prof->anchorEntries++;
+        prof->lastAnchor = prof->cpu->cycles;
+    }
+    if (prof->depth < PROFILE_MAX_DEPTH) {
+        prof->frames[prof->depth].target = target;
+        prof->frames[prof->depth].start = prof->cpu->cycles;
+    }
+    prof->depth++;
+}
+
+static void onReturn(void *ctx, uint16_t to)
+{
+    PROFILE *prof = ctx;
+    const PROFILE_FRAME *f;
+    (void)to;
+
+    if (prof->depth == 0) return;
+    prof->depth--;
+    if (prof->depth >= PROFILE_MAX_DEPTH || !prof->enabled) return;
+
+    f = &prof->frames[prof->depth];
+    for (unsigned i = 0; i < prof->nfuncs; i++) {
+        if (prof->funcs[i].addr == f->target) {
+            // hook runs before the RETURN is charged
+            Sample_Add(&prof->funcs[i].samples,
+                       (uint32_t)(prof->cpu->cycles + RETURN_CYCLES - f->start));
+        }
+    }
+}
+
+static void onInterrupt(void *ctx, uint16_t from)
+{
+    PROFILE *prof = ctx;
+
+    prof->interrupts++;
+    onCall(ctx, prof->cpu->intVector, from);
+}
+
+void Profile_Attach(PROFILE *prof, PICSIM_CPU *cpu)
+{
+    memset(prof, 0, sizeof(*prof));
+    prof->cpu = cpu;
+    prof->anchor = -1;
+    prof->enabled = true;
+    cpu->hooks.ctx = prof;
+    cpu->hooks.call = onCall;
+    cpu->hooks.ret = onReturn;
+    cpu->hooks.interrupt = onInterrupt;
+}
+
+int Profile_Add(PROFILE *prof, const char *name, uint16_t addr)
+{
+    PROFILE_FUNC *fn;
+
+    for (unsigned i = 0; i < prof->nfuncs; i++) {
+        if (strcmp(prof->funcs[i].name, name) == 0) return (int)i;
+    }
+    if (prof->nfuncs == PROFILE_MAX_FUNCS) return -1;
+    fn = &prof->funcs[prof->nfuncs];
+    snprintf(fn->name, sizeof(fn->name), "%s", name);
+    fn->addr = addr;
+    return (int)prof->nfuncs++;
+}
+
+void Profile_Free(PROFILE *prof)
+{
+    for (unsigned i = 0; i < prof->nfuncs; i++) free(prof->funcs[i].samples.v);
+    free(prof->loop.v);
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   profile.h
+ * Per-function cycle accounting driven by the core's CALL/RETURN hooks.
+ *
+ * A call is timed from the first cycle of the CALL to the last cycle of
+ * the matching RETURN/RETLW, so call overhead and any interrupt taken
+ * inside the function are included. One function can be picked as the
+ * main-loop anchor: the time between two of its entries is one loop
+ * iteration.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cpu.h"
+#include "samples.h"
+
+#define PROFILE_MAX_FUNCS   16
+#define PROFILE_MAX_DEPTH   64
+#define PROFILE_NAME_MAX    48
+
+typedef struct
+{
+    char     name[PROFILE_NAME_MAX];
+    uint16_t addr;
+    SAMPLES  samples;
+} PROFILE_FUNC;
+
+typedef struct
+{
+    uint16_t target;
+    uint64_t start;
+} PROFILE_FRAME;
+
+typedef struct
+{
+    PICSIM_CPU   *cpu;
+    bool          enabled;          // collect samples (frames are always tracked)
+
+    PROFILE_FUNC  funcs[PROFILE_MAX_FUNCS];
+    unsigned      nfuncs;
+
+    int           anchor;           // index of the main-loop anchor, -1 if none
+    uint64_t      anchorEntries;
+    uint64_t      lastAnchor;
+    SAMPLES       loop;
+
+    PROFILE_FRAME frames[PROFILE_MAX_DEPTH];
+    unsigned      depth;
+    unsigned      interrupts;
+} PROFILE;
+
+/**
+ * Hook a profile into a core. Replaces cpu->hooks.
+ */
+void Profile_Attach(PROFILE *prof, PICSIM_CPU *cpu);
+
+/**
+ * Add a function to time.
+ * @return its index, or -1 when the table is full
+ */
+int Profile_Add(PROFILE *prof, const char *name, uint16_t addr);
+
+void Profile_Free(PROFILE *prof);
+
+#endif /* PROFILE_H */
@@ -0,0 +1,173 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "stack.h"
+#include "disasm.h"
+
+#define WORDS       IHEX_PROGMEM_WORDS
+#define UNKNOWN     -1
+#define VISITING    -2
+#define NONE        0xFFFFu
+
+static const IHEX_IMAGE *img;
+static uint8_t  pclathAt[WORDS];
+static int      depthOf[WORDS];
+static uint16_t nextOf[WORDS];          // callee on the deepest chain below a function
+static unsigned stamp[WORDS];           // reached in the walk numbered gen
+static unsigned gen;
+static uint16_t work[WORDS];
+static unsigned nwork;
+static STACK_DEPTH *result;
+
+static bool isSkip(uint16_t op)
+{
+    return (op & 0x3800) == 0x1800                 // BTFSC, BTFSS
+        || (op & 0x3F00) == 0x0B00                  // DECFSZ
+        || (op & 0x3F00) == 0x0F00;                 // INCFSZ
+}
+
+static bool writesPcl(uint16_t op)
+{
+    return (op & 0x3000) == 0 && (op & 0x00FF) == 0x82;   // MOVWF PCL, ADDWF PCL,F ...
+}
+
+static bool isJump(uint16_t op)
+{
+    return (op & 0x3800) == 0x2800 || (op & 0x3E00) == 0x3200;     // GOTO, BRA
+}
+
+static void reach(unsigned a)
+{
+    if (a < WORDS && img->used[a] && stamp[a] != gen) {
+        stamp[a] = gen;
+        work[nwork++] = (uint16_t)a;
+    }
+}
+
+/* a jump table right after a computed jump: GOTO, BRA or RETLW entries */
+static void reachTable(unsigned a)
+{
+    unsigned b;
+
+    for (b = a; b < WORDS && img->used[b]; b++) {
+        uint16_t op = img->progmem[b];
+
+        if (isJump(op)) {
+            reach((unsigned)Disasm_Target(op, (uint16_t)b, pclathAt[b]));
+        } else if ((op & 0x3F00) != 0x3400) {
+            break;
+        }
+    }
+    if (b == a) result->indirect++;
+}
+
+/* the CALL targets reachable from entry before a return, without repeats */
+static unsigned callees(uint16_t entry, uint16_t **out)
+{
+    uint16_t *list = NULL;
+    unsigned count = 0, cap = 0;
+
+    gen++;
+    nwork = 0;
+    reach(entry);
+    while (nwork) {
+        unsigned a = work[--nwork];
+        uint16_t op = img->progmem[a];
+        int target = Disasm_Target(op, (uint16_t)a, pclathAt[a]);
+
+        if ((op & 0x3800) == 0x2000) {              // CALL
+            unsigned i;
+
+            for (i = 0; i < count && list[i] != target; i++) ;
+            if (i == count) {
+                if (count == cap) {
+                    cap = cap ? 2 * cap : 8;
+                    list = realloc(list, cap * sizeof(*list));
+                    if (list == NULL) abort();
+                }
+                list[count++] = (uint16_t)target;
+            }
+            reach(a + 1);
+        } else if (isJump(op)) {
+            reach((unsigned)target);
+        } else if (op == 0x0008 || op == 0x0009 || op == 0x0001 || (op & 0x3F00) == 0x3400) {
+            // RETURN, RETFIE, RESET, RETLW: this path ends
+        } else if (op == 0x000B || writesPcl(op)) {
+            reachTable(a + 1);
+        } else {
+            if (op == 0x000A) result->indirect++;   // CALLW
+            if (isSkip(op)) reach(a + 2);
+            reach(a + 1);
+        }
+    }
+    *out = list;
+    return count;
+}
+
+static int depth(uint16_t f)
+{
+    uint16_t *list;
+    unsigned n;
+    int best = 0;
+
+    if (depthOf[f] >= 0) return depthOf[f];
+    if (depthOf[f] == VISITING) {
+        if (result->recursion < 0) result->recursion = f;
+        return 0;
+    }
+    depthOf[f] = VISITING;
+    nextOf[f] = NONE;
+    n = callees(f, &list);
+    for (unsigned i = 0; i < n; i++) {
+        int d = 1 + depth(list[i]);
+
+        if (d > best) {
+            best = d;
+            nextOf[f] = list[i];
+        }
+    }
+    free(list);
+    depthOf[f] = best;
+    return best;
+}
+
+void Stack_Analyze(const IHEX_IMAGE *image, uint16_t entry, STACK_DEPTH *out)
+{
+    uint8_t pclath = (uint8_t)(image->lowest >> 8);
+
+    // PCLATH as the listing has it, word by word
+    for (unsigned a = 0; a < WORDS; a++) {
+        uint16_t op = image->progmem[a];
+
+        pclathAt[a] = pclath;
+        if (!image->used[a]) continue;
+        if ((op & 0x3F80) == 0x3180) pclath = op & 0x7F;
+        if (op == 0x0008 || op == 0x0009 || (op & 0x3F00) == 0x3400) pclath = (uint8_t)(a >> 8);
+    }
+    img = image;
+    result = out;
+    memset(out, 0, sizeof(*out));
+    out->recursion = -1;
+    for (unsigned a = 0; a < WORDS; a++) depthOf[a] = UNKNOWN;
+
+    out->depth = (unsigned)depth(entry);
+    for (unsigned f = entry; f != NONE && out->pathLen < STACK_PATH_MAX; f = nextOf[f]) {
+        out->path[out->pathLen++] = (uint16_t)f;
+    }
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   stack.h
+ * Worst-case hardware stack depth of an image, found from the code
+ * alone for "picsim --stack".
+ *
+ * Every path from an entry point is followed: both ways at a skip, into
+ * the target of a GOTO or BRA, and through the GOTO/BRA/RETLW table
+ * after a BRW or a write to PCL. Each CALL costs one level on top of its
+ * target's own worst case. CALL and GOTO targets use PCLATH as the
+ * listing does (MOVLP followed, reset to the own page after a return).
+ * A CALLW or an unresolved jump is counted but not followed, so the
+ * result is a lower bound when either shows up.
+ */
+
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdint.h>
+
+#include "ihex.h"
+
+#define STACK_PATH_MAX  32
+
+typedef struct
+{
+    unsigned depth;                     // CALL levels below the entry
+    uint16_t path[STACK_PATH_MAX];      // the entry, then each callee on the deepest chain
+    unsigned pathLen;
+    unsigned indirect;                  // CALLW and computed jumps, not followed
+    int      recursion;                 // a function reachable from itself, or -1
+} STACK_DEPTH;
+
+/**
+ * Worst-case call depth below one entry point (reset or interrupt vector).
+ */
+void Stack_Analyze(const IHEX_IMAGE *image, uint16_t entry, STACK_DEPTH *out);
+
+#endif /* STACK_H */
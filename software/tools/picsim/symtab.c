@@ -0,0 +1,128 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "symtab.h"
+
+static SYMBOL *findMutable(SYMTAB *tab, const char *name, bool code)
+{
+    for (unsigned i = 0; i < tab->count; i++) {
+        if (tab->syms[i].code == code && strcmp(tab->syms[i].name, name) == 0) return &tab->syms[i];
+    }
+    return NULL;
+}
+
+static void add(SYMTAB *tab, const char *name, uint32_t addr, bool code)
+{
+    SYMBOL *s = findMutable(tab, name, code);
+
+    if (s == NULL) {
+        if (tab->count == tab->cap) {
+            tab->cap = tab->cap ? tab->cap * 2 : 256;
+            tab->syms = realloc(tab->syms, tab->cap * sizeof(SYMBOL));
+            if (tab->syms == NULL) {
+                perror("symtab");
+                exit(1);
+            }
+        }
+        s = &tab->syms[tab->count++];
+    }
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->addr = addr;
+    s->code = code;
+}
+
+int Sym_Load(SYMTAB *tab, const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char line[512];
+    int n = 0;
+
+    if (fp == NULL) return -1;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char name[128], cls[64] = "";
+        unsigned long addr;
+        char *p = line;
+        int used;
+
+        // "_USBDeviceTasks 1D4B 0 CODE 0 text12 obj..." - the class
+        // column is not always present, so only CODE is looked for
+        if (sscanf(p, "%127s %lx%n", name, &addr, &used) != 2) continue;
+        p += used;
+        while (sscanf(p, "%63s%n", cls, &used) == 1) {
+            p += used;
+            if (strcmp(cls, "CODE") == 0) break;
+        }
+        if (name[0] == '_') {
+            add(tab, name + 1, (uint32_t)addr, strcmp(cls, "CODE") == 0);
+        } else {
+            add(tab, name, (uint32_t)addr, strcmp(cls, "CODE") == 0);
+        }
+        n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+bool Sym_Define(SYMTAB *tab, const char *def, bool code)
+{
+    const char *eq = strchr(def, '=');
+    char name[SYM_NAME_MAX];
+    char *end;
+    unsigned long addr;
+
+    if (eq == NULL || eq == def || (size_t)(eq - def) >= sizeof(name)) return false;
+    memcpy(name, def, (size_t)(eq - def));
+    name[eq - def] = '\0';
+    addr = strtoul(eq + 1, &end, 16);
+    if (*end != '\0' || end == eq + 1) return false;
+    add(tab, name, (uint32_t)addr, code);
+    return true;
+}
+
+const SYMBOL *Sym_Find(const SYMTAB *tab, const char *name)
+{
+    const SYMBOL *data = NULL;
+
+    for (unsigned i = 0; i < tab->count; i++) {
+        if (strcmp(tab->syms[i].name, name) != 0) continue;
+        if (tab->syms[i].code) return &tab->syms[i];
+        data = &tab->syms[i];
+    }
+    return data;
+}
+
+const SYMBOL *Sym_At(const SYMTAB *tab, uint32_t addr)
+{
+    const SYMBOL *best = NULL;
+
+    for (unsigned i = 0; i < tab->count; i++) {
+        const SYMBOL *s = &tab->syms[i];
+        if (!s->code || s->addr > addr) continue;
+        if (best == NULL || s->addr > best->addr) best = s;
+    }
+    return best;
+}
+
+void Sym_Free(SYMTAB *tab)
+{
+    free(tab->syms);
+    memset(tab, 0, sizeof(*tab));
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   symtab.h
+ * Symbol table for the simulator, loaded from the XC8 ".sym" file that
+ * MPLAB X leaves next to the hex in dist/default/production, plus
+ * NAME=ADDR definitions given on the command line.
+ *
+ * C names are stored without XC8's leading underscore.
+ */
+
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SYM_NAME_MAX    48
+
+typedef struct
+{
+    char     name[SYM_NAME_MAX];
+    uint32_t addr;
+    bool     code;              // program memory (word address)
+} SYMBOL;
+
+typedef struct
+{
+    SYMBOL  *syms;
+    unsigned count;
+    unsigned cap;
+} SYMTAB;
+
+/**
+ * Load an XC8 symbol file ("name value class ..." per line).
+ * @return number of symbols read, or -1 if the file can't be opened
+ */
+int Sym_Load(SYMTAB *tab, const char *path);
+
+/**
+ * Parse "NAME=ADDR" (hex, 0x optional) and add it as a code or data
+ * symbol, replacing an existing symbol of the same name.
+ * @return false on syntax error
+ */
+bool Sym_Define(SYMTAB *tab, const char *def, bool code);
+
+/**
+ * Look a name up; code symbols are preferred over data.
+ */
+const SYMBOL *Sym_Find(const SYMTAB *tab, const char *name);
+
+/**
+ * Nearest code symbol at or below an address (for traces), or NULL.
+ */
+const SYMBOL *Sym_At(const SYMTAB *tab, uint32_t addr);
+
+void Sym_Free(SYMTAB *tab);
+
+#endif /* SYMTAB_H */
@@ -0,0 +1,833 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "usbhost.h"
+#include "stimulus.h"
+
+/* timing, as used by the Linux hub driver for a root port */
+#define DEBOUNCE_US         100000.0
+#define RESET_US            10000.0
+#define RESET_RECOVERY_US   10000.0
+#define SET_ADDRESS_US      2000.0
+#define FRAME_US            1000.0
+#define RETRY_US            10.0        // NAKed transaction retried this much later
+#define CONTROL_TIMEOUT_US  5000000.0
+
+#define DEVICE_ADDRESS      1
+
+/* standard requests and descriptors */
+#define REQ_GET_DESCRIPTOR      0x06
+#define REQ_SET_ADDRESS         0x05
+#define REQ_SET_CONFIGURATION   0x09
+#define HID_GET_REPORT          0x01
+#define HID_SET_REPORT          0x09
+#define HID_SET_IDLE            0x0A
+
+#define DSC_DEVICE      0x01
+#define DSC_CONFIG      0x02
+#define DSC_STRING      0x03
+#define DSC_INTERFACE   0x04
+#define DSC_ENDPOINT    0x05
+#define DSC_HID         0x21
+#define DSC_REPORT      0x22
+
+#define HID_CLASS       0x03
+
+/* enumeration steps, in order */
+enum
+{
+    ENUM_NONE,
+    ENUM_ATTACH,
+    ENUM_DEBOUNCE,
+    ENUM_RESET1,
+    ENUM_RECOVERY1,
+    ENUM_DEVICE64,
+    ENUM_RESET2,
+    ENUM_RECOVERY2,
+    ENUM_SET_ADDRESS,
+    ENUM_ADDRESS_WAIT,
+    ENUM_DEVICE18,
+    ENUM_CONFIG9,
+    ENUM_CONFIG,
+    ENUM_LANGIDS,
+    ENUM_STRINGS,
+    ENUM_SET_CONFIG,
+    ENUM_HID
+};
+
+static uint64_t iterations(const USB_HOST *host)
+{
+    return host->prof ? host->prof->anchorEntries : 0;
+}
+
+/* bus time of one full-speed transaction with len data bytes */
+static double transactionUs(unsigned len)
+{
+    return 3.0 + 0.7 * len;
+}
+
+/*** control transfers ********************************************************/
+
+static void setupPacket(uint8_t *s, uint8_t type, uint8_t req,
+                        uint16_t value, uint16_t index, uint16_t length)
+{
+    s[0] = type;
+    s[1] = req;
+    s[2] = (uint8_t)value;
+    s[3] = (uint8_t)(value >> 8);
+    s[4] = (uint8_t)index;
+    s[5] = (uint8_t)(index >> 8);
+    s[6] = (uint8_t)length;
+    s[7] = (uint8_t)(length >> 8);
+}
+
+static void startControl(USB_HOST *host, const char *name, const uint8_t setup[8], const uint8_t *out)
+{
+    memset(&host->ctrl, 0, sizeof(host->ctrl));
+    memcpy(host->ctrl.setup, setup, 8);
+    host->ctrl.len = (unsigned)(setup[6] | setup[7] << 8);
+    if (host->ctrl.len > HOST_MAX_DATA) host->ctrl.len = HOST_MAX_DATA;
+    if (out != NULL && !(setup[0] & 0x80)) memcpy(host->ctrl.data, out, host->ctrl.len);
+    snprintf(host->ctrl.name, sizeof(host->ctrl.name), "%s", name);
+    host->ctrl.nextTry = host->now;
+    host->ctrl.startUs = host->now;
+    host->ctrl.startCycles = host->cpu->cycles;
+    host->ctrl.startIter = iterations(host);
+    host->act = ACT_CONTROL;
+}
+
+static void request(USB_HOST *host, const char *name, uint8_t type, uint8_t req,
+                    uint16_t value, uint16_t index, uint16_t length)
+{
+    uint8_t setup[8];
+
+    setupPacket(setup, type, req, value, index, length);
+    startControl(host, name, setup, NULL);
+}
+
+static void enumStep(USB_HOST *host, int result);
+
+static void finishControl(USB_HOST *host, int result)
+{
+    HOST_XFER *x;
+
+    if (host->nxfers == host->xferCap) {
+        host->xferCap = host->xferCap ? host->xferCap * 2 : 32;
+        host->xfers = realloc(host->xfers, host->xferCap * sizeof(*host->xfers));
+    }
+    x = &host->xfers[host->nxfers++];
+    memset(x, 0, sizeof(*x));
+    snprintf(x->name, sizeof(x->name), "%s", host->ctrl.name);
+    memcpy(x->setup, host->ctrl.setup, 8);
+    x->result = result;
+    x->bytes = host->ctrl.pos;
+    x->startUs = host->ctrl.startUs;
+    x->us = host->now - host->ctrl.startUs;
+    x->cycles = host->cpu->cycles - host->ctrl.startCycles;
+    x->iterations = iterations(host) - host->ctrl.startIter;
+    x->naks = host->ctrl.naks;
+    if (host->ctrl.setup[0] & 0x80) {
+        memcpy(x->data, host->ctrl.data, host->ctrl.pos < sizeof(x->data) ? host->ctrl.pos : sizeof(x->data));
+    }
+
+    host->act = ACT_IDLE;
+    if (host->enumStage != ENUM_NONE) enumStep(host, result);
+}
+
+/* one transaction of the control transfer in flight */
+static void runControl(USB_HOST *host)
+{
+    USB_SIE *sie = host->sie;
+    uint8_t *setup = host->ctrl.setup;
+    bool in = (setup[0] & 0x80) != 0;
+    USB_HANDSHAKE hs;
+    unsigned len = 0, pid = 0;
+
+    if (host->now - host->ctrl.startUs > CONTROL_TIMEOUT_US) {
+        finishControl(host, HOST_TIMEOUT);
+        return;
+    }
+
+    switch (host->ctrl.stage) {
+        case 0:
+            hs = Sie_Setup(sie, host->addr, 0, setup);
+            host->busFreeUs = host->now + transactionUs(8);
+            if (hs == USB_HS_ACK) {
+                host->ctrl.toggle = 1;
+                host->ctrl.stage = host->ctrl.len ? 1 : 2;
+            }
+            break;
+
+        case 1:
+            if (in) {
+                uint8_t *buf = host->ctrl.data + host->ctrl.pos;
+                unsigned room = host->ctrl.len - host->ctrl.pos;
+
+                hs = Sie_In(sie, host->addr, 0, buf, room < host->maxp0 ? room : host->maxp0, &len, &pid);
+                host->busFreeUs = host->now + transactionUs(len);
+                if (hs == USB_HS_ACK) {
+                    if (pid != host->ctrl.toggle) {
+                        host->toggleErrors++;   // retransmission: discard
+                        break;
+                    }
+                    host->ctrl.toggle ^= 1;
+                    host->ctrl.pos += len;
+                    if (len < host->maxp0 || host->ctrl.pos >= host->ctrl.len) host->ctrl.stage = 2;
+                }
+            } else {
+                unsigned n = host->ctrl.len - host->ctrl.pos;
+
+                if (n > host->maxp0) n = host->maxp0;
+                hs = Sie_Out(sie, host->addr, 0, host->ctrl.data + host->ctrl.pos, n, host->ctrl.toggle);
+                host->busFreeUs = host->now + transactionUs(n);
+                if (hs == USB_HS_ACK) {
+                    host->ctrl.toggle ^= 1;
+                    host->ctrl.pos += n;
+                    if (host->ctrl.pos >= host->ctrl.len) host->ctrl.stage = 2;
+                }
+            }
+            break;
+
+        default:
+            // status stage: zero length DATA1 in the other direction
+            if (in) {
+                hs = Sie_Out(sie, host->addr, 0, NULL, 0, 1);
+            } else {
+                hs = Sie_In(sie, host->addr, 0, NULL, 0, &len, &pid);
+            }
+            host->busFreeUs = host->now + transactionUs(0);
+            if (hs == USB_HS_ACK) {
+                finishControl(host, HOST_OK);
+                return;
+            }
+            break;
+    }
+
+    if (hs == USB_HS_STALL) {
+        finishControl(host, HOST_STALL);
+    } else if (hs == USB_HS_NAK) {
+        host->ctrl.naks++;
+        host->ctrl.nextTry = host->now + RETRY_US;
+    } else if (hs == USB_HS_NONE) {
+        // bus turnaround timeout before the retry
+        host->ctrl.nextTry = host->now + RETRY_US * 3;
+    } else {
+        host->ctrl.nextTry = host->busFreeUs;
+    }
+}
+
+/*** enumeration **************************************************************/
+
+static void startReset(USB_HOST *host)
+{
+    Sie_BusReset(host->sie, true);
+    host->sofRunning = false;
+    host->poll = false;
+    host->addr = 0;
+    host->act = ACT_RESET;
+    host->actUntil = host->now + RESET_US;
+}
+
+static void startWait(USB_HOST *host, double us)
+{
+    host->act = ACT_WAIT;
+    host->actUntil = host->now + us;
+}
+
+static void markConfigured(USB_HOST *host)
+{
+    host->configured = true;
+    host->configuredUs = host->now;
+    host->configuredCycles = host->cpu->cycles;
+    host->configuredIter = iterations(host);
+}
+
+/* collect interrupt IN endpoints from the configuration descriptor */
+static void parseEndpoints(USB_HOST *host)
+{
+    host->nInEps = 0;
+    for (unsigned i = 0; i + 1 < host->cfgLen && host->cfgDesc[i] != 0; i += host->cfgDesc[i]) {
+        const uint8_t *d = &host->cfgDesc[i];
+
+        if (d[1] == DSC_ENDPOINT && i + 7 <= host->cfgLen && (d[2] & 0x80) && (d[3] & 0x03) == 0x03
+            && host->nInEps < HOST_MAX_IN_EPS) {
+            host->inEps[host->nInEps].ep = d[2] & 0x0F;
+            host->inEps[host->nInEps].maxp = (unsigned)(d[4] | d[5] << 8);
+            host->inEps[host->nInEps].interval = d[6] ? d[6] : 1;
+            host->inEps[host->nInEps].toggle = 0;
+            host->nInEps++;
+        }
+    }
+}
+
+/*
+ * Find the n-th HID interface in the configuration descriptor.
+ * Returns false when there is none; iface/reportLen receive its number
+ * and the report descriptor length from the HID class descriptor.
+ */
+static bool hidInterface(const USB_HOST *host, unsigned n, uint8_t *iface, unsigned *reportLen)
+{
+    int current = -1;
+    unsigned seen = 0;
+
+    for (unsigned i = 0; i + 1 < host->cfgLen && host->cfgDesc[i] != 0; i += host->cfgDesc[i]) {
+        const uint8_t *d = &host->cfgDesc[i];
+
+        if (d[1] == DSC_INTERFACE && i + 9 <= host->cfgLen) {
+            current = (d[5] == HID_CLASS && d[3] == 0) ? d[2] : -1;
+        } else if (d[1] == DSC_HID && current >= 0 && i + 9 <= host->cfgLen) {
+            if (seen++ == n) {
+                *iface = (uint8_t)current;
+                *reportLen = (unsigned)(d[7] | d[8] << 8);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void nextScript(USB_HOST *host);
+
+/*
+ * Advance the enumeration state machine after the previous step
+ * finished with result (HOST_OK for waits and resets).
+ */
+static void enumStep(USB_HOST *host, int result)
+{
+    const uint8_t *dev = host->devDesc;
+
+    switch (host->enumStage) {
+        case ENUM_ATTACH:
+            host->enumStage = ENUM_DEBOUNCE;
+            startWait(host, DEBOUNCE_US);
+            break;
+        case ENUM_DEBOUNCE:
+            host->enumStage = ENUM_RESET1;
+            host->maxp0 = 64;
+            startReset(host);
+            break;
+        case ENUM_RESET1:
+            host->enumStage = ENUM_RECOVERY1;
+            startWait(host, RESET_RECOVERY_US);
+            break;
+        case ENUM_RECOVERY1:
+            host->enumStage = ENUM_DEVICE64;
+            request(host, "GET_DESCRIPTOR(device,64)", 0x80, REQ_GET_DESCRIPTOR, DSC_DEVICE << 8, 0, 64);
+            break;
+        case ENUM_DEVICE64:
+            if (result != HOST_OK || host->ctrl.pos < 8) goto failed;
+            host->maxp0 = host->ctrl.data[7];
+            host->enumStage = ENUM_RESET2;
+            startReset(host);
+            break;
+        case ENUM_RESET2:
+            host->enumStage = ENUM_RECOVERY2;
+            startWait(host, RESET_RECOVERY_US);
+            break;
+        case ENUM_RECOVERY2:
+            host->enumStage = ENUM_SET_ADDRESS;
+            request(host, "SET_ADDRESS", 0x00, REQ_SET_ADDRESS, DEVICE_ADDRESS, 0, 0);
+            break;
+        case ENUM_SET_ADDRESS:
+            if (result != HOST_OK) goto failed;
+            host->addr = DEVICE_ADDRESS;
+            host->enumStage = ENUM_ADDRESS_WAIT;
+            startWait(host, SET_ADDRESS_US);
+            break;
+        case ENUM_ADDRESS_WAIT:
+            host->enumStage = ENUM_DEVICE18;
+            request(host, "GET_DESCRIPTOR(device)", 0x80, REQ_GET_DESCRIPTOR, DSC_DEVICE << 8, 0, 18);
+            break;
+        case ENUM_DEVICE18:
+            if (result != HOST_OK || host->ctrl.pos < 18) goto failed;
+            memcpy(host->devDesc, host->ctrl.data, 18);
+            host->enumStage = ENUM_CONFIG9;
+            request(host, "GET_DESCRIPTOR(config,9)", 0x80, REQ_GET_DESCRIPTOR, DSC_CONFIG << 8, 0, 9);
+            break;
+        case ENUM_CONFIG9:
+            if (result != HOST_OK || host->ctrl.pos < 9) goto failed;
+            host->enumStage = ENUM_CONFIG;
+            request(host, "GET_DESCRIPTOR(config)", 0x80, REQ_GET_DESCRIPTOR, DSC_CONFIG << 8, 0,
+                    (uint16_t)(host->ctrl.data[2] | host->ctrl.data[3] << 8));
+            break;
+        case ENUM_CONFIG:
+            if (result != HOST_OK) goto failed;
+            host->cfgLen = host->ctrl.pos;
+            memcpy(host->cfgDesc, host->ctrl.data, host->cfgLen);
+            parseEndpoints(host);
+            host->enumStage = ENUM_LANGIDS;
+            request(host, "GET_DESCRIPTOR(string,0)", 0x80, REQ_GET_DESCRIPTOR, DSC_STRING << 8, 0, 255);
+            break;
+        case ENUM_LANGIDS:
+            host->enumStage = ENUM_STRINGS;
+            host->enumIndex = 0;
+            /* fall through */
+        case ENUM_STRINGS:
+            // iProduct, iManufacturer, iSerialNumber in the order Linux reads them
+            while (host->enumIndex < 3) {
+                static const unsigned field[3] = { 15, 14, 16 };
+                static const char *const names[3] = {
+                    "GET_DESCRIPTOR(product)", "GET_DESCRIPTOR(manufacturer)", "GET_DESCRIPTOR(serial)"
+                };
+                unsigned i = host->enumIndex++;
+
+                if (dev[field[i]] != 0) {
+                    request(host, names[i], 0x80, REQ_GET_DESCRIPTOR, DSC_STRING << 8 | dev[field[i]], 0x0409, 255);
+                    return;
+                }
+            }
+            host->enumStage = ENUM_SET_CONFIG;
+            request(host, "SET_CONFIGURATION", 0x00, REQ_SET_CONFIGURATION,
+                    host->cfgLen >= 6 ? host->cfgDesc[5] : 1, 0, 0);
+            break;
+        case ENUM_SET_CONFIG:
+            if (result != HOST_OK) goto failed;
+            markConfigured(host);
+            host->enumStage = ENUM_HID;
+            host->enumIndex = 0;
+            /* fall through */
+        case ENUM_HID:
+        {
+            // SET_IDLE then the report descriptor, per interface; a STALL
+            // on SET_IDLE is allowed (the request is optional for joysticks)
+            uint8_t iface;
+            unsigned reportLen;
+
+            if (hidInterface(host, host->enumIndex / 2, &iface, &reportLen)) {
+                if (host->enumIndex++ % 2 == 0) {
+                    request(host, "SET_IDLE", 0x21, HID_SET_IDLE, 0, iface, 0);
+                } else {
+                    request(host, "GET_DESCRIPTOR(report)", 0x81, REQ_GET_DESCRIPTOR, DSC_REPORT << 8, iface,
+                            (uint16_t)reportLen);
+                }
+                break;
+            }
+            host->enumStage = ENUM_NONE;
+            host->enumerated = true;
+            host->enumeratedUs = host->now;
+            host->enumeratedCycles = host->cpu->cycles;
+            host->enumeratedIter = iterations(host);
+            nextScript(host);
+            break;
+        }
+        default:
+            break;
+    }
+    return;
+
+failed:
+    fprintf(stderr, "usbhost: enumeration failed at %s (%s)\n", host->ctrl.name,
+            result == HOST_STALL ? "stall" : result == HOST_TIMEOUT ? "timeout" : "short data");
+    host->enumStage = ENUM_NONE;
+    host->scriptDone = true;
+}
+
+/*** script *******************************************************************/
+
+static void nextScript(USB_HOST *host)
+{
+    while (host->act == ACT_IDLE && host->enumStage == ENUM_NONE && !host->scriptDone) {
+        const HOST_CMD *cmd;
+
+        if (host->next >= host->ncmds) {
+            host->scriptDone = true;
+            return;
+        }
+        cmd = &host->cmds[host->next++];
+        switch (cmd->type) {
+            case CMD_ENUMERATE:
+                host->enumStage = ENUM_ATTACH;
+                host->act = ACT_WAIT;       // until the pull-up shows up
+                host->actUntil = -1;
+                break;
+            case CMD_WAIT:
+                startWait(host, cmd->us);
+                break;
+            case CMD_POLL:
+                host->poll = cmd->on;
+                break;
+            case CMD_RESET:
+                startReset(host);
+                break;
+            case CMD_CONTROL:
+                startControl(host, cmd->name, cmd->setup, cmd->data);
+                break;
+        }
+    }
+}
+
+static void pollInterrupt(USB_HOST *host)
+{
+    for (unsigned i = 0; i < host->nInEps; i++) {
+        uint8_t buf[64];
+        unsigned len = 0, pid = 0;
+        USB_HANDSHAKE hs;
+
+        if (host->frame % host->inEps[i].interval != 0) continue;
+        hs = Sie_In(host->sie, host->addr, host->inEps[i].ep, buf,
+                    host->inEps[i].maxp < sizeof(buf) ? host->inEps[i].maxp : sizeof(buf), &len, &pid);
+        host->busFreeUs = host->now + transactionUs(len);
+        if (hs == USB_HS_NAK) {
+            host->reportNaks++;
+        } else if (hs == USB_HS_ACK) {
+            if (pid != host->inEps[i].toggle) {
+                host->toggleErrors++;
+                continue;
+            }
+            host->inEps[i].toggle ^= 1;
+            host->reports++;
+            memcpy(host->lastReport, buf, len);
+            host->lastReportLen = len;
+            if (host->reportLog != NULL) {
+                fprintf(host->reportLog, "%.1f,%u,%u,", host->now, host->inEps[i].ep, host->frame);
+                for (unsigned j = 0; j < len; j++) fprintf(host->reportLog, "%s%02X", j ? " " : "", buf[j]);
+                fputc('\n', host->reportLog);
+            }
+        }
+    }
+}
+
+static void hostTick(void *ctx, double us)
+{
+    USB_HOST *host = ctx;
+    bool connected;
+
+    host->now += us;
+    connected = Sie_Connected(host->sie);
+
+    if (connected && !host->attachSeen) {
+        host->attachSeen = true;
+        host->attachUs = host->now;
+        host->attachCycles = host->cpu->cycles;
+        host->attachIter = iterations(host);
+    }
+    if (connected != host->connected) {
+        host->connected = connected;
+        if (!connected) {
+            host->sofRunning = false;
+            host->poll = false;
+        }
+    }
+
+    switch (host->act) {
+        case ACT_WAIT:
+            if (host->enumStage == ENUM_ATTACH) {
+                if (!connected) return;
+            } else if (host->now < host->actUntil) {
+                break;
+            }
+            host->act = ACT_IDLE;
+            if (host->enumStage != ENUM_NONE) enumStep(host, HOST_OK);
+            break;
+        case ACT_RESET:
+            if (host->now < host->actUntil) break;
+            Sie_BusReset(host->sie, false);
+            host->sofRunning = true;
+            host->nextSofUs = host->now;
+            host->act = ACT_IDLE;
+            if (host->enumStage != ENUM_NONE) enumStep(host, HOST_OK);
+            break;
+        default:
+            break;
+    }
+
+    if (host->sofRunning && connected && host->now >= host->nextSofUs) {
+        host->nextSofUs += FRAME_US;
+        host->frame = (host->frame + 1) & 0x7FF;
+        Sie_Sof(host->sie);
+        host->busFreeUs = host->now + transactionUs(0);
+        if (host->poll && host->act != ACT_CONTROL) pollInterrupt(host);
+    }
+
+    if (host->act == ACT_CONTROL && host->now >= host->ctrl.nextTry && host->now >= host->busFreeUs) {
+        runControl(host);
+    }
+    if (host->act == ACT_IDLE && host->enumStage == ENUM_NONE) nextScript(host);
+}
+
+static void pushCmd(USB_HOST *host, const HOST_CMD *cmd)
+{
+    host->cmds = realloc(host->cmds, (host->ncmds + 1) * sizeof(*host->cmds));
+    if (host->cmds == NULL) {
+        perror("usbhost");
+        exit(1);
+    }
+    host->cmds[host->ncmds++] = *cmd;
+}
+
+static bool parseNumber(const char *s, unsigned long max, unsigned long *v)
+{
+    char *end;
+
+    if (s == NULL) return false;
+    *v = strtoul(s, &end, 0);
+    return end != s && *end == '\0' && *v <= max;
+}
+
+static bool parseDescType(const char *s, unsigned long *v)
+{
+    static const struct { const char *name; uint8_t type; } types[] = {
+        { "device", DSC_DEVICE }, { "config", DSC_CONFIG }, { "string", DSC_STRING },
+        { "hid", DSC_HID }, { "report", DSC_REPORT },
+    };
+
+    for (unsigned i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (s != NULL && strcasecmp(s, types[i].name) == 0) {
+            *v = types[i].type;
+            return true;
+        }
+    }
+    return parseNumber(s, 0xFF, v);
+}
+
+static bool parseReportType(const char *s, unsigned long *v)
+{
+    if (s == NULL) return false;
+    if (strcasecmp(s, "input") == 0) {
+        *v = 1;
+    } else if (strcasecmp(s, "output") == 0) {
+        *v = 2;
+    } else if (strcasecmp(s, "feature") == 0) {
+        *v = 3;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* remaining tokens are data bytes; returns the count or -1 */
+static int parseBytes(char **tok, int ntok, uint8_t *data)
+{
+    for (int i = 0; i < ntok; i++) {
+        unsigned long b;
+        if (i >= HOST_MAX_DATA || !parseNumber(tok[i], 0xFF, &b)) return -1;
+        data[i] = (uint8_t)b;
+    }
+    return ntok;
+}
+
+static bool parseLine(USB_HOST *host, char **tok, int ntok)
+{
+    HOST_CMD cmd;
+    unsigned long a, b, c, d, e;
+    int n;
+
+    memset(&cmd, 0, sizeof(cmd));
+    snprintf(cmd.name, sizeof(cmd.name), "%s", tok[0]);
+
+    if (strcasecmp(tok[0], "enumerate") == 0 && ntok == 1) {
+        cmd.type = CMD_ENUMERATE;
+    } else if (strcasecmp(tok[0], "wait") == 0 && ntok == 2) {
+        cmd.type = CMD_WAIT;
+        if (!Stim_ParseTime(tok[1], &cmd.us)) return false;
+    } else if (strcasecmp(tok[0], "poll") == 0 && ntok == 2) {
+        cmd.type = CMD_POLL;
+        if (strcasecmp(tok[1], "on") == 0) {
+            cmd.on = true;
+        } else if (strcasecmp(tok[1], "off") != 0) {
+            return false;
+        }
+    } else if (strcasecmp(tok[0], "reset") == 0 && ntok == 1) {
+        cmd.type = CMD_RESET;
+    } else if (strcasecmp(tok[0], "get_descriptor") == 0 && ntok == 5) {
+        if (!parseDescType(tok[1], &a) || !parseNumber(tok[2], 0xFF, &b)
+                || !parseNumber(tok[3], 0xFFFF, &c) || !parseNumber(tok[4], HOST_MAX_DATA, &d)) {
+            return false;
+        }
+        cmd.type = CMD_CONTROL;
+        // class descriptors are addressed to the interface
+        setupPacket(cmd.setup, a >= DSC_HID ? 0x81 : 0x80, REQ_GET_DESCRIPTOR,
+                    (uint16_t)(a << 8 | b), (uint16_t)c, (uint16_t)d);
+    } else if (strcasecmp(tok[0], "set_idle") == 0 && ntok >= 2 && ntok <= 4) {
+        b = 0;
+        c = 0;
+        if (!parseNumber(tok[1], 0xFF, &a) || (ntok > 2 && !parseNumber(tok[2], 0xFF, &b))
+                || (ntok > 3 && !parseNumber(tok[3], 0xFF, &c))) {
+            return false;
+        }
+        cmd.type = CMD_CONTROL;
+        setupPacket(cmd.setup, 0x21, HID_SET_IDLE, (uint16_t)(b << 8 | c), (uint16_t)a, 0);
+    } else if (strcasecmp(tok[0], "get_report") == 0 && ntok == 5) {
+        if (!parseReportType(tok[1], &a) || !parseNumber(tok[2], 0xFF, &b)
+                || !parseNumber(tok[3], 0xFF, &c) || !parseNumber(tok[4], HOST_MAX_DATA, &d)) {
+            return false;
+        }
+        cmd.type = CMD_CONTROL;
+        setupPacket(cmd.setup, 0xA1, HID_GET_REPORT, (uint16_t)(a << 8 | b), (uint16_t)c, (uint16_t)d);
+    } else if (strcasecmp(tok[0], "set_report") == 0 && ntok >= 4) {
+        if (!parseReportType(tok[1], &a) || !parseNumber(tok[2], 0xFF, &b)
+                || !parseNumber(tok[3], 0xFF, &c) || (n = parseBytes(tok + 4, ntok - 4, cmd.data)) < 0) {
+            return false;
+        }
+        cmd.type = CMD_CONTROL;
+        setupPacket(cmd.setup, 0x21, HID_SET_REPORT, (uint16_t)(a << 8 | b), (uint16_t)c, (uint16_t)n);
+    } else if (strcasecmp(tok[0], "control") == 0 && ntok >= 6) {
+        if (!parseNumber(tok[1], 0xFF, &a) || !parseNumber(tok[2], 0xFF, &b)
+                || !parseNumber(tok[3], 0xFFFF, &c) || !parseNumber(tok[4], 0xFFFF, &d)
+                || !parseNumber(tok[5], HOST_MAX_DATA, &e)) {
+            return false;
+        }
+        n = parseBytes(tok + 6, ntok - 6, cmd.data);
+        if (n < 0 || (!(a & 0x80) && (unsigned long)n != e)) return false;
+        cmd.type = CMD_CONTROL;
+        setupPacket(cmd.setup, (uint8_t)a, (uint8_t)b, (uint16_t)c, (uint16_t)d, (uint16_t)e);
+    } else {
+        return false;
+    }
+    pushCmd(host, &cmd);
+    return true;
+}
+
+bool Host_Load(USB_HOST *host, const char *path)
+{
+    FILE *fp;
+    char line[1024];
+    unsigned lineNo = 0;
+
+    memset(host, 0, sizeof(*host));
+    if (path == NULL) {
+        char enumerate[] = "enumerate", poll[] = "poll", on[] = "on";
+        char *t1[] = { enumerate }, *t2[] = { poll, on };
+        return parseLine(host, t1, 1) && parseLine(host, t2, 2);
+    }
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *tok[HOST_MAX_DATA / 4];
+        char *hash = strchr(line, '#');
+        int ntok = 0;
+
+        lineNo++;
+        if (hash) *hash = '\0';
+        for (char *t = strtok(line, " \t\r\n"); t != NULL && ntok < (int)(sizeof(tok) / sizeof(tok[0]));
+                t = strtok(NULL, " \t\r\n")) {
+            tok[ntok++] = t;
+        }
+        if (ntok == 0) continue;
+        if (!parseLine(host, tok, ntok)) {
+            fprintf(stderr, "%s:%u: bad host command\n", path, lineNo);
+            fclose(fp);
+            return false;
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+void Host_Attach(USB_HOST *host, USB_SIE *sie, PROFILE *prof)
+{
+    host->sie = sie;
+    host->cpu = sie->per->cpu;
+    host->prof = prof;
+    host->now = sie->per->timeUs;
+    host->maxp0 = 8;
+    sie->hostCtx = host;
+    sie->hostTick = hostTick;
+}
+
+void Host_DeviceConfigured(USB_HOST *host)
+{
+    if (host->deviceConfigured) return;
+    host->deviceConfigured = true;
+    host->deviceConfiguredUs = host->now;
+    host->deviceConfiguredCycles = host->cpu->cycles;
+    host->deviceConfiguredIter = iterations(host);
+}
+
+/*** results ******************************************************************/
+
+static void writeSpan(FILE *fp, const char *name, bool valid, double us, uint64_t cycles, uint64_t iter,
+                      const USB_HOST *host)
+{
+    fprintf(fp, "    \"%s\": ", name);
+    if (!valid) {
+        fprintf(fp, "null,\n");
+        return;
+    }
+    fprintf(fp, "{ \"time_us\": %.1f, \"since_attach_us\": %.1f, \"cycles\": %llu, \"iterations\": %llu },\n",
+            us, us - host->attachUs, (unsigned long long)(cycles - host->attachCycles),
+            (unsigned long long)(iter - host->attachIter));
+}
+
+void Host_WriteJson(const USB_HOST *host, FILE *fp)
+{
+    static const char *const results[] = { "ok", "stall", "timeout" };
+    SAMPLES cycles = { 0 };
+
+    fprintf(fp, "{\n");
+    if (host->attachSeen) {
+        fprintf(fp, "    \"attach_us\": %.1f,\n", host->attachUs);
+    } else {
+        fprintf(fp, "    \"attach_us\": null,\n");
+    }
+    writeSpan(fp, "configured", host->configured, host->configuredUs, host->configuredCycles,
+              host->configuredIter, host);
+    writeSpan(fp, "device_configured", host->deviceConfigured, host->deviceConfiguredUs,
+              host->deviceConfiguredCycles, host->deviceConfiguredIter, host);
+    writeSpan(fp, "enumerated", host->enumerated, host->enumeratedUs, host->enumeratedCycles,
+              host->enumeratedIter, host);
+    fprintf(fp, "    \"sie\": { \"transactions\": %u, \"naks\": %u, \"stalls\": %u, \"fifo_full_naks\": %u,"
+            " \"toggle_drops\": %u, \"host_toggle_errors\": %u },\n",
+            host->sie->transactions, host->sie->naks, host->sie->stalls, host->sie->fifoFullNaks,
+            host->sie->toggleDrops, host->toggleErrors);
+    fprintf(fp, "    \"reports\": { \"count\": %u, \"naks\": %u, \"last\": \"", host->reports, host->reportNaks);
+    for (unsigned i = 0; i < host->lastReportLen; i++) fprintf(fp, "%s%02X", i ? " " : "", host->lastReport[i]);
+    fprintf(fp, "\" },\n");
+
+    for (unsigned i = 0; i < host->nxfers; i++) {
+        if (host->xfers[i].result == HOST_OK) Sample_Add(&cycles, (uint32_t)host->xfers[i].cycles);
+    }
+    fprintf(fp, "    \"control_cycles\": { ");
+    Sample_WriteJson(fp, &cycles);
+    fprintf(fp, " },\n");
+    free(cycles.v);
+
+    fprintf(fp, "    \"transfers\": [");
+    for (unsigned i = 0; i < host->nxfers; i++) {
+        const HOST_XFER *x = &host->xfers[i];
+        unsigned shown = x->bytes < sizeof(x->data) ? x->bytes : sizeof(x->data);
+
+        fprintf(fp, "%s\n      { \"name\": \"%s\", \"setup\": \"", i ? "," : "", x->name);
+        for (unsigned j = 0; j < 8; j++) fprintf(fp, "%s%02X", j ? " " : "", x->setup[j]);
+        fprintf(fp, "\", \"result\": \"%s\", \"bytes\": %u, \"start_us\": %.1f, \"us\": %.1f,"
+                " \"cycles\": %llu, \"iterations\": %llu, \"naks\": %u",
+                results[x->result], x->bytes, x->startUs, x->us, (unsigned long long)x->cycles,
+                (unsigned long long)x->iterations, x->naks);
+        if (x->setup[0] & 0x80) {
+            fprintf(fp, ", \"data\": \"");
+            for (unsigned j = 0; j < shown; j++) fprintf(fp, "%s%02X", j ? " " : "", x->data[j]);
+            fprintf(fp, "\"");
+        }
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n    ]\n  }");
+}
+
+void Host_Free(USB_HOST *host)
+{
+    free(host->cmds);
+    free(host->xfers);
+    host->cmds = NULL;
+    host->xfers = NULL;
+}
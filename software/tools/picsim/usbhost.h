@@ -0,0 +1,204 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   usbhost.h
+ * Scripted full-speed USB host on top of the SIE model.
+ *
+ * "enumerate" follows what a Linux root port does with a new device:
+ * 100 ms debounce, reset, GET_DESCRIPTOR(device, 64), second reset,
+ * SET_ADDRESS, device/configuration/string descriptors,
+ * SET_CONFIGURATION, then SET_IDLE and the report descriptor for every
+ * HID interface. SOF is sent every 1 ms once the bus has been reset.
+ *
+ * Script commands, one per line ('#' starts a comment):
+ *
+ *   enumerate
+ *   wait <time>
+ *   poll on|off                    interrupt IN polling at bInterval
+ *   reset
+ *   get_descriptor <type> <index> <wIndex> <len>
+ *                                  type: device config string hid report or a number
+ *   set_idle <iface> [duration] [report id]
+ *   get_report <input|output|feature> <id> <iface> <len>
+ *   set_report <input|output|feature> <id> <iface> <byte> ...
+ *   control <bmRequestType> <bRequest> <wValue> <wIndex> <wLength> [<byte> ...]
+ *
+ * Without a script the host runs "enumerate" and "poll on".
+ */
+
+#ifndef USBHOST_H
+#define USBHOST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "usbsie.h"
+#include "profile.h"
+
+#define HOST_MAX_DATA       1024
+#define HOST_MAX_IN_EPS     4
+
+typedef enum
+{
+    CMD_ENUMERATE,
+    CMD_WAIT,
+    CMD_POLL,
+    CMD_RESET,
+    CMD_CONTROL
+} HOST_CMD_TYPE;
+
+typedef struct
+{
+    HOST_CMD_TYPE type;
+    double   us;                    // CMD_WAIT
+    bool     on;                    // CMD_POLL
+    uint8_t  setup[8];              // CMD_CONTROL
+    uint8_t  data[HOST_MAX_DATA];   // OUT data stage
+    char     name[32];
+} HOST_CMD;
+
+typedef struct
+{
+    char     name[32];
+    uint8_t  setup[8];
+    int      result;                // HOST_OK / HOST_STALL / HOST_TIMEOUT
+    unsigned bytes;
+    double   startUs;
+    double   us;
+    uint64_t cycles;
+    uint64_t iterations;
+    unsigned naks;
+    uint8_t  data[64];              // first bytes of an IN data stage
+} HOST_XFER;
+
+#define HOST_OK         0
+#define HOST_STALL      1
+#define HOST_TIMEOUT    2
+
+typedef struct
+{
+    USB_SIE  *sie;
+    PICSIM_CPU *cpu;
+    PROFILE  *prof;                 // main-loop anchor count for "iterations"
+    double    now;
+
+    /* script */
+    HOST_CMD *cmds;
+    unsigned  ncmds;
+    unsigned  next;
+    bool      scriptDone;
+
+    /* bus */
+    bool      connected;
+    bool      sofRunning;
+    double    nextSofUs;
+    double    busFreeUs;            // bus occupied by the last transaction until then
+    uint16_t  frame;
+
+    /* current activity */
+    enum { ACT_IDLE, ACT_WAIT, ACT_RESET, ACT_CONTROL } act;
+    double    actUntil;
+    int       enumStage;            // 0 = not enumerating
+    unsigned  enumIndex;
+
+    /* control transfer in flight */
+    struct
+    {
+        uint8_t  setup[8];
+        uint8_t  data[HOST_MAX_DATA];
+        unsigned len;               // wLength
+        unsigned pos;
+        int      stage;             // 0 setup, 1 data, 2 status
+        unsigned toggle;
+        double   nextTry;
+        double   startUs;
+        uint64_t startCycles;
+        uint64_t startIter;
+        unsigned naks;
+        char     name[32];
+    } ctrl;
+
+    /* what enumeration learned */
+    uint8_t   addr;
+    unsigned  maxp0;
+    uint8_t   devDesc[18];
+    uint8_t   cfgDesc[HOST_MAX_DATA];
+    unsigned  cfgLen;
+    struct
+    {
+        uint8_t  ep;
+        uint8_t  interval;
+        unsigned maxp;
+        unsigned toggle;
+    } inEps[HOST_MAX_IN_EPS];
+    unsigned  nInEps;
+    bool      poll;
+
+    /* milestones */
+    bool      attachSeen;
+    double    attachUs;
+    uint64_t  attachCycles;
+    uint64_t  attachIter;
+    bool      configured;
+    double    configuredUs;
+    uint64_t  configuredCycles;
+    uint64_t  configuredIter;
+    bool      deviceConfigured;     // firmware's own USBDeviceState
+    double    deviceConfiguredUs;
+    uint64_t  deviceConfiguredCycles;
+    uint64_t  deviceConfiguredIter;
+    bool      enumerated;
+    double    enumeratedUs;
+    uint64_t  enumeratedCycles;
+    uint64_t  enumeratedIter;
+
+    /* results */
+    HOST_XFER *xfers;
+    unsigned  nxfers;
+    unsigned  xferCap;
+    unsigned  toggleErrors;
+    unsigned  reports;
+    unsigned  reportNaks;
+    uint8_t   lastReport[64];
+    unsigned  lastReportLen;
+    FILE     *reportLog;
+} USB_HOST;
+
+/**
+ * Load a host script (NULL for the default "enumerate / poll on").
+ */
+bool Host_Load(USB_HOST *host, const char *path);
+
+/**
+ * Connect the host to the SIE; from now on it runs with simulated time.
+ */
+void Host_Attach(USB_HOST *host, USB_SIE *sie, PROFILE *prof);
+
+/**
+ * Record the moment the firmware reports CONFIGURED_STATE.
+ */
+void Host_DeviceConfigured(USB_HOST *host);
+
+/**
+ * Write the "usb" member of the result object.
+ */
+void Host_WriteJson(const USB_HOST *host, FILE *fp);
+
+void Host_Free(USB_HOST *host);
+
+#endif /* USBHOST_H */
@@ -0,0 +1,361 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "usbsie.h"
+
+#define IDLE_DETECT_US  3000.0      // J state this long sets IDLEIF
+
+#define REG(sie, r)     ((sie)->per->cpu->ram[r])
+
+static void updateUsbif(USB_SIE *sie)
+{
+    PICSIM_CPU *cpu = sie->per->cpu;
+
+    if ((REG(sie, R_UIR) & REG(sie, R_UIE)) || (REG(sie, R_UEIR) & REG(sie, R_UEIE))) {
+        cpu->ram[R_PIR2] |= PIR2_USBIF;
+    } else {
+        cpu->ram[R_PIR2] &= (uint8_t)~PIR2_USBIF;
+    }
+}
+
+static void setFlag(USB_SIE *sie, uint8_t flag)
+{
+    REG(sie, R_UIR) |= flag;
+    updateUsbif(sie);
+}
+
+static bool enabled(const USB_SIE *sie)
+{
+    return (REG(sie, R_UCON) & UCON_USBEN) != 0;
+}
+
+bool Sie_Connected(const USB_SIE *sie)
+{
+    return enabled(sie) && (REG(sie, R_UCFG) & UCFG_UPUEN);
+}
+
+/* any bus traffic: restarts idle detection and wakes a suspended SIE */
+static void activity(USB_SIE *sie)
+{
+    sie->idleUs = 0;
+    sie->idleReported = false;
+    if (REG(sie, R_UCON) & UCON_SUSPND) setFlag(sie, UIR_ACTV);
+}
+
+/*** buffer descriptors *******************************************************/
+
+static unsigned bdIndex(const USB_SIE *sie, unsigned ep, unsigned dir)
+{
+    unsigned pp = sie->ppbi[ep][dir];
+
+    switch (REG(sie, R_UCFG) & UCFG_PPB) {
+        case 0:     return ep * 2 + dir;
+        case 1:     // EP0 OUT only
+            if (ep == 0) return dir ? 2 : pp;
+            return ep * 2 + dir + 1;
+        case 2:     return ep * 4 + dir * 2 + pp;
+        default:    // all but EP0
+            if (ep == 0) return dir;
+            return 2 + (ep - 1) * 4 + dir * 2 + pp;
+    }
+}
+
+static bool pingPong(const USB_SIE *sie, unsigned ep, unsigned dir)
+{
+    switch (REG(sie, R_UCFG) & UCFG_PPB) {
+        case 0:     return false;
+        case 1:     return ep == 0 && dir == 0;
+        case 2:     return true;
+        default:    return ep != 0;
+    }
+}
+
+static uint16_t bdAddr(const USB_SIE *sie, unsigned ep, unsigned dir)
+{
+    return (uint16_t)(SIE_BDT_BASE + 4 * bdIndex(sie, ep, dir));
+}
+
+static uint8_t bdRead(USB_SIE *sie, uint16_t bd, unsigned off)
+{
+    return Cpu_ReadLinear(sie->per->cpu, (uint16_t)(bd + off));
+}
+
+static void bdWrite(USB_SIE *sie, uint16_t bd, unsigned off, uint8_t v)
+{
+    Cpu_WriteLinear(sie->per->cpu, (uint16_t)(bd + off), v);
+}
+
+static uint16_t bdBuffer(USB_SIE *sie, uint16_t bd)
+{
+    return (uint16_t)(bdRead(sie, bd, 2) | bdRead(sie, bd, 3) << 8);
+}
+
+static unsigned bdCount(USB_SIE *sie, uint16_t bd)
+{
+    return (unsigned)(bdRead(sie, bd, 1) | (bdRead(sie, bd, 0) & 0x03) << 8);
+}
+
+/* SIE write-back: PID and byte count, UOWN handed to the CPU, USTAT queued */
+static void complete(USB_SIE *sie, unsigned ep, unsigned dir, uint16_t bd, unsigned pid, int len)
+{
+    uint8_t stat = bdRead(sie, bd, 0);
+    uint8_t ustat = (uint8_t)(ep << 3 | dir << 2 | sie->ppbi[ep][dir] << 1);
+
+    if (len >= 0) {
+        stat = (uint8_t)((stat & BD_DTS) | pid << 2 | ((unsigned)len >> 8 & 0x03));
+        bdWrite(sie, bd, 1, (uint8_t)len);
+    } else {
+        stat = (uint8_t)((stat & (BD_DTS | 0x03)) | pid << 2);
+    }
+    bdWrite(sie, bd, 0, stat);
+
+    if (pingPong(sie, ep, dir)) sie->ppbi[ep][dir] ^= 1;
+    sie->fifo[sie->fifoCount++] = ustat;
+    if (sie->fifoCount == 1) {
+        REG(sie, R_USTAT) = ustat;
+        setFlag(sie, UIR_TRN);
+    }
+    sie->transactions++;
+}
+
+/* common checks for a token addressed to this device */
+static bool addressed(USB_SIE *sie, uint8_t addr, uint8_t ep, uint8_t needEn)
+{
+    uint8_t uep;
+
+    if (!Sie_Connected(sie) || sie->se0 || (REG(sie, R_UCON) & UCON_SUSPND)) return false;
+    if (addr != (REG(sie, R_UADDR) & 0x7F) || ep >= SIE_MAX_EP) return false;
+    uep = REG(sie, R_UEP0 + ep);
+    return (uep & needEn) && (uep & UEP_EPHSHK);
+}
+
+static USB_HANDSHAKE stall(USB_SIE *sie, uint8_t ep)
+{
+    REG(sie, R_UEP0 + ep) |= UEP_EPSTALL;
+    setFlag(sie, UIR_STALL);
+    sie->stalls++;
+    return USB_HS_STALL;
+}
+
+USB_HANDSHAKE Sie_Setup(USB_SIE *sie, uint8_t addr, uint8_t ep, const uint8_t pkt[8])
+{
+    uint16_t bd, buf;
+    unsigned cnt;
+
+    activity(sie);
+    if (!addressed(sie, addr, ep, UEP_EPOUTEN) || (REG(sie, R_UEP0 + ep) & UEP_EPCONDIS)) {
+        return USB_HS_NONE;
+    }
+    if (sie->fifoCount == SIE_USTAT_FIFO) {
+        sie->fifoFullNaks++;
+        return USB_HS_NONE;
+    }
+    bd = bdAddr(sie, ep, 0);
+    // SETUP must be ACKed whenever a buffer is armed, BSTALL or not
+    if (!(bdRead(sie, bd, 0) & BD_UOWN)) return USB_HS_NONE;
+
+    buf = bdBuffer(sie, bd);
+    cnt = bdCount(sie, bd);
+    for (unsigned i = 0; i < 8 && i < cnt; i++) {
+        Cpu_WriteLinear(sie->per->cpu, (uint16_t)(buf + i), pkt[i]);
+    }
+    REG(sie, R_UEP0 + ep) &= (uint8_t)~UEP_EPSTALL;
+    REG(sie, R_UCON) |= UCON_PKTDIS;
+    complete(sie, ep, 0, bd, PID_SETUP, 8);
+    return USB_HS_ACK;
+}
+
+USB_HANDSHAKE Sie_Out(USB_SIE *sie, uint8_t addr, uint8_t ep,
+                      const uint8_t *data, unsigned len, unsigned dataPid)
+{
+    uint16_t bd, buf;
+    uint8_t stat;
+    unsigned cnt;
+
+    activity(sie);
+    if (!addressed(sie, addr, ep, UEP_EPOUTEN)) return USB_HS_NONE;
+    if (REG(sie, R_UCON) & UCON_PKTDIS) {
+        sie->naks++;
+        return USB_HS_NAK;
+    }
+    if (sie->fifoCount == SIE_USTAT_FIFO) {
+        sie->fifoFullNaks++;
+        return USB_HS_NAK;
+    }
+    bd = bdAddr(sie, ep, 0);
+    stat = bdRead(sie, bd, 0);
+    if (!(stat & BD_UOWN)) {
+        sie->naks++;
+        return USB_HS_NAK;
+    }
+    if (stat & BD_BSTALL) return stall(sie, ep);
+    if ((stat & BD_DTSEN) && ((stat & BD_DTS) ? 1u : 0u) != dataPid) {
+        // wrong toggle: ACKed on the bus, buffer left with the SIE
+        sie->toggleDrops++;
+        return USB_HS_ACK;
+    }
+
+    buf = bdBuffer(sie, bd);
+    cnt = bdCount(sie, bd);
+    if (len > cnt) len = cnt;           // babble is not modelled
+    for (unsigned i = 0; i < len; i++) {
+        Cpu_WriteLinear(sie->per->cpu, (uint16_t)(buf + i), data[i]);
+    }
+    complete(sie, ep, 0, bd, PID_OUT, (int)len);
+    return USB_HS_ACK;
+}
+
+USB_HANDSHAKE Sie_In(USB_SIE *sie, uint8_t addr, uint8_t ep,
+                     uint8_t *out, unsigned max, unsigned *len, unsigned *dataPid)
+{
+    uint16_t bd, buf;
+    uint8_t stat;
+    unsigned cnt;
+
+    activity(sie);
+    if (!addressed(sie, addr, ep, UEP_EPINEN)) return USB_HS_NONE;
+    if ((REG(sie, R_UCON) & UCON_PKTDIS) || sie->fifoCount == SIE_USTAT_FIFO) {
+        if (sie->fifoCount == SIE_USTAT_FIFO) sie->fifoFullNaks++;
+        sie->naks++;
+        return USB_HS_NAK;
+    }
+    bd = bdAddr(sie, ep, 1);
+    stat = bdRead(sie, bd, 0);
+    if (!(stat & BD_UOWN)) {
+        sie->naks++;
+        return USB_HS_NAK;
+    }
+    if (stat & BD_BSTALL) return stall(sie, ep);
+
+    buf = bdBuffer(sie, bd);
+    cnt = bdCount(sie, bd);
+    for (unsigned i = 0; i < cnt && i < max; i++) {
+        out[i] = Cpu_ReadLinear(sie->per->cpu, (uint16_t)(buf + i));
+    }
+    *len = cnt < max ? cnt : max;
+    *dataPid = (stat & BD_DTS) ? 1 : 0;
+    complete(sie, ep, 1, bd, PID_IN, -1);
+    return USB_HS_ACK;
+}
+
+void Sie_BusReset(USB_SIE *sie, bool active)
+{
+    sie->se0 = active;
+    if (!active || !enabled(sie)) return;
+
+    activity(sie);
+    if (REG(sie, R_UCON) & UCON_SUSPND) {
+        // URSTIF follows once firmware leaves suspend
+        sie->resetWhileSuspended = true;
+    } else {
+        setFlag(sie, UIR_URST);
+    }
+}
+
+void Sie_Sof(USB_SIE *sie)
+{
+    if (!Sie_Connected(sie) || sie->se0) return;
+    sie->frame = (sie->frame + 1) & 0x7FF;
+    REG(sie, R_UFRML) = (uint8_t)sie->frame;
+    REG(sie, R_UFRMH) = (uint8_t)(sie->frame >> 8);
+    activity(sie);
+    if (!(REG(sie, R_UCON) & UCON_SUSPND)) setFlag(sie, UIR_SOF);
+}
+
+/*** SFR interface ************************************************************/
+
+static uint8_t sieRead(void *ctx, uint16_t addr)
+{
+    USB_SIE *sie = ctx;
+
+    switch (addr) {
+        case R_UCON:
+            return (uint8_t)((REG(sie, R_UCON) & ~UCON_SE0) | (sie->se0 ? UCON_SE0 : 0));
+        default:
+            return REG(sie, addr);
+    }
+}
+
+static void sieWrite(void *ctx, uint16_t addr, uint8_t v)
+{
+    USB_SIE *sie = ctx;
+    uint8_t old = REG(sie, addr);
+
+    switch (addr) {
+        case R_UCON:
+            REG(sie, addr) = v & (uint8_t)~UCON_SE0;
+            if ((old & UCON_USBEN) && !(v & UCON_USBEN)) {
+                // module off: SIE state is lost
+                memset(sie->ppbi, 0, sizeof(sie->ppbi));
+                sie->fifoCount = 0;
+                REG(sie, R_UIR) = 0;
+            }
+            if (v & UCON_PPBRST) memset(sie->ppbi, 0, sizeof(sie->ppbi));
+            if ((old & UCON_SUSPND) && !(v & UCON_SUSPND) && sie->resetWhileSuspended) {
+                sie->resetWhileSuspended = false;
+                setFlag(sie, UIR_URST);
+            }
+            break;
+        case R_UIR:
+            // flags are cleared by writing 0, never set by software
+            REG(sie, addr) = old & v;
+            if ((old & UIR_TRN) && !(v & UIR_TRN) && sie->fifoCount) {
+                memmove(sie->fifo, sie->fifo + 1, --sie->fifoCount);
+                if (sie->fifoCount) {
+                    REG(sie, R_USTAT) = sie->fifo[0];
+                    REG(sie, addr) |= UIR_TRN;
+                }
+            }
+            break;
+        case R_UEIR:
+            REG(sie, addr) = old & v;
+            break;
+        case R_USTAT:
+        case R_UFRMH:
+        case R_UFRML:
+            break;
+        default:
+            REG(sie, addr) = v;
+            break;
+    }
+    updateUsbif(sie);
+}
+
+static void sieTick(void *ctx, double us)
+{
+    USB_SIE *sie = ctx;
+
+    if (Sie_Connected(sie) && !sie->se0) {
+        sie->idleUs += us;
+        if (sie->idleUs >= IDLE_DETECT_US && !sie->idleReported) {
+            sie->idleReported = true;
+            setFlag(sie, UIR_IDLE);
+        }
+    }
+    if (sie->hostTick) sie->hostTick(sie->hostCtx, us);
+}
+
+void Sie_Init(USB_SIE *sie, PICSIM_PERIPH *per)
+{
+    memset(sie, 0, sizeof(*sie));
+    sie->per = per;
+    per->usbCtx = sie;
+    per->usbRead = sieRead;
+    per->usbWrite = sieWrite;
+    per->usbTick = sieTick;
+}
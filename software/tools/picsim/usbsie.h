@@ -0,0 +1,153 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   usbsie.h
+ * Device side of the PIC16F1 USB module: UCON/UIR/USTAT/UEPn, the
+ * buffer descriptor table at linear 0x2000, ping-pong buffers, the
+ * 4-deep USTAT FIFO behind TRNIF, SOF/UFRM, IDLE/ACTV and bus reset.
+ *
+ * The host (usbhost.c) drives the bus through the Sie_* calls below;
+ * the firmware sees the result only through the SFRs and the BDT, as
+ * it would on silicon. Transactions complete instantly on the bus side;
+ * bus occupancy is accounted for by the host.
+ */
+
+#ifndef USBSIE_H
+#define USBSIE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "periph.h"
+
+#define SIE_MAX_EP          8
+#define SIE_USTAT_FIFO      4
+#define SIE_BDT_BASE        0x2000u
+
+/* UCON */
+#define UCON_SUSPND     0x02
+#define UCON_RESUME     0x04
+#define UCON_USBEN      0x08
+#define UCON_PKTDIS     0x10
+#define UCON_SE0        0x20
+#define UCON_PPBRST     0x40
+
+/* UIR / UIE */
+#define UIR_URST        0x01
+#define UIR_UERR        0x02
+#define UIR_ACTV        0x04
+#define UIR_TRN         0x08
+#define UIR_IDLE        0x10
+#define UIR_STALL       0x20
+#define UIR_SOF         0x40
+
+/* UCFG */
+#define UCFG_PPB        0x03
+#define UCFG_FSEN       0x04
+#define UCFG_UPUEN      0x10
+
+/* UEPn */
+#define UEP_EPSTALL     0x01
+#define UEP_EPINEN      0x02
+#define UEP_EPOUTEN     0x04
+#define UEP_EPCONDIS    0x08
+#define UEP_EPHSHK      0x10
+
+/* BDnSTAT */
+#define BD_UOWN         0x80
+#define BD_DTS          0x40
+#define BD_DTSEN        0x08
+#define BD_BSTALL       0x04
+
+#define PID_OUT         0x1
+#define PID_IN          0x9
+#define PID_SETUP       0xD
+
+typedef enum
+{
+    USB_HS_ACK,
+    USB_HS_NAK,
+    USB_HS_STALL,
+    USB_HS_NONE             // no response: not addressed, disabled, no buffer
+} USB_HANDSHAKE;
+
+typedef struct
+{
+    PICSIM_PERIPH *per;
+
+    uint8_t  ppbi[SIE_MAX_EP][2];   // next buffer (even/odd) per EP and direction
+    uint8_t  fifo[SIE_USTAT_FIFO];  // pending USTAT values, [0] is visible
+    unsigned fifoCount;
+
+    bool     se0;                   // host is driving a bus reset
+    bool     resetWhileSuspended;
+    double   idleUs;                // time since the last bus activity
+    bool     idleReported;
+    uint16_t frame;
+
+    /* counters for the report */
+    unsigned transactions;
+    unsigned naks;
+    unsigned stalls;
+    unsigned fifoFullNaks;
+    unsigned toggleDrops;           // OUT packets dropped by DTS checking
+
+    /* bus master, called with elapsed time */
+    void    *hostCtx;
+    void    (*hostTick)(void *ctx, double us);
+} USB_SIE;
+
+/**
+ * Attach the SIE to the peripheral block (takes over the USB SFRs).
+ */
+void Sie_Init(USB_SIE *sie, PICSIM_PERIPH *per);
+
+/**
+ * True while the module is enabled with the D+ pull-up on, i.e. a host
+ * would see a full-speed device connected.
+ */
+bool Sie_Connected(const USB_SIE *sie);
+
+/**
+ * Start or end a bus reset (SE0) driven by the host.
+ */
+void Sie_BusReset(USB_SIE *sie, bool active);
+
+/**
+ * Start-of-frame token; advances UFRM and sets SOFIF.
+ */
+void Sie_Sof(USB_SIE *sie);
+
+/**
+ * SETUP transaction (always DATA0, 8 bytes).
+ */
+USB_HANDSHAKE Sie_Setup(USB_SIE *sie, uint8_t addr, uint8_t ep, const uint8_t pkt[8]);
+
+/**
+ * OUT transaction with data toggle dataPid (0 or 1).
+ */
+USB_HANDSHAKE Sie_Out(USB_SIE *sie, uint8_t addr, uint8_t ep,
+                      const uint8_t *data, unsigned len, unsigned dataPid);
+
+/**
+ * IN transaction. On ACK, buf/len receive the packet and dataPid the
+ * toggle the device sent.
+ */
+USB_HANDSHAKE Sie_In(USB_SIE *sie, uint8_t addr, uint8_t ep,
+                     uint8_t *buf, unsigned max, unsigned *len, unsigned *dataPid);
+
+#endif /* USBSIE_H */
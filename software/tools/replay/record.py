@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Record a button trace for replay from the pad's input reports.
+
+Reads /dev/hidrawN of a real pad (interface 0, 7-byte reports) and
+writes every change of a physical button as a stimulus line, timed from
+the first report. Buttons are recovered with the default mapping of
+mapping.c, normal mode unless --special; the d-pad is read from whichever
+of the three cross-key modes the report uses. With LEFT and RIGHT (or UP
+and DOWN) both held the report only shows one, so such overlaps are lost.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+# (byte, mask) -> button, default tables of Mapping_Load()
+NORMAL = {
+    (0, 0x01): "A", (0, 0x02): "B", (0, 0x04): "C", (0, 0x08): "X",
+    (0, 0x10): "Y", (0, 0x20): "Z", (0, 0x40): "TL", (0, 0x80): "TR",
+    (1, 0x01): "START",
+}
+SPECIAL = {
+    (0, 0x01): "A", (0, 0x02): "B", (0, 0x04): "C", (1, 0x10): "X",
+    (1, 0x20): "Y", (1, 0x08): "Z", (1, 0x02): "TL", (1, 0x04): "TR",
+    (1, 0x01): "START",
+}
+# hat switch value -> (up, right, down, left)
+HAT = {
+    0: (1, 0, 0, 0), 1: (1, 1, 0, 0), 2: (0, 1, 0, 0), 3: (0, 1, 1, 0),
+    4: (0, 0, 1, 0), 5: (0, 0, 1, 1), 6: (0, 0, 0, 1), 7: (1, 0, 0, 1),
+}
+ORDER = ("A", "B", "C", "X", "Y", "Z", "TL", "TR", "START", "UP", "DOWN", "LEFT", "RIGHT")
+
+
+def decode(report, table):
+    held = {name for (byte, mask), name in table.items() if report[byte] & mask}
+    up, right, down, left = HAT.get(report[2] & 0x0F, (0, 0, 0, 0))
+    x, y, z, rz = report[3], report[4], report[5], report[6]
+    up = up or y == 0x00 or rz == 0x00
+    down = down or y == 0xFF or rz == 0xFF
+    left = left or x == 0x00 or z == 0x00
+    right = right or x == 0xFF or z == 0xFF
+    for name, on in (("UP", up), ("DOWN", down), ("LEFT", left), ("RIGHT", right)):
+        if on:
+            held.add(name)
+    return held
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("hidraw", help="e.g. /dev/hidraw3")
+    ap.add_argument("-o", "--output", help="trace file (default: stdout)")
+    ap.add_argument("--special", action="store_true", help="pad is in special mode")
+    ap.add_argument("--duration", type=float, default=0, help="seconds (default: until Ctrl-C)")
+    args = ap.parse_args()
+
+    table = SPECIAL if args.special else NORMAL
+    out = open(args.output, "w") if args.output else sys.stdout
+    fd = os.open(args.hidraw, os.O_RDONLY)
+    out.write("# recorded from %s%s\n\n" % (args.hidraw, " (special mode)" if args.special else ""))
+    out.write("0ms         PORTA   0xFF\n0ms         PORTB   0xFF\n0ms         PORTC   0xFF\n\n")
+
+    start = None
+    held = set()
+    try:
+        while True:
+            report = os.read(fd, 64)
+            now = time.monotonic()
+            if len(report) < 7:
+                continue
+            if start is None:
+                start = now
+            if args.duration and now - start > args.duration:
+                break
+            cur = decode(report, table)
+            ms = (now - start) * 1000.0
+            for name in ORDER:
+                if (name in cur) != (name in held):
+                    out.write("%-11s %-7s %s\n" % ("%.1fms" % ms, name,
+                                                   "press" if name in cur else "release"))
+            held = cur
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.close(fd)
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,380 @@
+/*******************************************************************************
+Copyright 2026 Geeky Fab. (geekyfab.com)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*******************************************************************************/
+
+/*
+ * File:   replay.c
+ * replay: feeds a button trace through the main loop of
+ * project_SS_gamepad.X (Scheduler_Tasks: App_DeviceGamepadAct, the
+ * mapping and the START+TL / START+TR mode switches) built for the PC,
+ * and reports the report stream the host would see with the latency of
+ * every input change in USB frames.
+ *
+ * Everything runs on the virtual clock of native/: the firmware's pin
+ * accesses move time, Timer1 runs along with it, the host takes the
+ * pending EP1 packet at every 1 ms frame boundary (or every --interval
+ * frames, as a host that polls less often than bInterval), and a run of
+ * a trace gives the same numbers every time.
+ *
+ * Traces are stimulus scripts (common/stimulus.h); record.py turns the
+ * reports of a real pad into one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "system.h"
+#include "usb.h"
+#include "usb_device_hid.h"
+#include "app_device_joystick.h"
+#include "mapping.h"
+#include "telemetry.h"
+#include "scheduler.h"
+#include "cadence.h"
+#include "history.h"
+#include "inject.h"
+
+#include "native.h"
+#include "stimulus.h"
+#include "samples.h"
+
+#define FRAME_US            1000    // full-speed frame; EP1 bInterval is 1
+#define LOOP_NS             5000    // USBDeviceTasks() and the loop around it (picsim idle bench)
+#define SETTLE_US           1000000 // replayed after the last event of a trace
+#define MAX_PENDING         64
+#define REPORT_MAX          64
+
+typedef struct
+{
+    const char *tracePath;
+    const char *hefPath;
+    const char *jsonPath;
+    const char *reportPath;
+    const char *eventPath;
+    double      runUs;          // 0 = until the trace ends
+    unsigned    interval;       // frames between the host's IN tokens
+} OPTIONS;
+
+/* the USB stack the application sees; only EP1 IN does anything */
+USB_VOLATILE USB_DEVICE_STATE USBDeviceState;
+USB_VOLATILE uint8_t USBActiveConfiguration;
+USB_VOLATILE bool RemoteWakeup;
+USB_VOLATILE bool USBBusIsSuspended;
+USB_VOLATILE IN_PIPE inPipes[1];
+USB_VOLATILE OUT_PIPE outPipes[1];
+
+static OPTIONS opt;
+static STIMULUS stim;
+static volatile BDT_ENTRY inBd[2];
+static volatile BDT_ENTRY *inCurrent;
+static uint8_t inPpbi;
+static uint8_t queued[REPORT_MAX];
+static uint8_t queuedLen;
+static uint64_t sampledUs;          // when the queued report was built
+
+static uint64_t nextFrameUs = FRAME_US;
+static uint32_t frame;
+static uint8_t lastReport[REPORT_MAX];
+static uint8_t lastLen;
+static bool haveReport;
+static double pending[MAX_PENDING];
+static unsigned npending;
+static FILE *reportLog, *eventLog;
+
+static unsigned events, reports, changedReports, nakFrames, gap, longestGap, unchanged, dropped;
+static SAMPLES latFrames, latUs;
+static unsigned histogram[64];
+
+void USBEnableEndpoint(uint8_t ep, uint8_t options)
+{
+    (void)ep;
+    (void)options;
+}
+
+/* the rest of the loop has nothing to do here: no control transfers,
+   no bootloader request, and a trace never suspends the bus */
+void USBDeviceTasks(void)
+{
+}
+
+void BootRequest_Tasks(void)
+{
+}
+
+void Power_SuspendTasks(void)
+{
+}
+
+USB_HANDLE USBTransferOnePacket(uint8_t ep, uint8_t dir, uint8_t *data, uint8_t len)
+{
+    volatile BDT_ENTRY *bd = &inBd[inPpbi];
+
+    if (ep != JOYSTICK_EP || dir != IN_TO_HOST) return 0;
+    if (len > REPORT_MAX) len = REPORT_MAX;
+    inPpbi ^= 1;
+    memcpy(queued, data, len);
+    queuedLen = len;
+    sampledUs = Native_NowUs();
+    bd->CNT = len;
+    bd->STAT.UOWN = 1;
+    inCurrent = bd;
+    return (USB_HANDLE)bd;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: replay [options] trace.stim\n"
+        "  --hef FILE        High-Endurance Flash rows to load the mapping from\n"
+        "  --time T          replay time (default: the trace plus 1s)\n"
+        "  --interval N      the host polls EP1 every N frames (default: 1)\n"
+        "  --reports FILE    log every changed report as CSV\n"
+        "  --events FILE     log every input event and its latency as CSV\n"
+        "  --json FILE       write results here (default: stdout)\n");
+    exit(2);
+}
+
+static void parseArgs(int argc, char **argv, OPTIONS *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->interval = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (a[0] != '-') {
+            o->tracePath = a;
+            continue;
+        }
+        if (v == NULL) usage();
+        i++;
+        if (strcmp(a, "--hef") == 0) {
+            o->hefPath = v;
+        } else if (strcmp(a, "--time") == 0) {
+            if (!Stim_ParseTime(v, &o->runUs)) {
+                fprintf(stderr, "replay: --time needs a time such as 10s\n");
+                exit(2);
+            }
+        } else if (strcmp(a, "--interval") == 0) {
+            o->interval = (unsigned)atoi(v);
+            if (o->interval < 1 || o->interval > 255) {
+                fprintf(stderr, "replay: --interval needs 1 to 255 frames\n");
+                exit(2);
+            }
+        } else if (strcmp(a, "--reports") == 0) {
+            o->reportPath = v;
+        } else if (strcmp(a, "--events") == 0) {
+            o->eventPath = v;
+        } else if (strcmp(a, "--json") == 0) {
+            o->jsonPath = v;
+        } else {
+            usage();
+        }
+    }
+    if (o->tracePath == NULL) usage();
+}
+
+static FILE *openLog(const char *path, const char *header)
+{
+    FILE *fp;
+
+    if (path == NULL) return NULL;
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror(path);
+        exit(1);
+    }
+    fprintf(fp, "%s\n", header);
+    return fp;
+}
+
+/*
+ * Inputs up to the moment a report was built are in it: they get its
+ * latency when it differs from the report before, and are counted as
+ * unchanged (an unmapped button, a press released within the frame,
+ * RIGHT while LEFT is held) when it does not.
+ */
+static void settlePending(bool changed, uint64_t deliveredUs)
+{
+    unsigned keep = 0;
+
+    for (unsigned i = 0; i < npending; i++) {
+        double t = pending[i];
+
+        if (t > (double)sampledUs) {
+            pending[keep++] = t;
+        } else if (changed) {
+            uint32_t frames = frame - (uint32_t)(t / FRAME_US);
+
+            Sample_Add(&latFrames, frames);
+            Sample_Add(&latUs, (uint32_t)((double)deliveredUs - t));
+            histogram[frames < 63 ? frames : 63]++;
+            if (eventLog) fprintf(eventLog, "%.1f,%u,%u,%.1f\n", t, frame, frames, (double)deliveredUs - t);
+        } else {
+            unchanged++;
+            if (eventLog) fprintf(eventLog, "%.1f,%u,,\n", t, frame);
+        }
+    }
+    npending = keep;
+}
+
+/* the host's IN token at the start of a frame it polls in */
+static void hostFrame(uint64_t us)
+{
+    bool changed;
+
+    frame = (uint32_t)(us / FRAME_US);
+    if (frame % opt.interval != 0) return;
+    if (inCurrent == NULL || !inCurrent->STAT.UOWN) {
+        nakFrames++;
+        if (++gap > longestGap) longestGap = gap;
+        return;
+    }
+    inCurrent->STAT.UOWN = 0;
+    Cadence_TransferComplete();         // the TRNIF, as usb_events.c takes it
+    gap = 0;
+    reports++;
+    changed = haveReport && (queuedLen != lastLen || memcmp(queued, lastReport, queuedLen) != 0);
+    settlePending(changed, us);
+    if (changed) changedReports++;
+    if (changed || !haveReport) {
+        memcpy(lastReport, queued, queuedLen);
+        lastLen = queuedLen;
+        haveReport = true;
+        if (reportLog) {
+            fprintf(reportLog, "%u,%llu,", frame, (unsigned long long)us);
+            for (unsigned i = 0; i < queuedLen; i++) fprintf(reportLog, "%s%02X", i ? " " : "", queued[i]);
+            fprintf(reportLog, "\n");
+        }
+    }
+}
+
+static void onAdvance(uint64_t nowUs)
+{
+    const STIM_EVENT *ev;
+
+    while ((ev = Stim_Next(&stim, (double)nowUs)) != NULL) {
+        double t = ev->timeUs + stim.baseUs;
+
+        Native_SetPins(ev->port, ev->mask, ev->level);
+        // pins set before the first report are the idle state; lines
+        // with the same time are one event
+        if (!haveReport || (npending && pending[npending - 1] == t)) continue;
+        events++;
+        if (npending < MAX_PENDING) {
+            pending[npending++] = t;
+        } else {
+            dropped++;
+        }
+    }
+    while (nowUs >= nextFrameUs) {
+        INJECT_Sof();                   // nothing is queued, but the SOF path runs
+        hostFrame(nextFrameUs);
+        nextFrameUs += FRAME_US;
+    }
+}
+
+static void writeStats(FILE *fp, const char *name, const SAMPLES *s)
+{
+    fprintf(fp, "  \"%s\": { ", name);
+    Sample_WriteJson(fp, s);
+    fprintf(fp, " },\n");
+}
+
+static void writeJson(FILE *fp)
+{
+    unsigned last = 0;
+
+    for (unsigned i = 0; i < 64; i++) {
+        if (histogram[i]) last = i;
+    }
+    fprintf(fp, "{\n  \"tool\": \"replay\",\n  \"trace\": \"%s\",\n", opt.tracePath);
+    fprintf(fp, "  \"time_us\": %llu,\n", (unsigned long long)Native_NowUs());
+    fprintf(fp, "  \"frames\": %u,\n", frame);
+    fprintf(fp, "  \"interval_frames\": %u,\n", opt.interval);
+    fprintf(fp, "  \"poll_interval\": %u,\n", telemetry.pollInterval);
+    fprintf(fp, "  \"poll_missed\": %u,\n", telemetry.pollMissed);
+    fprintf(fp, "  \"events\": %u,\n", events);
+    fprintf(fp, "  \"reports\": %u,\n", reports);
+    fprintf(fp, "  \"changed_reports\": %u,\n", changedReports);
+    fprintf(fp, "  \"nak_frames\": %u,\n", nakFrames);
+    fprintf(fp, "  \"longest_gap_frames\": %u,\n", longestGap);
+    fprintf(fp, "  \"unchanged_events\": %u,\n", unchanged + npending + dropped);
+    writeStats(fp, "latency_frames", &latFrames);
+    writeStats(fp, "latency_us", &latUs);
+    fprintf(fp, "  \"latency_histogram\": [");
+    for (unsigned i = 0; i <= last; i++) fprintf(fp, "%s%u", i ? ", " : "", histogram[i]);
+    fprintf(fp, "]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    FILE *out = stdout;
+    double endUs;
+
+    parseArgs(argc, argv, &opt);
+    if (!Stim_Load(&stim, opt.tracePath)) return 1;
+    endUs = opt.runUs;
+    if (endUs <= 0) {
+        if (stim.repeatUs > 0) {
+            fprintf(stderr, "replay: %s repeats, give --time\n", opt.tracePath);
+            return 2;
+        }
+        endUs = (stim.count ? stim.ev[stim.count - 1].timeUs : 0) + SETTLE_US;
+    }
+    reportLog = openLog(opt.reportPath, "frame,time_us,report");
+    eventLog = openLog(opt.eventPath, "time_us,frame,latency_frames,latency_us");
+
+    Native_NvmOpen(opt.hefPath);
+    Native_StartVirtual(onAdvance);
+
+    // main() of the firmware up to its loop, then the host configures us
+    Telemetry_Initialize();
+    Mapping_Load();
+    OPTION_REGbits.nWPUEN = 0;
+    History_Initialize();
+    USBActiveConfiguration = 1;
+    USBDeviceState = CONFIGURED_STATE;
+    APP_DeviceJoystickInitialize();
+
+    while ((double)Native_NowUs() < endUs) {
+        Scheduler_Tasks();
+        if (inCurrent != NULL && inCurrent->STAT.UOWN) {
+            // nothing to do until the host has taken the packet
+            Native_Advance((nextFrameUs - Native_NowUs()) * 1000u);
+        } else {
+            Native_Advance(LOOP_NS);
+        }
+    }
+
+    if (opt.jsonPath) {
+        out = fopen(opt.jsonPath, "w");
+        if (out == NULL) {
+            perror(opt.jsonPath);
+            return 1;
+        }
+    }
+    writeJson(out);
+    if (out != stdout) fclose(out);
+    if (reportLog) fclose(reportLog);
+    if (eventLog) fclose(eventLog);
+
+    Sample_Free(&latFrames);
+    Sample_Free(&latUs);
+    Stim_Free(&stim);
+    return 0;
+}